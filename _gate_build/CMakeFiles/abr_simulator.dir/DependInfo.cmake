@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/apps/abr_simulator_main.cc" "CMakeFiles/abr_simulator.dir/src/apps/abr_simulator_main.cc.o" "gcc" "CMakeFiles/abr_simulator.dir/src/apps/abr_simulator_main.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build/CMakeFiles/sample_media.dir/DependInfo.cmake"
+  "/root/repo/_gate_build/CMakeFiles/sample_net.dir/DependInfo.cmake"
+  "/root/repo/_gate_build/CMakeFiles/sample_base.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/abr_simulator.dir/src/apps/abr_simulator_main.cc.o"
+  "CMakeFiles/abr_simulator.dir/src/apps/abr_simulator_main.cc.o.d"
+  "abr_simulator"
+  "abr_simulator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/abr_simulator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
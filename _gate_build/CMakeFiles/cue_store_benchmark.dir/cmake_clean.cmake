@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cue_store_benchmark.dir/src/apps/cue_store_benchmark_main.cc.o"
+  "CMakeFiles/cue_store_benchmark.dir/src/apps/cue_store_benchmark_main.cc.o.d"
+  "cue_store_benchmark"
+  "cue_store_benchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cue_store_benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
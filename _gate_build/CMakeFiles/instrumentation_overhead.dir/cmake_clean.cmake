@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/instrumentation_overhead.dir/src/apps/instrumentation_overhead_main.cc.o"
+  "CMakeFiles/instrumentation_overhead.dir/src/apps/instrumentation_overhead_main.cc.o.d"
+  "instrumentation_overhead"
+  "instrumentation_overhead.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/instrumentation_overhead.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
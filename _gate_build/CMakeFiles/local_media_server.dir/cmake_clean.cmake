@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/local_media_server.dir/src/apps/local_media_server_main.cc.o"
+  "CMakeFiles/local_media_server.dir/src/apps/local_media_server_main.cc.o.d"
+  "local_media_server"
+  "local_media_server.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/local_media_server.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,24 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/base/flags.cc" "CMakeFiles/sample_base.dir/src/base/flags.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/flags.cc.o.d"
+  "/root/repo/src/base/json_writer.cc" "CMakeFiles/sample_base.dir/src/base/json_writer.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/json_writer.cc.o.d"
+  "/root/repo/src/base/latency_histogram.cc" "CMakeFiles/sample_base.dir/src/base/latency_histogram.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/latency_histogram.cc.o.d"
+  "/root/repo/src/base/process_stats.cc" "CMakeFiles/sample_base.dir/src/base/process_stats.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/process_stats.cc.o.d"
+  "/root/repo/src/base/stage_timings.cc" "CMakeFiles/sample_base.dir/src/base/stage_timings.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/stage_timings.cc.o.d"
+  "/root/repo/src/base/summary.cc" "CMakeFiles/sample_base.dir/src/base/summary.cc.o" "gcc" "CMakeFiles/sample_base.dir/src/base/summary.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
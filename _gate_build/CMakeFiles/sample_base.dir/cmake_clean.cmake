@@ -0,0 +1,21 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_base.dir/src/base/flags.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/flags.cc.o.d"
+  "CMakeFiles/sample_base.dir/src/base/json_writer.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/json_writer.cc.o.d"
+  "CMakeFiles/sample_base.dir/src/base/latency_histogram.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/latency_histogram.cc.o.d"
+  "CMakeFiles/sample_base.dir/src/base/process_stats.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/process_stats.cc.o.d"
+  "CMakeFiles/sample_base.dir/src/base/stage_timings.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/stage_timings.cc.o.d"
+  "CMakeFiles/sample_base.dir/src/base/summary.cc.o"
+  "CMakeFiles/sample_base.dir/src/base/summary.cc.o.d"
+  "libsample_base.a"
+  "libsample_base.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_base.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/media/abr_simulation.cc" "CMakeFiles/sample_media.dir/src/media/abr_simulation.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/abr_simulation.cc.o.d"
+  "/root/repo/src/media/bandwidth_estimator.cc" "CMakeFiles/sample_media.dir/src/media/bandwidth_estimator.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/bandwidth_estimator.cc.o.d"
+  "/root/repo/src/media/buffer_policy.cc" "CMakeFiles/sample_media.dir/src/media/buffer_policy.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/buffer_policy.cc.o.d"
+  "/root/repo/src/media/cue_store.cc" "CMakeFiles/sample_media.dir/src/media/cue_store.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/cue_store.cc.o.d"
+  "/root/repo/src/media/dash_parser.cc" "CMakeFiles/sample_media.dir/src/media/dash_parser.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/dash_parser.cc.o.d"
+  "/root/repo/src/media/frame_pool.cc" "CMakeFiles/sample_media.dir/src/media/frame_pool.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/frame_pool.cc.o.d"
+  "/root/repo/src/media/h264_frames.cc" "CMakeFiles/sample_media.dir/src/media/h264_frames.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/h264_frames.cc.o.d"
+  "/root/repo/src/media/hls_parser.cc" "CMakeFiles/sample_media.dir/src/media/hls_parser.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/hls_parser.cc.o.d"
+  "/root/repo/src/media/keyframe_index.cc" "CMakeFiles/sample_media.dir/src/media/keyframe_index.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/keyframe_index.cc.o.d"
+  "/root/repo/src/media/manifest.cc" "CMakeFiles/sample_media.dir/src/media/manifest.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/manifest.cc.o.d"
+  "/root/repo/src/media/mini_xml.cc" "CMakeFiles/sample_media.dir/src/media/mini_xml.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/mini_xml.cc.o.d"
+  "/root/repo/src/media/sample_arena.cc" "CMakeFiles/sample_media.dir/src/media/sample_arena.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/sample_arena.cc.o.d"
+  "/root/repo/src/media/webvtt_parser.cc" "CMakeFiles/sample_media.dir/src/media/webvtt_parser.cc.o" "gcc" "CMakeFiles/sample_media.dir/src/media/webvtt_parser.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build/CMakeFiles/sample_base.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_media.dir/src/media/abr_simulation.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/abr_simulation.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/bandwidth_estimator.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/bandwidth_estimator.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/buffer_policy.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/buffer_policy.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/cue_store.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/cue_store.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/dash_parser.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/dash_parser.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/frame_pool.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/frame_pool.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/h264_frames.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/h264_frames.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/hls_parser.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/hls_parser.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/keyframe_index.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/keyframe_index.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/manifest.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/manifest.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/mini_xml.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/mini_xml.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/sample_arena.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/sample_arena.cc.o.d"
+  "CMakeFiles/sample_media.dir/src/media/webvtt_parser.cc.o"
+  "CMakeFiles/sample_media.dir/src/media/webvtt_parser.cc.o.d"
+  "libsample_media.a"
+  "libsample_media.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_media.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/net/caching_proxy.cc" "CMakeFiles/sample_net.dir/src/net/caching_proxy.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/caching_proxy.cc.o.d"
+  "/root/repo/src/net/http_client.cc" "CMakeFiles/sample_net.dir/src/net/http_client.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/http_client.cc.o.d"
+  "/root/repo/src/net/http_server.cc" "CMakeFiles/sample_net.dir/src/net/http_server.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/http_server.cc.o.d"
+  "/root/repo/src/net/local_media_server.cc" "CMakeFiles/sample_net.dir/src/net/local_media_server.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/local_media_server.cc.o.d"
+  "/root/repo/src/net/network_conditions.cc" "CMakeFiles/sample_net.dir/src/net/network_conditions.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/network_conditions.cc.o.d"
+  "/root/repo/src/net/segment_cache.cc" "CMakeFiles/sample_net.dir/src/net/segment_cache.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/segment_cache.cc.o.d"
+  "/root/repo/src/net/session_trace.cc" "CMakeFiles/sample_net.dir/src/net/session_trace.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/session_trace.cc.o.d"
+  "/root/repo/src/net/static_file_handler.cc" "CMakeFiles/sample_net.dir/src/net/static_file_handler.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/static_file_handler.cc.o.d"
+  "/root/repo/src/net/trace_recorder.cc" "CMakeFiles/sample_net.dir/src/net/trace_recorder.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/trace_recorder.cc.o.d"
+  "/root/repo/src/net/trace_replayer.cc" "CMakeFiles/sample_net.dir/src/net/trace_replayer.cc.o" "gcc" "CMakeFiles/sample_net.dir/src/net/trace_replayer.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build/CMakeFiles/sample_base.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
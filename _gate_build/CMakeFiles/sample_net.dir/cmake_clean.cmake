@@ -0,0 +1,29 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_net.dir/src/net/caching_proxy.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/caching_proxy.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/http_client.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/http_client.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/http_server.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/http_server.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/local_media_server.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/local_media_server.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/network_conditions.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/network_conditions.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/segment_cache.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/segment_cache.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/session_trace.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/session_trace.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/static_file_handler.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/static_file_handler.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/trace_recorder.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/trace_recorder.cc.o.d"
+  "CMakeFiles/sample_net.dir/src/net/trace_replayer.cc.o"
+  "CMakeFiles/sample_net.dir/src/net/trace_replayer.cc.o.d"
+  "libsample_net.a"
+  "libsample_net.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_net.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/abr_simulation_test.cc" "CMakeFiles/sample_tests.dir/tests/abr_simulation_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/abr_simulation_test.cc.o.d"
+  "/root/repo/tests/caching_proxy_test.cc" "CMakeFiles/sample_tests.dir/tests/caching_proxy_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/caching_proxy_test.cc.o.d"
+  "/root/repo/tests/cue_store_test.cc" "CMakeFiles/sample_tests.dir/tests/cue_store_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/cue_store_test.cc.o.d"
+  "/root/repo/tests/frame_pool_test.cc" "CMakeFiles/sample_tests.dir/tests/frame_pool_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/frame_pool_test.cc.o.d"
+  "/root/repo/tests/keyframe_index_test.cc" "CMakeFiles/sample_tests.dir/tests/keyframe_index_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/keyframe_index_test.cc.o.d"
+  "/root/repo/tests/latency_histogram_test.cc" "CMakeFiles/sample_tests.dir/tests/latency_histogram_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/latency_histogram_test.cc.o.d"
+  "/root/repo/tests/manifest_test.cc" "CMakeFiles/sample_tests.dir/tests/manifest_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/manifest_test.cc.o.d"
+  "/root/repo/tests/network_conditions_test.cc" "CMakeFiles/sample_tests.dir/tests/network_conditions_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/network_conditions_test.cc.o.d"
+  "/root/repo/tests/sample_arena_test.cc" "CMakeFiles/sample_tests.dir/tests/sample_arena_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/sample_arena_test.cc.o.d"
+  "/root/repo/tests/segment_cache_test.cc" "CMakeFiles/sample_tests.dir/tests/segment_cache_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/segment_cache_test.cc.o.d"
+  "/root/repo/tests/session_trace_test.cc" "CMakeFiles/sample_tests.dir/tests/session_trace_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/session_trace_test.cc.o.d"
+  "/root/repo/tests/static_file_handler_test.cc" "CMakeFiles/sample_tests.dir/tests/static_file_handler_test.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/static_file_handler_test.cc.o.d"
+  "/root/repo/tests/test_main.cc" "CMakeFiles/sample_tests.dir/tests/test_main.cc.o" "gcc" "CMakeFiles/sample_tests.dir/tests/test_main.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_build/CMakeFiles/sample_media.dir/DependInfo.cmake"
+  "/root/repo/_gate_build/CMakeFiles/sample_net.dir/DependInfo.cmake"
+  "/root/repo/_gate_build/CMakeFiles/sample_base.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,35 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sample_tests.dir/tests/abr_simulation_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/abr_simulation_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/caching_proxy_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/caching_proxy_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/cue_store_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/cue_store_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/frame_pool_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/frame_pool_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/keyframe_index_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/keyframe_index_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/latency_histogram_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/latency_histogram_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/manifest_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/manifest_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/network_conditions_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/network_conditions_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/sample_arena_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/sample_arena_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/segment_cache_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/segment_cache_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/session_trace_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/session_trace_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/static_file_handler_test.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/static_file_handler_test.cc.o.d"
+  "CMakeFiles/sample_tests.dir/tests/test_main.cc.o"
+  "CMakeFiles/sample_tests.dir/tests/test_main.cc.o.d"
+  "sample_tests"
+  "sample_tests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sample_tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,51 @@
+# Locates a Shaka Player Embedded build.
+#
+# Inputs:
+#   SHAKA_EMBEDDED_ROOT - Source checkout; public headers live in shaka/include.
+#   SHAKA_EMBEDDED_OUT  - Build output directory holding the shared library and
+#                         shaka-player.compiled.js.  Defaults to
+#                         ${SHAKA_EMBEDDED_ROOT}/out/Release.
+#
+# Outputs:
+#   ShakaPlayerEmbedded_FOUND
+#   ShakaPlayerEmbedded_DATA_DIR - Directory to use as the JsManager static
+#                                  data directory.
+#   ShakaPlayerEmbedded::ShakaPlayerEmbedded - Imported library target.
+
+if(NOT SHAKA_EMBEDDED_OUT AND SHAKA_EMBEDDED_ROOT)
+  set(SHAKA_EMBEDDED_OUT "${SHAKA_EMBEDDED_ROOT}/out/Release")
+endif()
+
+find_path(ShakaPlayerEmbedded_INCLUDE_DIR shaka/player.h
+  HINTS "${SHAKA_EMBEDDED_ROOT}/shaka/include")
+find_library(ShakaPlayerEmbedded_LIBRARY shaka-player-embedded
+  HINTS "${SHAKA_EMBEDDED_OUT}")
+find_path(ShakaPlayerEmbedded_DATA_DIR shaka-player.compiled.js
+  HINTS "${SHAKA_EMBEDDED_OUT}")
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ShakaPlayerEmbedded
+  REQUIRED_VARS
+    ShakaPlayerEmbedded_LIBRARY
+    ShakaPlayerEmbedded_INCLUDE_DIR
+    ShakaPlayerEmbedded_DATA_DIR)
+
+if(ShakaPlayerEmbedded_FOUND AND
+   NOT TARGET ShakaPlayerEmbedded::ShakaPlayerEmbedded)
+  set(_shaka_include_dirs "${ShakaPlayerEmbedded_INCLUDE_DIR}")
+  # Some headers (e.g. version.h) are generated into the output directory.
+  if(EXISTS "${SHAKA_EMBEDDED_OUT}/gen/shaka/include")
+    list(APPEND _shaka_include_dirs "${SHAKA_EMBEDDED_OUT}/gen/shaka/include")
+  endif()
+
+  add_library(ShakaPlayerEmbedded::ShakaPlayerEmbedded UNKNOWN IMPORTED)
+  set_target_properties(ShakaPlayerEmbedded::ShakaPlayerEmbedded PROPERTIES
+    IMPORTED_LOCATION "${ShakaPlayerEmbedded_LIBRARY}"
+    INTERFACE_INCLUDE_DIRECTORIES "${_shaka_include_dirs}")
+  unset(_shaka_include_dirs)
+endif()
+
+mark_as_advanced(
+  ShakaPlayerEmbedded_INCLUDE_DIR
+  ShakaPlayerEmbedded_LIBRARY
+  ShakaPlayerEmbedded_DATA_DIR)
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Generates local DASH and HLS test content with FFmpeg so the benchmarks can
+# run without network access.
+#
+# Usage: scripts/generate_test_media.sh OUT_DIR [DURATION_SECONDS]
+#
+# The output holds one set of fMP4 segments described by both a DASH manifest
+# (manifest.mpd) and an HLS master playlist (master.m3u8):
+#   - video at 1080p/5 Mbit/s, 720p/2.5 Mbit/s and 360p/800 kbit/s
+#   - stereo AAC audio at 128 kbit/s
+# Every segment is 2 seconds and starts with a keyframe.
+
+set -e
+
+if [[ $# -lt 1 ]]; then
+  echo "Usage: $0 OUT_DIR [DURATION_SECONDS]" >&2
+  exit 1
+fi
+
+OUT_DIR=$1
+DURATION=${2:-60}
+FPS=30
+SEGMENT_SECONDS=2
+GOP=$((FPS * SEGMENT_SECONDS))
+
+if ! command -v ffmpeg >/dev/null; then
+  echo "ffmpeg is required to generate test media" >&2
+  exit 1
+fi
+
+mkdir -p "$OUT_DIR"
+
+ffmpeg -hide_banner -loglevel warning -y \
+  -f lavfi -i "testsrc2=size=1920x1080:rate=$FPS" \
+  -f lavfi -i "sine=frequency=440:sample_rate=48000" \
+  -t "$DURATION" \
+  -map 0:v -map 0:v -map 0:v -map 1:a \
+  -c:v libx264 -preset veryfast -profile:v main -pix_fmt yuv420p \
+  -g "$GOP" -keyint_min "$GOP" -sc_threshold 0 \
+  -s:v:0 1920x1080 -b:v:0 5000k -maxrate:v:0 5500k -bufsize:v:0 10000k \
+  -s:v:1 1280x720 -b:v:1 2500k -maxrate:v:1 2750k -bufsize:v:1 5000k \
+  -s:v:2 640x360 -b:v:2 800k -maxrate:v:2 880k -bufsize:v:2 1600k \
+  -c:a aac -b:a 128k -ac 2 \
+  -f dash -seg_duration "$SEGMENT_SECONDS" \
+  -use_template 1 -use_timeline 0 \
+  -init_seg_name 'init-$RepresentationID$.mp4' \
+  -media_seg_name 'chunk-$RepresentationID$-$Number%05d$.m4s' \
+  -adaptation_sets "id=0,streams=v id=1,streams=a" \
+  -hls_playlist 1 \
+  "$OUT_DIR/manifest.mpd"
+
+echo "Wrote $OUT_DIR/manifest.mpd and $OUT_DIR/master.m3u8"
@@ -0,0 +1,381 @@
+// Drives the player's adaptation logic over bandwidth traces in simulated
+// time, with nothing fetched, decoded or rendered, and reports the bit rate,
+// variant switches and stalls each trace produces.  Sessions run on every
+// core, so whole trace corpora and parameter sweeps finish in seconds.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/clock.h"
+#include "base/flags.h"
+#include "base/json_writer.h"
+#include "base/summary.h"
+#include "media/abr_simulation.h"
+#include "media/manifest.h"
+#include "net/http_client.h"
+
+namespace {
+
+constexpr const char kUsage[] =
+    "Usage: abr_simulator [options] [TRACE...]\n"
+    "\n"
+    "Each TRACE file holds '<seconds> <kbit/s>' lines.\n"
+    "\n"
+    "  --synthetic=N            Add N generated traces (default 0, or 1000\n"
+    "                           when no TRACE is given)\n"
+    "  --synthetic-kbps=K       Mean bandwidth of generated traces (default\n"
+    "                           3000)\n"
+    "  --seed=N                 First generated trace's seed (default 1)\n"
+    "  --manifest=URL           Take variants and segment length from a DASH\n"
+    "                           or HLS manifest\n"
+    "  --ladder=K[,K...]        Otherwise, variant bit rates in kbit/s\n"
+    "                           (default 400,800,1600,3200,6400)\n"
+    "  --segment-seconds=S      Segment length (default 4)\n"
+    "  --content-seconds=S      Content length (default 600)\n"
+    "  --switch-interval=S[,S...]   abr.switchInterval (default 8)\n"
+    "  --upgrade-target=F[,F...]    abr.bandwidthUpgradeTarget (default 0.85)\n"
+    "  --downgrade-target=F[,F...]  abr.bandwidthDowngradeTarget (default\n"
+    "                               0.95)\n"
+    "  --buffering-goal=S[,S...]    streaming.bufferingGoal (default 10)\n"
+    "  --rebuffering-goal=S     streaming.rebufferingGoal (default 2)\n"
+    "  --rtt-ms=N               Request round-trip time (default 50)\n"
+    "  --threads=N              Worker threads (default CPU count)\n"
+    "  --per-trace              Print one line per trace and configuration\n"
+    "  --json=PATH              Also write the results as JSON ('-' = "
+    "stdout)\n"
+    "\n"
+    "Each combination of the comma-separated values is one configuration,\n"
+    "simulated over every trace.\n";
+
+/** Parses a comma-separated list of positive numbers. */
+bool ParseNumberList(const std::string& name, const std::string& value,
+                     std::vector<double>* numbers, std::string* error) {
+  numbers->clear();
+  std::istringstream items(value);
+  std::string item;
+  while (std::getline(items, item, ',')) {
+    char* end = nullptr;
+    const double number = std::strtod(item.c_str(), &end);
+    if (item.empty() || *end != '\0' || !(number > 0)) {
+      *error = "Invalid --" + name + ": " + value;
+      return false;
+    }
+    numbers->push_back(number);
+  }
+  if (numbers->empty()) {
+    *error = "Invalid --" + name + ": " + value;
+    return false;
+  }
+  return true;
+}
+
+bool ReadFile(const std::string& path, std::string* contents,
+              std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    *error = "Unable to open " + path;
+    return false;
+  }
+  contents->assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+  return true;
+}
+
+bool LoadManifestContent(const std::string& url,
+                         sample::SimulatedContent* content,
+                         std::string* error) {
+  sample::HttpResult result;
+  if (!sample::HttpGet(url, "", &result, error))
+    return false;
+  if (result.status != 200) {
+    *error = "HTTP " + std::to_string(result.status) + " for " + url;
+    return false;
+  }
+  sample::Manifest manifest;
+  return sample::ParseManifest(url, *result.body, &manifest, error) &&
+         sample::ContentFromManifest(manifest, content, error);
+}
+
+/** Every combination of the swept settings. */
+std::vector<sample::AbrConfig> ExpandConfigs(
+    const sample::AbrConfig& base, const std::vector<double>& switch_intervals,
+    const std::vector<double>& upgrade_targets,
+    const std::vector<double>& downgrade_targets,
+    const std::vector<double>& buffering_goals) {
+  std::vector<sample::AbrConfig> ret;
+  for (double switch_interval : switch_intervals) {
+    for (double upgrade_target : upgrade_targets) {
+      for (double downgrade_target : downgrade_targets) {
+        for (double buffering_goal : buffering_goals) {
+          sample::AbrConfig config = base;
+          config.switch_interval = switch_interval;
+          config.upgrade_target = upgrade_target;
+          config.downgrade_target = downgrade_target;
+          config.buffering_goal = buffering_goal;
+          ret.push_back(config);
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+/** Aggregates of one configuration's sessions. */
+struct ConfigSummary {
+  sample::Summary bitrate_kbps;
+  sample::Summary switches;
+  sample::Summary stall_seconds;
+  sample::Summary startup_seconds;
+  /** Sessions with at least one stall. */
+  size_t stalled_sessions = 0;
+};
+
+ConfigSummary SummarizeConfig(
+    const std::vector<sample::SimulationResult>& results) {
+  std::vector<double> bitrate_kbps, switches, stall_seconds, startup_seconds;
+  ConfigSummary ret;
+  for (auto& result : results) {
+    bitrate_kbps.push_back(result.average_bitrate / 1000);
+    switches.push_back(result.switches);
+    stall_seconds.push_back(result.stall_seconds);
+    startup_seconds.push_back(result.startup_seconds);
+    if (result.stalls > 0)
+      ret.stalled_sessions++;
+  }
+  ret.bitrate_kbps = sample::Summarize(bitrate_kbps);
+  ret.switches = sample::Summarize(switches);
+  ret.stall_seconds = sample::Summarize(stall_seconds);
+  ret.startup_seconds = sample::Summarize(startup_seconds);
+  return ret;
+}
+
+void WriteConfig(const sample::AbrConfig& config, sample::JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("switch_interval");
+  writer->Number(config.switch_interval);
+  writer->Key("upgrade_target");
+  writer->Number(config.upgrade_target);
+  writer->Key("downgrade_target");
+  writer->Number(config.downgrade_target);
+  writer->Key("buffering_goal");
+  writer->Number(config.buffering_goal);
+  writer->Key("rebuffering_goal");
+  writer->Number(config.rebuffering_goal);
+  writer->Key("rtt_ms");
+  writer->Number(config.rtt_ms);
+  writer->EndObject();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sample::Flags flags(argc, argv);
+  const std::vector<std::string>& trace_paths = flags.positional();
+  const int64_t synthetic =
+      flags.GetInt("synthetic", trace_paths.empty() ? 1000 : 0);
+  const double synthetic_kbps = flags.GetDouble("synthetic-kbps", 3000);
+  const int64_t seed = flags.GetInt("seed", 1);
+  const std::string manifest_url = flags.GetString("manifest", "");
+  const std::string ladder =
+      flags.GetString("ladder", "400,800,1600,3200,6400");
+  const double segment_seconds = flags.GetDouble("segment-seconds", 4);
+  const double content_seconds = flags.GetDouble("content-seconds", 600);
+  const std::string switch_interval = flags.GetString("switch-interval", "8");
+  const std::string upgrade_target = flags.GetString("upgrade-target", "0.85");
+  const std::string downgrade_target =
+      flags.GetString("downgrade-target", "0.95");
+  const std::string buffering_goal = flags.GetString("buffering-goal", "10");
+  sample::AbrConfig base;
+  base.rebuffering_goal = flags.GetDouble("rebuffering-goal", 2);
+  base.rtt_ms = flags.GetDouble("rtt-ms", 50);
+  const int64_t threads = flags.GetInt(
+      "threads", std::max(1u, std::thread::hardware_concurrency()));
+  const bool per_trace = flags.GetBool("per-trace", false);
+  const std::string json_path = flags.GetString("json", "");
+
+  std::string error;
+  std::vector<double> ladder_kbps, switch_intervals, upgrade_targets,
+      downgrade_targets, buffering_goals;
+  if (!flags.Validate(&error) ||
+      !ParseNumberList("ladder", ladder, &ladder_kbps, &error) ||
+      !ParseNumberList("switch-interval", switch_interval, &switch_intervals,
+                       &error) ||
+      !ParseNumberList("upgrade-target", upgrade_target, &upgrade_targets,
+                       &error) ||
+      !ParseNumberList("downgrade-target", downgrade_target,
+                       &downgrade_targets, &error) ||
+      !ParseNumberList("buffering-goal", buffering_goal, &buffering_goals,
+                       &error) ||
+      synthetic < 0 || synthetic_kbps <= 0 || segment_seconds <= 0 ||
+      content_seconds <= 0 || base.rebuffering_goal <= 0 ||
+      base.rtt_ms < 0 || threads < 1 ||
+      (trace_paths.empty() && synthetic == 0)) {
+    if (!error.empty())
+      std::cerr << error << "\n\n";
+    std::cerr << kUsage;
+    return 1;
+  }
+
+  sample::SimulatedContent content;
+  content.segment_seconds = segment_seconds;
+  content.duration = content_seconds;
+  if (!manifest_url.empty()) {
+    if (!LoadManifestContent(manifest_url, &content, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+  } else {
+    std::sort(ladder_kbps.begin(), ladder_kbps.end());
+    for (double kbps : ladder_kbps) {
+      sample::Variant variant;
+      variant.bandwidth = static_cast<uint64_t>(kbps * 1000);
+      content.variants.push_back(variant);
+    }
+  }
+
+  std::vector<sample::BandwidthTrace> traces;
+  for (auto& path : trace_paths) {
+    std::string text;
+    traces.emplace_back();
+    if (!ReadFile(path, &text, &error) ||
+        !sample::ParseBandwidthTrace(path, text, &traces.back(), &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+  }
+  // Generated traces cover the content, stalls included, without looping.
+  for (int64_t i = 0; i < synthetic; i++) {
+    traces.push_back(sample::SyntheticBandwidthTrace(
+        static_cast<uint32_t>(seed + i), 2 * content.duration,
+        synthetic_kbps * 1000));
+  }
+
+  const std::vector<sample::AbrConfig> configs =
+      ExpandConfigs(base, switch_intervals, upgrade_targets,
+                    downgrade_targets, buffering_goals);
+  std::vector<std::vector<sample::SimulationResult>> results(
+      configs.size(),
+      std::vector<sample::SimulationResult>(traces.size()));
+
+  // Sessions are independent, so workers just claim the next one.
+  const size_t jobs = configs.size() * traces.size();
+  std::atomic<size_t> next_job(0);
+  std::vector<std::thread> workers;
+  const sample::Clock::time_point start = sample::Clock::now();
+  for (int64_t i = 0; i < std::min<int64_t>(threads, jobs); i++) {
+    workers.emplace_back([&]() {
+      size_t job;
+      while ((job = next_job.fetch_add(1, std::memory_order_relaxed)) <
+             jobs) {
+        const size_t config = job / traces.size();
+        const size_t trace = job % traces.size();
+        results[config][trace] =
+            sample::SimulateSession(content, traces[trace], configs[config]);
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  const double elapsed =
+      std::chrono::duration<double>(sample::Clock::now() - start).count();
+
+  std::printf("%zu variants, %.1f s segments, %.0f s content, %zu traces\n",
+              content.variants.size(), content.segment_seconds,
+              content.duration, traces.size());
+  std::vector<ConfigSummary> summaries;
+  for (size_t i = 0; i < configs.size(); i++) {
+    const sample::AbrConfig& config = configs[i];
+    summaries.push_back(SummarizeConfig(results[i]));
+    const ConfigSummary& summary = summaries.back();
+    std::printf(
+        "switch interval %.1f s, upgrade %.2f, downgrade %.2f, "
+        "buffering goal %.1f s\n",
+        config.switch_interval, config.upgrade_target,
+        config.downgrade_target, config.buffering_goal);
+    if (per_trace) {
+      for (auto& result : results[i]) {
+        std::printf("  %s: %.0f kbit/s, %zu switches, %zu stalls (%.1f s)\n",
+                    result.trace.c_str(), result.average_bitrate / 1000,
+                    result.switches, result.stalls, result.stall_seconds);
+      }
+    }
+    std::printf("  bit rate  %s\n",
+                sample::FormatSummary(summary.bitrate_kbps, " kbit/s")
+                    .c_str());
+    std::printf("  switches  %s\n",
+                sample::FormatSummary(summary.switches, "").c_str());
+    std::printf("  stalled   %s\n",
+                sample::FormatSummary(summary.stall_seconds, " s").c_str());
+    std::printf("  startup   %s\n",
+                sample::FormatSummary(summary.startup_seconds, " s").c_str());
+    std::printf("  %zu of %zu sessions stalled\n", summary.stalled_sessions,
+                results[i].size());
+  }
+  std::printf("%zu sessions in %.2f s on %lld threads (%.0f sessions/min)\n",
+              jobs, elapsed, static_cast<long long>(workers.size()),
+              elapsed > 0 ? jobs * 60 / elapsed : 0.0);
+
+  if (!json_path.empty()) {
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+    if (json_path != "-") {
+      file.open(json_path);
+      out = &file;
+    }
+    sample::JsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("variants");
+    writer.BeginArray();
+    for (auto& variant : content.variants)
+      writer.Uint(variant.bandwidth);
+    writer.EndArray();
+    writer.Key("segment_seconds");
+    writer.Number(content.segment_seconds);
+    writer.Key("content_seconds");
+    writer.Number(content.duration);
+    writer.Key("elapsed_seconds");
+    writer.Number(elapsed);
+    writer.Key("configs");
+    writer.BeginArray();
+    for (size_t i = 0; i < configs.size(); i++) {
+      writer.BeginObject();
+      writer.Key("config");
+      WriteConfig(configs[i], &writer);
+      writer.Key("bitrate_kbps");
+      sample::WriteSummary(summaries[i].bitrate_kbps, &writer);
+      writer.Key("switches");
+      sample::WriteSummary(summaries[i].switches, &writer);
+      writer.Key("stall_seconds");
+      sample::WriteSummary(summaries[i].stall_seconds, &writer);
+      writer.Key("startup_seconds");
+      sample::WriteSummary(summaries[i].startup_seconds, &writer);
+      writer.Key("stalled_sessions");
+      writer.Uint(summaries[i].stalled_sessions);
+      writer.Key("sessions");
+      writer.BeginArray();
+      for (auto& result : results[i])
+        sample::WriteSimulationResult(result, &writer);
+      writer.EndArray();
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    *out << "\n";
+    out->flush();
+    if (!*out) {
+      std::cerr << "Unable to write " << json_path << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,310 @@
+// Measures finding the text cues showing at a time, the lookup a renderer
+// makes every frame, in a CueStore against scanning every cue.  Synthetic
+// dense captions of increasing size arrive as WebVTT segments, so parsing
+// and incremental indexing are timed too.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/clock.h"
+#include "base/flags.h"
+#include "base/json_writer.h"
+#include "media/cue_store.h"
+#include "media/webvtt_parser.h"
+
+namespace {
+
+constexpr const char kUsage[] =
+    "Usage: cue_store_benchmark [options]\n"
+    "\n"
+    "  --min-cues=N         Smallest cue set (default 1000)\n"
+    "  --max-cues=N         Largest cue set; sizes grow 4x (default 1000000)\n"
+    "  --cue-spacing=S      Mean seconds between cue starts (default 2)\n"
+    "  --long-cues=P        Fraction of cues, like speaker labels, that last\n"
+    "                       30 to 120 s (default 0.01)\n"
+    "  --segment-seconds=S  Text segment length (default 6)\n"
+    "  --lookups=N          Active-cue lookups per size (default 100000)\n"
+    "  --seed=N             Seed for cue times and lookup times (default 1)\n"
+    "  --json=PATH          Also write the results as JSON ('-' = stdout)\n";
+
+/**
+ * Scans test every cue, so at large sizes only enough lookups to test about
+ * this many cues are scanned, but at least kMinScans.
+ */
+constexpr double kScanBudget = 5e8;
+constexpr size_t kMinScans = 1000;
+
+/** Frame times per lookup run; runs start at random times. */
+constexpr size_t kFramesPerRun = 300;
+constexpr double kFrameSeconds = 1.0 / 30;
+
+struct Row {
+  size_t cues = 0;
+  size_t segments = 0;
+  double parse_ns = 0;
+  double index_ns = 0;
+  double indexed_lookup_ns = 0;
+  double linear_lookup_ns = 0;
+  /** Lookups timed with a scan. */
+  size_t scans = 0;
+  double mean_active = 0;
+};
+
+std::string FormatTimestamp(double seconds) {
+  const uint64_t millis = static_cast<uint64_t>(seconds * 1000 + 0.5);
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%02llu:%02llu:%02llu.%03llu",
+                static_cast<unsigned long long>(millis / 3600000),
+                static_cast<unsigned long long>(millis / 60000 % 60),
+                static_cast<unsigned long long>(millis / 1000 % 60),
+                static_cast<unsigned long long>(millis % 1000));
+  return buffer;
+}
+
+/** Generates |count| caption cues, sorted by start. */
+std::vector<sample::Cue> GenerateCues(size_t count, double spacing,
+                                      double long_fraction,
+                                      std::mt19937* random) {
+  std::uniform_real_distribution<double> unit(0, 1);
+  std::vector<sample::Cue> ret(count);
+  double start = 0;
+  for (size_t i = 0; i < count; i++) {
+    start += spacing * (0.5 + unit(*random));
+    sample::Cue& cue = ret[i];
+    const double end = unit(*random) < long_fraction
+                           ? start + 30 + 90 * unit(*random)
+                           : start + 1 + 4 * unit(*random);
+    // Whole milliseconds, so times survive the WebVTT round trip.
+    cue.start = std::round(start * 1000) / 1000;
+    cue.end = std::round(end * 1000) / 1000;
+    cue.id = std::to_string(i);
+    cue.payload = "Caption " + std::to_string(i) + "\nsecond line";
+  }
+  return ret;
+}
+
+/**
+ * Splits |cues| into WebVTT segments.  A cue is written into every segment
+ * it overlaps, as packagers do.
+ */
+std::vector<std::string> WriteSegments(const std::vector<sample::Cue>& cues,
+                                       double segment_seconds) {
+  std::vector<std::string> ret;
+  size_t first = 0;
+  for (double start = 0; first < cues.size(); start += segment_seconds) {
+    const double end = start + segment_seconds;
+    std::string body = "WEBVTT\n";
+    for (size_t i = first; i < cues.size() && cues[i].start < end; i++) {
+      if (cues[i].end <= start)
+        continue;
+      body += "\n" + cues[i].id + "\n" + FormatTimestamp(cues[i].start) +
+              " --> " + FormatTimestamp(cues[i].end) + "\n" +
+              cues[i].payload + "\n";
+    }
+    ret.push_back(std::move(body));
+    while (first < cues.size() && cues[first].start < end)
+      first++;
+  }
+  return ret;
+}
+
+/** What a text track does without an index: test every cue. */
+void LinearActiveAt(const std::vector<sample::Cue>& cues, double time,
+                    std::vector<const sample::Cue*>* active) {
+  active->clear();
+  for (auto& cue : cues) {
+    if (cue.start <= time && time < cue.end)
+      active->push_back(&cue);
+  }
+}
+
+/**
+ * Returns the mean nanoseconds per lookup over the first |count| times, and
+ * the active cues found.
+ */
+template <typename Lookup>
+double TimeLookups(const std::vector<double>& times, size_t count,
+                   Lookup lookup, size_t* found) {
+  std::vector<const sample::Cue*> active;
+  *found = 0;
+  const sample::Clock::time_point start = sample::Clock::now();
+  for (size_t i = 0; i < count; i++) {
+    lookup(times[i], &active);
+    *found += active.size();
+  }
+  return sample::MillisecondsSince(start) * 1e6 / count;
+}
+
+bool RunSize(size_t count, double spacing, double long_fraction,
+             double segment_seconds, size_t lookups, uint32_t seed, Row* row,
+             std::string* error) {
+  std::mt19937 random(seed);
+  const std::vector<sample::Cue> cues =
+      GenerateCues(count, spacing, long_fraction, &random);
+  const std::vector<std::string> segments =
+      WriteSegments(cues, segment_seconds);
+
+  sample::CueStore store;
+  double parse_ms = 0;
+  double index_ms = 0;
+  std::vector<sample::Cue> parsed;
+  for (auto& segment : segments) {
+    parsed.clear();
+    const sample::Clock::time_point start = sample::Clock::now();
+    if (!sample::ParseWebVtt(segment, 0, &parsed, error))
+      return false;
+    const sample::Clock::time_point parsed_at = sample::Clock::now();
+    store.AddSegment(std::move(parsed));
+    parse_ms += sample::MillisecondsBetween(start, parsed_at);
+    index_ms += sample::MillisecondsSince(parsed_at);
+  }
+  if (store.size() != cues.size()) {
+    *error = "Indexed " + std::to_string(store.size()) + " of " +
+             std::to_string(cues.size()) + " cues";
+    return false;
+  }
+
+  // Runs of consecutive frames, as a renderer looks cues up.
+  std::vector<double> times;
+  std::uniform_real_distribution<double> run_start(0, cues.back().end);
+  while (times.size() < lookups) {
+    const double first = run_start(random);
+    for (size_t i = 0; i < kFramesPerRun && times.size() < lookups; i++)
+      times.push_back(first + i * kFrameSeconds);
+  }
+
+  auto indexed = [&store](double time,
+                          std::vector<const sample::Cue*>* active) {
+    store.ActiveAt(time, active);
+  };
+  auto linear = [&cues](double time,
+                        std::vector<const sample::Cue*>* active) {
+    LinearActiveAt(cues, time, active);
+  };
+  const size_t scans = std::min(
+      lookups, std::max(kMinScans, static_cast<size_t>(kScanBudget / count)));
+  size_t indexed_found;
+  size_t linear_found;
+  row->cues = count;
+  row->segments = segments.size();
+  row->parse_ns = parse_ms * 1e6 / count;
+  row->index_ns = index_ms * 1e6 / count;
+  row->scans = scans;
+  row->indexed_lookup_ns =
+      TimeLookups(times, times.size(), indexed, &indexed_found);
+  row->mean_active = static_cast<double>(indexed_found) / times.size();
+  row->linear_lookup_ns = TimeLookups(times, scans, linear, &linear_found);
+
+  // Both must find the same cues where both looked.
+  TimeLookups(times, scans, indexed, &indexed_found);
+  if (indexed_found != linear_found) {
+    *error = "Lookups found " + std::to_string(indexed_found) +
+             " active cues, scans " + std::to_string(linear_found);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sample::Flags flags(argc, argv);
+  const int64_t min_cues = flags.GetInt("min-cues", 1000);
+  const int64_t max_cues = flags.GetInt("max-cues", 1000000);
+  const double spacing = flags.GetDouble("cue-spacing", 2);
+  const double long_fraction = flags.GetDouble("long-cues", 0.01);
+  const double segment_seconds = flags.GetDouble("segment-seconds", 6);
+  const int64_t lookups = flags.GetInt("lookups", 100000);
+  const int64_t seed = flags.GetInt("seed", 1);
+  const std::string json_path = flags.GetString("json", "");
+
+  std::string error;
+  if (!flags.Validate(&error) || min_cues < 1 || max_cues < min_cues ||
+      spacing <= 0 || long_fraction < 0 || long_fraction > 1 ||
+      segment_seconds <= 0 || lookups < 1) {
+    if (!error.empty())
+      std::cerr << error << "\n\n";
+    std::cerr << kUsage;
+    return 1;
+  }
+
+  std::vector<Row> rows;
+  std::printf("%9s %9s %10s %10s %12s %12s %8s %7s\n", "cues", "segments",
+              "parse ns", "index ns", "indexed ns", "linear ns", "speedup",
+              "active");
+  for (int64_t count = min_cues;; count = std::min(count * 4, max_cues)) {
+    Row row;
+    if (!RunSize(static_cast<size_t>(count), spacing, long_fraction,
+                 segment_seconds, static_cast<size_t>(lookups),
+                 static_cast<uint32_t>(seed), &row, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    rows.push_back(row);
+    std::printf("%9zu %9zu %10.1f %10.1f %12.1f %12.1f %7.1fx %7.2f\n",
+                row.cues, row.segments, row.parse_ns, row.index_ns,
+                row.indexed_lookup_ns, row.linear_lookup_ns,
+                row.linear_lookup_ns / row.indexed_lookup_ns,
+                row.mean_active);
+    if (count == max_cues)
+      break;
+  }
+  std::printf("parse and index are per cue; lookups per frame\n");
+
+  if (!json_path.empty()) {
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+    if (json_path != "-") {
+      file.open(json_path);
+      out = &file;
+    }
+    sample::JsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("cue_spacing");
+    writer.Number(spacing);
+    writer.Key("long_cues");
+    writer.Number(long_fraction);
+    writer.Key("segment_seconds");
+    writer.Number(segment_seconds);
+    writer.Key("lookups");
+    writer.Int(lookups);
+    writer.Key("rows");
+    writer.BeginArray();
+    for (auto& row : rows) {
+      writer.BeginObject();
+      writer.Key("cues");
+      writer.Uint(row.cues);
+      writer.Key("segments");
+      writer.Uint(row.segments);
+      writer.Key("parse_ns_per_cue");
+      writer.Number(row.parse_ns);
+      writer.Key("index_ns_per_cue");
+      writer.Number(row.index_ns);
+      writer.Key("indexed_lookup_ns");
+      writer.Number(row.indexed_lookup_ns);
+      writer.Key("linear_lookup_ns");
+      writer.Number(row.linear_lookup_ns);
+      writer.Key("scans");
+      writer.Uint(row.scans);
+      writer.Key("mean_active");
+      writer.Number(row.mean_active);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    *out << "\n";
+    out->flush();
+    if (!*out) {
+      std::cerr << "Unable to write " << json_path << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
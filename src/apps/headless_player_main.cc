@@ -0,0 +1,942 @@
+// Plays a DASH or HLS manifest through Shaka Player Embedded with null
+// renderers and reports startup time, decode throughput and peak RSS.
+
+#include <shaka/js_manager.h>
+#include <shaka/media/demuxer.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/flags.h"
+#include "base/json_writer.h"
+#include "base/process_stats.h"
+#include "base/stage_timings.h"
+#include "base/summary.h"
+#include "media/sample_arena.h"
+#include "net/caching_proxy.h"
+#include "net/http_client.h"
+#include "net/http_server.h"
+#include "net/local_media_server.h"
+#include "net/session_trace.h"
+#include "net/trace_recorder.h"
+#include "net/trace_replayer.h"
+#include "player/headless_player.h"
+#include "player/pooled_demuxer.h"
+#include "player/render_loop.h"
+#include "player/seek_benchmark.h"
+#include "player/timing_demuxer.h"
+
+namespace {
+
+constexpr const char kUsage[] =
+    "Usage: headless_player --manifest=URL [options]\n"
+    "       headless_player --replay=TRACE [options]\n"
+    "\n"
+    "  --serve=DIR            Serve DIR from an in-process local server; a\n"
+    "                         relative --manifest is resolved against it and\n"
+    "                         the network condition flags below apply\n"
+    "  --runs=N               Number of sequential sessions (default 1)\n"
+    "  --instances=N[,N...]   Run N concurrent players instead, once per\n"
+    "                         count, and report how the host scales\n"
+    "  --render-threads=N     Render threads shared by all players (default\n"
+    "                         min(instances, CPU count))\n"
+    "  --play-seconds=S       Wall-clock play time after the first frame\n"
+    "                         (default 10)\n"
+    "  --rate=R               Playback rate (default 1)\n"
+    "  --startup-timeout=S    Seconds to wait for the first frame\n"
+    "                         (default 30)\n"
+    "  --frame-handoff=MODE   'zero-copy' (default) or 'copy' frames into\n"
+    "                         app-owned buffers\n"
+    "  --fast-start           Overlap manifest parsing, init-segment fetches\n"
+    "                         and decoder warm-up with Player::Load(); routes\n"
+    "                         requests through the segment cache\n"
+    "  --compare-fast-start   Alternate sessions without and with fast start,\n"
+    "                         each through a fresh cache, and compare startup\n"
+    "  --bandwidth-estimate=B Initial bandwidth estimate in bit/s, which\n"
+    "                         picks the first variant (default 1000000)\n"
+    "  --segment-cache-mb=N   Route requests through an in-process cache of\n"
+    "                         N MiB of segments shared by every session\n"
+    "                         (default 0 = off, or 64 with fast start)\n"
+    "  --prefetch=K           With the cache, fetch the next K segments of a\n"
+    "                         representation in the background (default 0)\n"
+    "  --buffer-budget-mb=N   Cap buffered audio, video and text at N MiB:\n"
+    "                         the player's buffer lengths are derived from\n"
+    "                         it and demuxed samples are held in a slab\n"
+    "                         arena of that size; reports the arena's peak\n"
+    "                         and allocations\n"
+    "  --record=PATH          Record the session's network responses with\n"
+    "                         their timing, variant switches, pauses and\n"
+    "                         seeks to a binary trace (one session only)\n"
+    "  --replay=PATH          Replay a recorded trace without the origin,\n"
+    "                         with ABR off and the recorded switches and\n"
+    "                         seeks; the trace sets the rate and bandwidth\n"
+    "                         estimate\n"
+    "  --replay-speed=X       Replay X times faster than recorded: network\n"
+    "                         delays, event times and the playback rate are\n"
+    "                         all scaled (default 4)\n"
+    "  --stage-timings        Record per-stage latency histograms (manifest\n"
+    "                         fetch and parse, segment fetch, demux, decode,\n"
+    "                         render) and report them at exit\n"
+    "  --seek=PATTERN         Instead of playing, pause after the first frame\n"
+    "                         and time seeks: 'random' positions or 'scrub'\n"
+    "                         steps; reports seek-to-frame latency\n"
+    "  --seek-mode=MODE       'exact' (default), 'keyframe' to skip frames\n"
+    "                         the target doesn't need, or 'both' to compare\n"
+    "  --seeks=N              Seeks per session (default 50)\n"
+    "  --scrub-step=S         Seconds between scrub positions (default 0.5)\n"
+    "  --scrub-interval-ms=MS Time between scrub seeks (default 100)\n"
+    "  --seek-timeout=S       Seconds a random seek may take (default 10)\n"
+    "  --seek-seed=N          Seed for random positions (default 1)\n"
+    "  --json=PATH            Also write the results as JSON ('-' = stdout)\n"
+    "  --static-data-dir=DIR  Directory holding shaka-player.compiled.js\n"
+    "  --dynamic-data-dir=DIR Writable directory for player storage\n"
+    "                         (default ./shaka_data)\n";
+
+/** State shared by every session in one invocation. */
+struct Environment {
+  shaka::JsManager* engine;
+  sample::LocalMediaServer* server;
+  sample::CachingProxy* proxy;
+  sample::SampleArena* arena;
+  sample::TraceReplayer* replayer;
+  int64_t render_threads;
+};
+
+/** A CachingProxy served on a loopback port. */
+struct ProxyEndpoint {
+  std::unique_ptr<sample::CachingProxy> proxy;
+  // Declared after the proxy so it stops first.
+  std::unique_ptr<sample::HttpServer> server;
+  /** The manifest URI rewritten to go through the proxy. */
+  std::string manifest_uri;
+};
+
+/** Starts a proxy in front of the origin that serves |manifest_uri|. */
+bool StartProxy(const std::string& manifest_uri,
+                sample::CachingProxyOptions options, ProxyEndpoint* endpoint,
+                std::string* error) {
+  sample::ParsedUrl url;
+  if (!sample::ParseHttpUrl(manifest_uri, &url)) {
+    *error = "The segment cache and fast start need an http:// manifest";
+    return false;
+  }
+  options.upstream = "http://" + url.host + ":" + std::to_string(url.port);
+  endpoint->proxy.reset(new sample::CachingProxy(options));
+  endpoint->server.reset(new sample::HttpServer(endpoint->proxy.get()));
+  if (!endpoint->server->Start(0, error))
+    return false;
+  endpoint->manifest_uri = endpoint->server->BaseUrl() + url.target;
+  return true;
+}
+
+double Mebibytes(uint64_t bytes) {
+  return bytes / (1024.0 * 1024.0);
+}
+
+/** Parses a comma-separated list of positive integers. */
+bool ParseCounts(const std::string& list, std::vector<int64_t>* counts) {
+  size_t start = 0;
+  while (start <= list.size()) {
+    const size_t end = std::min(list.find(',', start), list.size());
+    char* parse_end = nullptr;
+    const std::string item = list.substr(start, end - start);
+    const long long value = std::strtoll(item.c_str(), &parse_end, 10);
+    if (item.empty() || *parse_end != '\0' || value < 1)
+      return false;
+    counts->push_back(value);
+    start = end + 1;
+  }
+  return !counts->empty();
+}
+
+size_t RenderThreadsFor(const Environment& env, size_t instances) {
+  if (env.render_threads > 0)
+    return static_cast<size_t>(env.render_threads);
+  return std::max<size_t>(
+      1, std::min<size_t>(instances, std::thread::hardware_concurrency()));
+}
+
+/** Collects the per-run metrics of the sessions that succeeded. */
+void CollectSuccessful(const std::vector<sample::PlaybackReport>& reports,
+                       std::vector<double>* startup_ms,
+                       std::vector<double>* fps) {
+  for (auto& report : reports) {
+    if (report.ok) {
+      startup_ms->push_back(report.startup_ms);
+      fps->push_back(report.frames_per_second);
+    }
+  }
+}
+
+void PrintReport(const std::string& label,
+                 const sample::PlaybackReport& report) {
+  if (!report.ok) {
+    std::printf("%s: FAILED: %s\n", label.c_str(), report.error.c_str());
+    return;
+  }
+  std::printf(
+      "%s: startup %.1f ms (load %.1f ms), %llu frames in %.1f s "
+      "(%.1f fps), %llu dropped, %llu rebuffers (%.1f ms)\n",
+      label.c_str(), report.startup_ms, report.load_ms,
+      static_cast<unsigned long long>(report.frames_presented),
+      report.play_seconds, report.frames_per_second,
+      static_cast<unsigned long long>(report.dropped_frames),
+      static_cast<unsigned long long>(report.rebuffers), report.rebuffer_ms);
+  std::printf(
+      "  %s hand-off: %.1f MiB copied, render thread %.1f ms CPU "
+      "(%.3f ms/frame), process %.1f ms CPU, %llu pool misses\n",
+      sample::FrameHandoffName(report.frame_handoff),
+      Mebibytes(report.bytes_copied), report.render_cpu_ms,
+      report.frames_presented ? report.render_cpu_ms / report.frames_presented
+                              : 0,
+      report.process_cpu_ms,
+      static_cast<unsigned long long>(report.pool_exhausted));
+  if (report.fast_start) {
+    const sample::FastStartReport& work = report.fast_start_report;
+    std::printf(
+        "  fast start: manifest %.1f ms, first segments %.1f ms, decoder "
+        "warm-up %.1f ms, %.1f MiB preloaded%s%s\n",
+        work.manifest_ms, work.segments_ms, work.warm_up_ms,
+        Mebibytes(work.bytes_preloaded), work.ok ? "" : ", incomplete: ",
+        work.error.c_str());
+  }
+  if (report.buffer_limited) {
+    const sample::BufferPolicy& policy = report.buffer_policy;
+    std::printf(
+        "  buffer budget %.1f MiB at %.0f kbit/s: %.1f s ahead, %.1f s "
+        "behind, %.1f s to resume\n",
+        Mebibytes(policy.byte_budget), policy.peak_bandwidth / 1000,
+        policy.buffering_goal, policy.buffer_behind, policy.rebuffering_goal);
+  }
+}
+
+void WriteNetworkStats(const sample::LocalMediaServer& server,
+                       sample::JsonWriter* writer) {
+  const sample::NetworkStats stats = server.stats();
+  writer->BeginObject();
+  writer->Key("requests");
+  writer->Uint(stats.requests);
+  writer->Key("failures");
+  writer->Uint(stats.failures);
+  writer->Key("bytes_sent");
+  writer->Uint(stats.bytes_sent);
+  writer->EndObject();
+}
+
+void PrintCacheStats(const sample::CachingProxy& proxy) {
+  const sample::SegmentCacheStats stats = proxy.cache_stats();
+  const uint64_t lookups = stats.hits + stats.misses;
+  std::printf(
+      "segment cache: %llu hits, %llu misses (%.1f%% hit rate), %.1f MiB "
+      "saved, %llu/%llu prefetches used, %llu/%llu preloads used, %llu "
+      "evictions, %llu joined in-flight fetches, %.1f of %.1f MiB held\n",
+      static_cast<unsigned long long>(stats.hits),
+      static_cast<unsigned long long>(stats.misses),
+      lookups ? 100.0 * stats.hits / lookups : 0.0,
+      Mebibytes(stats.bytes_saved),
+      static_cast<unsigned long long>(stats.prefetch_hits),
+      static_cast<unsigned long long>(stats.prefetched),
+      static_cast<unsigned long long>(stats.preload_hits),
+      static_cast<unsigned long long>(stats.preloaded),
+      static_cast<unsigned long long>(stats.evictions),
+      static_cast<unsigned long long>(proxy.in_flight_joins()),
+      Mebibytes(stats.bytes_cached), Mebibytes(stats.byte_budget));
+}
+
+void WriteCacheStats(const sample::CachingProxy& proxy,
+                     sample::JsonWriter* writer) {
+  const sample::SegmentCacheStats stats = proxy.cache_stats();
+  writer->BeginObject();
+  writer->Key("hits");
+  writer->Uint(stats.hits);
+  writer->Key("misses");
+  writer->Uint(stats.misses);
+  writer->Key("bytes_saved");
+  writer->Uint(stats.bytes_saved);
+  writer->Key("prefetched");
+  writer->Uint(stats.prefetched);
+  writer->Key("prefetch_hits");
+  writer->Uint(stats.prefetch_hits);
+  writer->Key("preloaded");
+  writer->Uint(stats.preloaded);
+  writer->Key("preload_hits");
+  writer->Uint(stats.preload_hits);
+  writer->Key("evictions");
+  writer->Uint(stats.evictions);
+  writer->Key("in_flight_joins");
+  writer->Uint(proxy.in_flight_joins());
+  writer->Key("bytes_cached");
+  writer->Uint(stats.bytes_cached);
+  writer->Key("byte_budget");
+  writer->Uint(stats.byte_budget);
+  writer->EndObject();
+}
+
+void PrintReplayStats(const sample::TraceReplayer& replayer) {
+  const sample::TraceReplayStats stats = replayer.stats();
+  std::printf(
+      "replay: %llu requests, %llu not in the trace, %llu beyond the "
+      "recorded count\n",
+      static_cast<unsigned long long>(stats.requests),
+      static_cast<unsigned long long>(stats.misses),
+      static_cast<unsigned long long>(stats.repeats));
+}
+
+void WriteReplayStats(const sample::TraceReplayer& replayer,
+                      sample::JsonWriter* writer) {
+  const sample::TraceReplayStats stats = replayer.stats();
+  writer->BeginObject();
+  writer->Key("requests");
+  writer->Uint(stats.requests);
+  writer->Key("misses");
+  writer->Uint(stats.misses);
+  writer->Key("repeats");
+  writer->Uint(stats.repeats);
+  writer->EndObject();
+}
+
+void PrintArenaStats(const sample::SampleArena& arena) {
+  const sample::SampleArenaStats stats = arena.stats();
+  using sample::StreamType;
+  std::printf(
+      "sample arena: %llu samples in %llu heap allocations (%llu large, %llu "
+      "over budget), peak %.1f MiB in use (video %.1f, audio %.1f, text "
+      "%.1f), peak %.1f of %.1f MiB reserved\n",
+      static_cast<unsigned long long>(stats.allocations),
+      static_cast<unsigned long long>(stats.heap_allocations),
+      static_cast<unsigned long long>(stats.large_allocations),
+      static_cast<unsigned long long>(stats.over_budget),
+      Mebibytes(stats.peak_bytes_in_use),
+      Mebibytes(stats.peak_bytes_in_use_by_type[static_cast<size_t>(
+          StreamType::kVideo)]),
+      Mebibytes(stats.peak_bytes_in_use_by_type[static_cast<size_t>(
+          StreamType::kAudio)]),
+      Mebibytes(stats.peak_bytes_in_use_by_type[static_cast<size_t>(
+          StreamType::kText)]),
+      Mebibytes(stats.peak_bytes_reserved), Mebibytes(stats.byte_budget));
+}
+
+void WriteArenaStats(const sample::SampleArena& arena,
+                     sample::JsonWriter* writer) {
+  const sample::SampleArenaStats stats = arena.stats();
+  writer->BeginObject();
+  writer->Key("allocations");
+  writer->Uint(stats.allocations);
+  writer->Key("heap_allocations");
+  writer->Uint(stats.heap_allocations);
+  writer->Key("large_allocations");
+  writer->Uint(stats.large_allocations);
+  writer->Key("over_budget");
+  writer->Uint(stats.over_budget);
+  writer->Key("peak_bytes_in_use");
+  writer->Uint(stats.peak_bytes_in_use);
+  writer->Key("peak_bytes_in_use_by_type");
+  writer->BeginObject();
+  for (size_t i = 0; i < sample::kStreamTypeCount; i++) {
+    writer->Key(
+        sample::StreamTypeName(static_cast<sample::StreamType>(i)));
+    writer->Uint(stats.peak_bytes_in_use_by_type[i]);
+  }
+  writer->EndObject();
+  writer->Key("peak_bytes_reserved");
+  writer->Uint(stats.peak_bytes_reserved);
+  writer->Key("byte_budget");
+  writer->Uint(stats.byte_budget);
+  writer->EndObject();
+}
+
+/**
+ * Writes one JSON object holding the fields |body| adds plus the process-wide
+ * counters.  Returns false if the file could not be written.
+ */
+bool WriteJson(const std::string& path, const Environment& env,
+               const std::function<void(sample::JsonWriter*)>& body) {
+  std::ofstream file;
+  std::ostream* out = &std::cout;
+  if (path != "-") {
+    file.open(path);
+    out = &file;
+  }
+
+  sample::JsonWriter writer(out);
+  writer.BeginObject();
+  body(&writer);
+  if (env.server) {
+    writer.Key("network");
+    WriteNetworkStats(*env.server, &writer);
+  }
+  if (env.proxy) {
+    writer.Key("segment_cache");
+    WriteCacheStats(*env.proxy, &writer);
+  }
+  if (env.replayer) {
+    writer.Key("replay");
+    WriteReplayStats(*env.replayer, &writer);
+  }
+  if (env.arena) {
+    writer.Key("sample_arena");
+    WriteArenaStats(*env.arena, &writer);
+  }
+  if (sample::StageTimingsEnabled()) {
+    writer.Key("stage_timings");
+    sample::WriteStageTimings(&writer);
+  }
+  writer.Key("peak_rss_bytes");
+  writer.Uint(sample::PeakRssBytes());
+  writer.EndObject();
+  *out << "\n";
+  out->flush();
+  return static_cast<bool>(*out);
+}
+
+/** Plays |runs| sessions one after the other. */
+bool RunSequential(const Environment& env,
+                   const sample::PlaybackOptions& options, int64_t runs,
+                   std::vector<sample::PlaybackReport>* reports) {
+  sample::RenderLoop render_loop(RenderThreadsFor(env, 1),
+                                 sample::kDefaultRenderInterval);
+  bool all_ok = true;
+  for (int64_t i = 0; i < runs; i++) {
+    // Each run gets a fresh player so no state carries over between runs.
+    sample::HeadlessPlayer player(env.engine, &render_loop);
+    reports->push_back(player.Run(options));
+    all_ok &= reports->back().ok;
+    PrintReport("run " + std::to_string(i + 1), reports->back());
+  }
+
+  std::vector<double> startup_ms;
+  std::vector<double> fps;
+  CollectSuccessful(*reports, &startup_ms, &fps);
+  std::printf("startup: %s\n",
+              sample::FormatSummary(sample::Summarize(startup_ms), " ms")
+                  .c_str());
+  std::printf("decode:  %s\n",
+              sample::FormatSummary(sample::Summarize(fps), " fps").c_str());
+  return all_ok;
+}
+
+void WriteSequentialResults(const std::vector<sample::PlaybackReport>& reports,
+                            sample::JsonWriter* writer) {
+  std::vector<double> startup_ms;
+  std::vector<double> fps;
+  CollectSuccessful(reports, &startup_ms, &fps);
+
+  writer->Key("runs");
+  writer->BeginArray();
+  for (auto& report : reports)
+    sample::WriteReport(report, writer);
+  writer->EndArray();
+  writer->Key("startup_ms");
+  sample::WriteSummary(sample::Summarize(startup_ms), writer);
+  writer->Key("frames_per_second");
+  sample::WriteSummary(sample::Summarize(fps), writer);
+}
+
+/**
+ * Alternates sessions without and with fast start.  Each session goes
+ * through a fresh, empty proxy so neither is served from the other's cache,
+ * and the order flips every run so warm-up of the process favours neither.
+ */
+bool RunComparison(const Environment& env,
+                   const sample::PlaybackOptions& options,
+                   const sample::CachingProxyOptions& proxy_options,
+                   int64_t runs, std::vector<sample::PlaybackReport>* baseline,
+                   std::vector<sample::PlaybackReport>* fast) {
+  sample::RenderLoop render_loop(RenderThreadsFor(env, 1),
+                                 sample::kDefaultRenderInterval);
+  bool all_ok = true;
+  for (int64_t i = 0; i < runs; i++) {
+    for (int j = 0; j < 2; j++) {
+      const bool fast_start = (i + j) % 2 == 1;
+      sample::PlaybackReport report;
+      ProxyEndpoint endpoint;
+      if (StartProxy(options.manifest_uri, proxy_options, &endpoint,
+                     &report.error)) {
+        sample::PlaybackOptions session = options;
+        session.manifest_uri = endpoint.manifest_uri;
+        session.fast_start = fast_start;
+        session.startup_proxy = endpoint.proxy.get();
+        sample::HeadlessPlayer player(env.engine, &render_loop);
+        report = player.Run(session);
+      }
+      all_ok &= report.ok;
+      PrintReport((fast_start ? "fast-start run " : "baseline run ") +
+                      std::to_string(i + 1),
+                  report);
+      (fast_start ? fast : baseline)->push_back(report);
+    }
+  }
+
+  std::vector<double> baseline_ms;
+  std::vector<double> fast_ms;
+  std::vector<double> fps;
+  CollectSuccessful(*baseline, &baseline_ms, &fps);
+  CollectSuccessful(*fast, &fast_ms, &fps);
+  const sample::Summary before = sample::Summarize(baseline_ms);
+  const sample::Summary after = sample::Summarize(fast_ms);
+  std::printf("startup without fast start: %s\n",
+              sample::FormatSummary(before, " ms").c_str());
+  std::printf("startup with fast start:    %s\n",
+              sample::FormatSummary(after, " ms").c_str());
+  if (before.count > 0 && after.count > 0) {
+    std::printf("median startup change: %+.1f ms (%+.1f%%)\n",
+                after.p50 - before.p50,
+                100 * (after.p50 - before.p50) / before.p50);
+  }
+  return all_ok;
+}
+
+void WriteComparisonResults(const std::vector<sample::PlaybackReport>& baseline,
+                            const std::vector<sample::PlaybackReport>& fast,
+                            sample::JsonWriter* writer) {
+  writer->Key("baseline");
+  writer->BeginObject();
+  WriteSequentialResults(baseline, writer);
+  writer->EndObject();
+  writer->Key("fast_start");
+  writer->BeginObject();
+  WriteSequentialResults(fast, writer);
+  writer->EndObject();
+}
+
+void PrintSeekReport(const std::string& label,
+                     const sample::SeekReport& report) {
+  if (!report.ok) {
+    std::printf("%s: FAILED: %s\n", label.c_str(), report.error.c_str());
+    return;
+  }
+  std::printf(
+      "%s: %s %s seeks: %zu of %zu completed, %zu superseded, %zu timed out\n",
+      label.c_str(), sample::SeekPatternName(report.pattern),
+      sample::SeekModeName(report.mode), report.completed, report.seeks,
+      report.superseded, report.timeouts);
+  std::printf("  latency: %s\n",
+              sample::FormatSummary(report.latency_ms, " ms").c_str());
+  std::printf("  decoded: %s\n",
+              sample::FormatSummary(report.frames_decoded, " frames").c_str());
+  std::printf("  landing error: %s\n",
+              sample::FormatSummary(report.landing_error_ms, " ms").c_str());
+  if (report.mode == sample::SeekMode::kKeyframe) {
+    std::printf("  keyframe index: %zu keyframes built in %.1f ms\n",
+                report.index_keyframes, report.index_build_ms);
+  }
+}
+
+/** Runs |runs| seek sessions per mode, each with a fresh player. */
+bool RunSeekBenchmark(const Environment& env,
+                      const sample::PlaybackOptions& options,
+                      const sample::SeekOptions& seek_options,
+                      const std::vector<sample::SeekMode>& modes, int64_t runs,
+                      std::vector<sample::SeekReport>* reports) {
+  sample::RenderLoop render_loop(RenderThreadsFor(env, 1),
+                                 sample::kDefaultRenderInterval);
+  bool all_ok = true;
+  for (int64_t i = 0; i < runs; i++) {
+    for (sample::SeekMode mode : modes) {
+      sample::SeekOptions session = seek_options;
+      session.mode = mode;
+      sample::HeadlessPlayer player(env.engine, &render_loop);
+      reports->push_back(player.RunSeeks(options, session));
+      all_ok &= reports->back().ok;
+      PrintSeekReport("run " + std::to_string(i + 1), reports->back());
+    }
+  }
+  return all_ok;
+}
+
+void WriteSeekResults(const std::vector<sample::SeekReport>& reports,
+                      sample::JsonWriter* writer) {
+  writer->Key("seeks");
+  writer->BeginArray();
+  for (auto& report : reports)
+    sample::WriteSeekReport(report, writer);
+  writer->EndArray();
+}
+
+/** The outcome of running N players at once. */
+struct ScalingResult {
+  size_t instances = 0;
+  size_t render_threads = 0;
+  size_t succeeded = 0;
+  sample::Summary startup_ms;
+  sample::Summary instance_fps;
+  double aggregate_fps = 0;
+  /** Growth in RSS over the idle process, divided by the instance count. */
+  double bytes_per_stream = 0;
+  double process_cpu_ms = 0;
+};
+
+ScalingResult RunInstances(const Environment& env,
+                           const sample::PlaybackOptions& options,
+                           size_t instances) {
+  ScalingResult result;
+  result.instances = instances;
+  result.render_threads = RenderThreadsFor(env, instances);
+  sample::RenderLoop render_loop(result.render_threads,
+                                 sample::kDefaultRenderInterval);
+  const uint64_t idle_rss = sample::CurrentRssBytes();
+
+  // All players share the engine and render loop; each is driven by its own
+  // thread only because HeadlessPlayer::Run() blocks.
+  std::vector<std::unique_ptr<sample::HeadlessPlayer>> players;
+  for (size_t i = 0; i < instances; i++) {
+    players.emplace_back(
+        new sample::HeadlessPlayer(env.engine, &render_loop));
+  }
+  std::vector<sample::PlaybackReport> reports(instances);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < instances; i++) {
+    threads.emplace_back([&, i]() { reports[i] = players[i]->Run(options); });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  std::vector<double> startup_ms;
+  std::vector<double> fps;
+  CollectSuccessful(reports, &startup_ms, &fps);
+  uint64_t loaded_rss = idle_rss;
+  for (auto& report : reports) {
+    if (report.ok) {
+      result.aggregate_fps += report.frames_per_second;
+      result.process_cpu_ms =
+          std::max(result.process_cpu_ms, report.process_cpu_ms);
+      loaded_rss = std::max(loaded_rss, report.rss_bytes);
+    }
+  }
+  result.succeeded = startup_ms.size();
+  result.startup_ms = sample::Summarize(startup_ms);
+  result.instance_fps = sample::Summarize(fps);
+  result.bytes_per_stream =
+      static_cast<double>(loaded_rss - idle_rss) / instances;
+  return result;
+}
+
+bool RunScaling(const Environment& env, const sample::PlaybackOptions& options,
+                const std::vector<int64_t>& counts,
+                std::vector<ScalingResult>* results) {
+  std::printf("%9s %7s %3s %23s %10s %12s %12s\n", "instances", "threads",
+              "ok", "startup p50/p90/max ms", "total fps", "min inst fps",
+              "MiB/stream");
+  bool all_ok = true;
+  for (int64_t count : counts) {
+    results->push_back(
+        RunInstances(env, options, static_cast<size_t>(count)));
+    const ScalingResult& result = results->back();
+    all_ok &= result.succeeded == result.instances;
+    std::printf("%9zu %7zu %3zu %7.0f/%7.0f/%7.0f %10.1f %12.1f %12.1f\n",
+                result.instances, result.render_threads, result.succeeded,
+                result.startup_ms.p50, result.startup_ms.p90,
+                result.startup_ms.max, result.aggregate_fps,
+                result.instance_fps.min, Mebibytes(result.bytes_per_stream));
+  }
+  return all_ok;
+}
+
+void WriteScalingResults(const std::vector<ScalingResult>& results,
+                         sample::JsonWriter* writer) {
+  writer->Key("scaling");
+  writer->BeginArray();
+  for (auto& result : results) {
+    writer->BeginObject();
+    writer->Key("instances");
+    writer->Uint(result.instances);
+    writer->Key("render_threads");
+    writer->Uint(result.render_threads);
+    writer->Key("succeeded");
+    writer->Uint(result.succeeded);
+    writer->Key("startup_ms");
+    sample::WriteSummary(result.startup_ms, writer);
+    writer->Key("instance_fps");
+    sample::WriteSummary(result.instance_fps, writer);
+    writer->Key("aggregate_fps");
+    writer->Number(result.aggregate_fps);
+    writer->Key("bytes_per_stream");
+    writer->Number(result.bytes_per_stream);
+    writer->Key("process_cpu_ms");
+    writer->Number(result.process_cpu_ms);
+    writer->EndObject();
+  }
+  writer->EndArray();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sample::Flags flags(argc, argv);
+  sample::PlaybackOptions options;
+  options.manifest_uri = flags.GetString(
+      "manifest", flags.positional().empty() ? "" : flags.positional()[0]);
+  options.play_seconds = flags.GetDouble("play-seconds", 10);
+  options.playback_rate = flags.GetDouble("rate", 1);
+  options.startup_timeout_seconds = flags.GetDouble("startup-timeout", 30);
+  const std::string handoff = flags.GetString("frame-handoff", "zero-copy");
+  const int64_t runs = flags.GetInt("runs", 1);
+  const std::string instances = flags.GetString("instances", "");
+  const int64_t render_threads = flags.GetInt("render-threads", 0);
+  const std::string json_path = flags.GetString("json", "");
+  const std::string serve_dir = flags.GetString("serve", "");
+  const int64_t cache_mb = flags.GetInt("segment-cache-mb", 0);
+  const int64_t prefetch = flags.GetInt("prefetch", 0);
+  const int64_t buffer_budget_mb = flags.GetInt("buffer-budget-mb", 0);
+  const std::string record_path = flags.GetString("record", "");
+  const std::string replay_path = flags.GetString("replay", "");
+  const double replay_speed = flags.GetDouble("replay-speed", 4);
+  const bool stage_timings = flags.GetBool("stage-timings", false);
+  const bool compare_fast_start = flags.GetBool("compare-fast-start", false);
+  options.fast_start = flags.GetBool("fast-start", false);
+  options.bandwidth_estimate = flags.GetDouble(
+      "bandwidth-estimate", sample::kDefaultBandwidthEstimate);
+  const std::string seek_pattern = flags.GetString("seek", "");
+  const std::string seek_mode = flags.GetString("seek-mode", "exact");
+  sample::SeekOptions seek_options;
+  const int64_t seeks = flags.GetInt("seeks", 50);
+  seek_options.scrub_step_seconds = flags.GetDouble("scrub-step", 0.5);
+  seek_options.scrub_interval_ms = flags.GetDouble("scrub-interval-ms", 100);
+  seek_options.timeout_seconds = flags.GetDouble("seek-timeout", 10);
+  const int64_t seek_seed = flags.GetInt("seek-seed", 1);
+
+  shaka::JsManager::StartupOptions startup;
+  startup.static_data_dir =
+      flags.GetString("static-data-dir", SAMPLE_SHAKA_DATA_DIR);
+  startup.dynamic_data_dir = flags.GetString("dynamic-data-dir", "shaka_data");
+  startup.is_static_relative_to_bundle = false;
+
+  std::string error;
+  sample::NetworkConditions conditions;
+  std::vector<int64_t> instance_counts;
+  if (!sample::ParseFrameHandoff(handoff, &options.frame_handoff))
+    error = "--frame-handoff must be 'copy' or 'zero-copy'";
+  if (!instances.empty() && !ParseCounts(instances, &instance_counts))
+    error = "--instances expects a comma-separated list of counts";
+  if (compare_fast_start && (!instance_counts.empty() || options.fast_start))
+    error = "--compare-fast-start runs its own sessions";
+  std::vector<sample::SeekMode> seek_modes;
+  if (seek_mode == "both") {
+    seek_modes = {sample::SeekMode::kExact, sample::SeekMode::kKeyframe};
+  } else {
+    seek_modes.resize(1);
+    if (!sample::ParseSeekMode(seek_mode, &seek_modes[0]))
+      error = "--seek-mode must be 'exact', 'keyframe' or 'both'";
+  }
+  if (!seek_pattern.empty()) {
+    if (!sample::ParseSeekPattern(seek_pattern, &seek_options.pattern))
+      error = "--seek must be 'random' or 'scrub'";
+    else if (compare_fast_start || !instance_counts.empty())
+      error = "--seek runs its own sessions";
+  }
+  if (!record_path.empty() &&
+      (!replay_path.empty() || runs != 1 || !instance_counts.empty() ||
+       compare_fast_start || options.fast_start || cache_mb > 0 ||
+       seek_modes.size() != 1)) {
+    error = "--record records a single session straight from the origin";
+  }
+  if (!replay_path.empty() &&
+      (!serve_dir.empty() || !instance_counts.empty() || compare_fast_start ||
+       !seek_pattern.empty())) {
+    error = "--replay plays sequential sessions from the trace alone";
+  }
+  if (!replay_path.empty() &&
+      (flags.Has("rate") || flags.Has("bandwidth-estimate"))) {
+    error = "--replay takes the playback rate and bandwidth estimate from "
+            "the trace";
+  }
+  if (!error.empty() ||
+      !sample::NetworkConditionsFromFlags(flags, &conditions, &error) ||
+      !flags.Validate(&error) ||
+      (options.manifest_uri.empty() && replay_path.empty()) || runs < 1 ||
+      render_threads < 0 || cache_mb < 0 || prefetch < 0 ||
+      buffer_budget_mb < 0 ||
+      options.bandwidth_estimate <= 0 || seeks < 1 || seek_seed < 0 ||
+      seek_options.scrub_step_seconds <= 0 ||
+      seek_options.scrub_interval_ms <= 0 ||
+      seek_options.timeout_seconds <= 0 || replay_speed <= 0) {
+    if (!error.empty())
+      std::cerr << error << "\n\n";
+    std::cerr << kUsage << sample::kNetworkConditionsUsage;
+    return 1;
+  }
+  seek_options.count = static_cast<size_t>(seeks);
+  seek_options.seed = static_cast<uint32_t>(seek_seed);
+  mkdir(startup.dynamic_data_dir.c_str(), 0755);
+
+  std::unique_ptr<sample::LocalMediaServer> server;
+  if (!serve_dir.empty()) {
+    server.reset(new sample::LocalMediaServer(serve_dir, conditions));
+    if (!server->Start(0, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    options.manifest_uri = server->ResolveUrl(options.manifest_uri);
+  }
+
+  // A replay needs no origin: the trace answers every request.
+  sample::SessionTrace replay_trace;
+  std::unique_ptr<sample::TraceReplayer> replayer;
+  std::unique_ptr<sample::HttpServer> replay_server;
+  if (!replay_path.empty()) {
+    if (!sample::ReadTrace(replay_path, &replay_trace, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    replayer.reset(new sample::TraceReplayer(&replay_trace, replay_speed));
+    replay_server.reset(new sample::HttpServer(replayer.get()));
+    if (!replay_server->Start(0, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    options.manifest_uri =
+        replay_server->BaseUrl() + replay_trace.manifest_target;
+    options.playback_rate = replay_trace.playback_rate * replay_speed;
+    options.bandwidth_estimate = replay_trace.bandwidth_estimate;
+    options.replay = &replay_trace;
+    options.replay_speed = replay_speed;
+    options.replayer = replayer.get();
+  }
+
+  std::unique_ptr<sample::TraceRecorder> recorder;
+  std::unique_ptr<sample::HttpServer> record_server;
+  std::string recorded_target;
+  if (!record_path.empty()) {
+    sample::ParsedUrl url;
+    if (!sample::ParseHttpUrl(options.manifest_uri, &url)) {
+      std::cerr << "--record needs an http:// manifest\n";
+      return 1;
+    }
+    recorder.reset(new sample::TraceRecorder(
+        "http://" + url.host + ":" + std::to_string(url.port)));
+    record_server.reset(new sample::HttpServer(recorder.get()));
+    if (!record_server->Start(0, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    recorded_target = url.target;
+    options.manifest_uri = record_server->BaseUrl() + url.target;
+    options.recorder = recorder.get();
+  }
+
+  sample::CachingProxyOptions proxy_options;
+  if (cache_mb > 0)
+    proxy_options.byte_budget = static_cast<uint64_t>(cache_mb) * 1024 * 1024;
+  proxy_options.prefetch_count = static_cast<size_t>(prefetch);
+
+  // The proxy outlives every session so later runs are served from the cache.
+  // Comparisons start a fresh one per session instead.
+  ProxyEndpoint proxy;
+  if (!compare_fast_start && (cache_mb > 0 || options.fast_start)) {
+    if (!StartProxy(options.manifest_uri, proxy_options, &proxy, &error)) {
+      std::cerr << error << "\n";
+      return 1;
+    }
+    options.manifest_uri = proxy.manifest_uri;
+    options.startup_proxy = proxy.proxy.get();
+  }
+
+  // Fast start's warm-up demuxes with the SDK's own factory, so it is neither
+  // timed nor held in the arena.
+  options.warm_up_demuxers = shaka::media::DemuxerFactory::GetFactory();
+
+  // Installed before the timing factory so copying into the arena is timed
+  // as part of demuxing.  The arena outlives the engine and every sample.
+  std::unique_ptr<sample::SampleArena> arena;
+  std::unique_ptr<sample::PooledDemuxerFactory> pooled_demuxers;
+  if (buffer_budget_mb > 0) {
+    options.buffer_budget_bytes =
+        static_cast<uint64_t>(buffer_budget_mb) * 1024 * 1024;
+    arena.reset(new sample::SampleArena(options.buffer_budget_bytes));
+    pooled_demuxers = sample::PooledDemuxerFactory::Install(arena.get());
+  }
+
+  // Enabled before any player exists, since players only install their
+  // timing hooks when it is on.
+  std::unique_ptr<sample::TimingDemuxerFactory> timing_demuxers;
+  if (stage_timings) {
+    sample::EnableStageTimings(true);
+    timing_demuxers = sample::TimingDemuxerFactory::Install();
+  }
+
+  shaka::JsManager engine(startup);
+  Environment env;
+  env.engine = &engine;
+  env.server = server.get();
+  env.proxy = proxy.proxy.get();
+  env.arena = arena.get();
+  env.replayer = replayer.get();
+  env.render_threads = render_threads;
+
+  bool ok;
+  std::function<void(sample::JsonWriter*)> write_results;
+  std::vector<sample::PlaybackReport> reports;
+  std::vector<sample::PlaybackReport> fast_reports;
+  std::vector<ScalingResult> scaling;
+  std::vector<sample::SeekReport> seek_reports;
+  if (!seek_pattern.empty()) {
+    ok = RunSeekBenchmark(env, options, seek_options, seek_modes, runs,
+                          &seek_reports);
+    write_results = [&](sample::JsonWriter* writer) {
+      WriteSeekResults(seek_reports, writer);
+    };
+  } else if (compare_fast_start) {
+    ok = RunComparison(env, options, proxy_options, runs, &reports,
+                       &fast_reports);
+    write_results = [&](sample::JsonWriter* writer) {
+      WriteComparisonResults(reports, fast_reports, writer);
+    };
+  } else if (instance_counts.empty()) {
+    ok = RunSequential(env, options, runs, &reports);
+    write_results = [&](sample::JsonWriter* writer) {
+      WriteSequentialResults(reports, writer);
+    };
+  } else {
+    ok = RunScaling(env, options, instance_counts, &scaling);
+    write_results = [&](sample::JsonWriter* writer) {
+      WriteScalingResults(scaling, writer);
+    };
+  }
+
+  std::printf("peak RSS: %.1f MiB\n", Mebibytes(sample::PeakRssBytes()));
+  if (server) {
+    const sample::NetworkStats stats = server->stats();
+    std::printf("network: %llu requests, %llu failed, %.1f MiB sent\n",
+                static_cast<unsigned long long>(stats.requests),
+                static_cast<unsigned long long>(stats.failures),
+                Mebibytes(stats.bytes_sent));
+  }
+  if (env.proxy)
+    PrintCacheStats(*env.proxy);
+  if (env.arena)
+    PrintArenaStats(*env.arena);
+  if (env.replayer)
+    PrintReplayStats(*env.replayer);
+  if (recorder) {
+    sample::SessionTrace trace = recorder->Finish();
+    trace.manifest_target = recorded_target;
+    trace.playback_rate = options.playback_rate;
+    trace.bandwidth_estimate = options.bandwidth_estimate;
+    if (sample::WriteTrace(trace, record_path, &error)) {
+      std::printf("recorded %zu responses and %zu events over %.1f s to %s\n",
+                  trace.responses.size(), trace.events.size(),
+                  trace.duration_us / 1e6, record_path.c_str());
+    } else {
+      std::cerr << error << "\n";
+      ok = false;
+    }
+  }
+  if (stage_timings)
+    std::printf("stage timings:\n%s", sample::FormatStageTimings().c_str());
+
+  if (!json_path.empty() && !WriteJson(json_path, env, write_results)) {
+    std::cerr << "Unable to write " << json_path << "\n";
+    ok = false;
+  }
+
+  engine.Stop();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+// Measures what the stage timers cost: a small fixed workload is timed bare,
+// wrapped in a ScopedStageTimer while timings are disabled, and wrapped while
+// they are enabled, on 1..N threads recording into the same histogram.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "base/clock.h"
+#include "base/flags.h"
+#include "base/json_writer.h"
+#include "base/stage_timings.h"
+
+namespace {
+
+constexpr const char kUsage[] =
+    "Usage: instrumentation_overhead [options]\n"
+    "\n"
+    "  --iterations=N  Timed operations per thread (default 2000000)\n"
+    "  --work=N        Dependent multiply-adds per operation (default 64)\n"
+    "  --threads=N     Highest thread count; doubles from 1 (default CPUs)\n"
+    "  --repeats=N     Best of N measurements per cell (default 5)\n"
+    "  --json=PATH     Also write the results as JSON ('-' = stdout)\n";
+
+enum class Mode { kBare, kDisabled, kEnabled };
+
+/** Stands in for the work a stage does, so the timer is not all that runs. */
+inline uint64_t Work(uint64_t x, int64_t work) {
+  for (int64_t i = 0; i < work; i++) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    asm volatile("" : "+r"(x));
+  }
+  return x;
+}
+
+template <bool kTimed>
+uint64_t Spin(uint64_t iterations, int64_t work) {
+  uint64_t x = 1;
+  for (uint64_t i = 0; i < iterations; i++) {
+    if (kTimed) {
+      sample::ScopedStageTimer timer(sample::Stage::kDecode);
+      x = Work(x, work);
+    } else {
+      x = Work(x, work);
+    }
+  }
+  return x;
+}
+
+/** Returns the mean wall time of one operation across |threads| threads. */
+double NanosecondsPerOperation(Mode mode, size_t threads, uint64_t iterations,
+                               int64_t work) {
+  sample::EnableStageTimings(mode == Mode::kEnabled);
+  std::vector<double> seconds(threads);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back([&, i]() {
+      const sample::Clock::time_point start = sample::Clock::now();
+      const uint64_t x = mode == Mode::kBare ? Spin<false>(iterations, work)
+                                             : Spin<true>(iterations, work);
+      seconds[i] = std::chrono::duration<double>(sample::Clock::now() - start)
+                       .count();
+      asm volatile("" : : "r"(x));
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  sample::EnableStageTimings(false);
+
+  double total = 0;
+  for (double value : seconds)
+    total += value;
+  return total * 1e9 / (threads * iterations);
+}
+
+struct Row {
+  size_t threads = 0;
+  double bare_ns = 0;
+  double disabled_ns = 0;
+  double enabled_ns = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sample::Flags flags(argc, argv);
+  const int64_t iterations = flags.GetInt("iterations", 2000000);
+  const int64_t work = flags.GetInt("work", 64);
+  const int64_t max_threads = flags.GetInt(
+      "threads", std::max(1u, std::thread::hardware_concurrency()));
+  const int64_t repeats = flags.GetInt("repeats", 5);
+  const std::string json_path = flags.GetString("json", "");
+
+  std::string error;
+  if (!flags.Validate(&error) || iterations < 1 || work < 0 ||
+      max_threads < 1 || repeats < 1) {
+    if (!error.empty())
+      std::cerr << error << "\n\n";
+    std::cerr << kUsage;
+    return 1;
+  }
+
+  std::vector<Row> rows;
+  std::printf("%7s %12s %14s %14s %12s\n", "threads", "bare ns/op",
+              "disabled +ns", "enabled +ns", "enabled +%");
+  for (int64_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+    Row row;
+    row.threads = static_cast<size_t>(threads);
+    row.bare_ns = row.disabled_ns = row.enabled_ns = 1e300;
+    // Interleave the modes so drift in clock speed affects each alike.
+    for (int64_t i = 0; i < repeats; i++) {
+      row.bare_ns = std::min(
+          row.bare_ns,
+          NanosecondsPerOperation(Mode::kBare, row.threads, iterations, work));
+      row.disabled_ns =
+          std::min(row.disabled_ns,
+                   NanosecondsPerOperation(Mode::kDisabled, row.threads,
+                                           iterations, work));
+      row.enabled_ns =
+          std::min(row.enabled_ns,
+                   NanosecondsPerOperation(Mode::kEnabled, row.threads,
+                                           iterations, work));
+    }
+    rows.push_back(row);
+    std::printf("%7zu %12.2f %14.2f %14.2f %11.1f%%\n", row.threads,
+                row.bare_ns, row.disabled_ns - row.bare_ns,
+                row.enabled_ns - row.bare_ns,
+                100 * (row.enabled_ns - row.bare_ns) / row.bare_ns);
+    if (threads == max_threads)
+      break;
+  }
+
+  const sample::HistogramSnapshot recorded =
+      sample::StageHistogram(sample::Stage::kDecode)->Snapshot();
+  std::printf("recorded %llu samples, p50 %.0f ns, p99 %.0f ns\n",
+              static_cast<unsigned long long>(recorded.count),
+              recorded.PercentileNs(0.5), recorded.PercentileNs(0.99));
+
+  if (!json_path.empty()) {
+    std::ofstream file;
+    std::ostream* out = &std::cout;
+    if (json_path != "-") {
+      file.open(json_path);
+      out = &file;
+    }
+    sample::JsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("iterations");
+    writer.Int(iterations);
+    writer.Key("work");
+    writer.Int(work);
+    writer.Key("rows");
+    writer.BeginArray();
+    for (auto& row : rows) {
+      writer.BeginObject();
+      writer.Key("threads");
+      writer.Uint(row.threads);
+      writer.Key("bare_ns");
+      writer.Number(row.bare_ns);
+      writer.Key("disabled_ns");
+      writer.Number(row.disabled_ns);
+      writer.Key("enabled_ns");
+      writer.Number(row.enabled_ns);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.Key("recorded");
+    sample::WriteHistogram(recorded, &writer);
+    writer.EndObject();
+    *out << "\n";
+    out->flush();
+    if (!*out) {
+      std::cerr << "Unable to write " << json_path << "\n";
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+// Serves a directory of generated media over loopback HTTP with simulated
+// latency, bandwidth limits and failures, until interrupted.
+
+#include <signal.h>
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "base/flags.h"
+#include "net/local_media_server.h"
+
+namespace {
+
+constexpr const char kUsage[] =
+    "Usage: local_media_server --root=DIR [options]\n"
+    "\n"
+    "  --port=N               Port to listen on (default 8000, 0 = any)\n";
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  sample::Flags flags(argc, argv);
+  const std::string root = flags.GetString("root", "");
+  const int64_t port = flags.GetInt("port", 8000);
+
+  std::string error;
+  sample::NetworkConditions conditions;
+  if (!sample::NetworkConditionsFromFlags(flags, &conditions, &error) ||
+      !flags.Validate(&error) || root.empty() || port < 0 || port > 65535) {
+    if (!error.empty())
+      std::cerr << error << "\n\n";
+    std::cerr << kUsage << sample::kNetworkConditionsUsage;
+    return 1;
+  }
+
+  // Block the signals before any thread starts so only sigwait() sees them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  sample::LocalMediaServer server(root, conditions);
+  if (!server.Start(static_cast<uint16_t>(port), &error)) {
+    std::cerr << error << "\n";
+    return 1;
+  }
+  std::printf("Serving %s at %s\n", root.c_str(), server.BaseUrl().c_str());
+  std::fflush(stdout);
+
+  int signal_number;
+  sigwait(&signals, &signal_number);
+  server.Stop();
+
+  const sample::NetworkStats stats = server.stats();
+  std::printf("%llu requests, %llu failed, %llu bytes sent\n",
+              static_cast<unsigned long long>(stats.requests),
+              static_cast<unsigned long long>(stats.failures),
+              static_cast<unsigned long long>(stats.bytes_sent));
+  return 0;
+}
@@ -0,0 +1,30 @@
+#ifndef SAMPLE_BASE_CLOCK_H_
+#define SAMPLE_BASE_CLOCK_H_
+
+#include <chrono>
+
+namespace sample {
+
+/** The monotonic clock used for every measurement in the sample. */
+using Clock = std::chrono::steady_clock;
+
+/** Returns the number of milliseconds from |start| to |end|. */
+inline double MillisecondsBetween(Clock::time_point start,
+                                  Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/** Returns the number of milliseconds that have passed since |start|. */
+inline double MillisecondsSince(Clock::time_point start) {
+  return MillisecondsBetween(start, Clock::now());
+}
+
+/** Converts a number of seconds to a Clock duration. */
+inline Clock::duration SecondsToDuration(double seconds) {
+  return std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(seconds));
+}
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_CLOCK_H_
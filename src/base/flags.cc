@@ -0,0 +1,105 @@
+#include "base/flags.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace sample {
+
+Flags::Flags(int argc, const char* const* argv) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg.size() <= 2 || arg.compare(0, 2, "--") != 0) {
+      positional_.push_back(arg);
+      continue;
+    }
+
+    const std::string body = arg.substr(2);
+    const size_t equals = body.find('=');
+    if (equals != std::string::npos) {
+      values_[body.substr(0, equals)] = body.substr(equals + 1);
+    } else if (body.compare(0, 3, "no-") == 0) {
+      values_[body.substr(3)] = "false";
+    } else {
+      values_[body] = "true";
+    }
+  }
+}
+
+bool Flags::Has(const std::string& name) const {
+  return Find(name) != nullptr;
+}
+
+std::string Flags::GetString(const std::string& name,
+                             const std::string& default_value) const {
+  const std::string* value = Find(name);
+  return value ? *value : default_value;
+}
+
+int64_t Flags::GetInt(const std::string& name, int64_t default_value) const {
+  const std::string* value = Find(name);
+  if (!value)
+    return default_value;
+
+  char* end = nullptr;
+  errno = 0;
+  const long long ret = std::strtoll(value->c_str(), &end, 10);
+  if (value->empty() || *end != '\0' || errno != 0) {
+    errors_.push_back("--" + name + " expects an integer, got '" + *value +
+                      "'");
+    return default_value;
+  }
+  return ret;
+}
+
+double Flags::GetDouble(const std::string& name, double default_value) const {
+  const std::string* value = Find(name);
+  if (!value)
+    return default_value;
+
+  char* end = nullptr;
+  errno = 0;
+  const double ret = std::strtod(value->c_str(), &end);
+  if (value->empty() || *end != '\0' || errno != 0) {
+    errors_.push_back("--" + name + " expects a number, got '" + *value + "'");
+    return default_value;
+  }
+  return ret;
+}
+
+bool Flags::GetBool(const std::string& name, bool default_value) const {
+  const std::string* value = Find(name);
+  if (!value)
+    return default_value;
+  if (*value == "true" || *value == "1")
+    return true;
+  if (*value == "false" || *value == "0")
+    return false;
+  errors_.push_back("--" + name + " expects true or false, got '" + *value +
+                    "'");
+  return default_value;
+}
+
+bool Flags::Validate(std::string* error) const {
+  for (auto& pair : values_) {
+    if (queried_.count(pair.first) == 0)
+      errors_.push_back("Unknown flag --" + pair.first);
+  }
+  if (errors_.empty())
+    return true;
+
+  error->clear();
+  for (auto& message : errors_) {
+    if (!error->empty())
+      error->append("\n");
+    error->append(message);
+  }
+  return false;
+}
+
+const std::string* Flags::Find(const std::string& name) const {
+  queried_.insert(name);
+  auto it = values_.find(name);
+  return it == values_.end() ? nullptr : &it->second;
+}
+
+}  // namespace sample
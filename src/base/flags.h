@@ -0,0 +1,53 @@
+#ifndef SAMPLE_BASE_FLAGS_H_
+#define SAMPLE_BASE_FLAGS_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/**
+ * A minimal command-line parser.  Flags are given as --name=value, --name
+ * (meaning true) or --no-name (meaning false); anything else is positional.
+ *
+ * Getters return the default when a flag is missing.  Malformed values and
+ * flags that are never queried are reported by Validate() so typos do not
+ * silently change a benchmark configuration.
+ */
+class Flags {
+ public:
+  Flags(int argc, const char* const* argv);
+
+  bool Has(const std::string& name) const;
+
+  std::string GetString(const std::string& name,
+                        const std::string& default_value) const;
+  int64_t GetInt(const std::string& name, int64_t default_value) const;
+  double GetDouble(const std::string& name, double default_value) const;
+  bool GetBool(const std::string& name, bool default_value) const;
+
+  const std::vector<std::string>& positional() const {
+    return positional_;
+  }
+
+  /**
+   * Returns false and fills |error| if a value failed to parse or a flag was
+   * given that no getter has asked for.  Call after reading every flag.
+   */
+  bool Validate(std::string* error) const;
+
+ private:
+  const std::string* Find(const std::string& name) const;
+
+  std::map<std::string, std::string> values_;
+  std::vector<std::string> positional_;
+  mutable std::set<std::string> queried_;
+  mutable std::vector<std::string> errors_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_FLAGS_H_
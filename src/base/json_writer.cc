@@ -0,0 +1,121 @@
+#include "base/json_writer.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace sample {
+
+JsonWriter::JsonWriter(std::ostream* out) : out_(out), after_key_(false) {}
+
+void JsonWriter::BeginObject() {
+  BeforeValue();
+  *out_ << '{';
+  has_elements_.push_back(false);
+}
+
+void JsonWriter::EndObject() {
+  has_elements_.pop_back();
+  *out_ << '}';
+}
+
+void JsonWriter::BeginArray() {
+  BeforeValue();
+  *out_ << '[';
+  has_elements_.push_back(false);
+}
+
+void JsonWriter::EndArray() {
+  has_elements_.pop_back();
+  *out_ << ']';
+}
+
+void JsonWriter::Key(const std::string& key) {
+  BeforeValue();
+  WriteEscaped(key);
+  *out_ << ':';
+  after_key_ = true;
+}
+
+void JsonWriter::String(const std::string& value) {
+  BeforeValue();
+  WriteEscaped(value);
+}
+
+void JsonWriter::Number(double value) {
+  BeforeValue();
+  // JSON has no representation for NaN or infinity.
+  if (!std::isfinite(value)) {
+    *out_ << "null";
+    return;
+  }
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+  *out_ << buffer;
+}
+
+void JsonWriter::Int(int64_t value) {
+  BeforeValue();
+  *out_ << value;
+}
+
+void JsonWriter::Uint(uint64_t value) {
+  BeforeValue();
+  *out_ << value;
+}
+
+void JsonWriter::Bool(bool value) {
+  BeforeValue();
+  *out_ << (value ? "true" : "false");
+}
+
+void JsonWriter::Null() {
+  BeforeValue();
+  *out_ << "null";
+}
+
+void JsonWriter::BeforeValue() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (!has_elements_.empty()) {
+    if (has_elements_.back())
+      *out_ << ',';
+    has_elements_.back() = true;
+  }
+}
+
+void JsonWriter::WriteEscaped(const std::string& value) {
+  *out_ << '"';
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        *out_ << "\\\"";
+        break;
+      case '\\':
+        *out_ << "\\\\";
+        break;
+      case '\n':
+        *out_ << "\\n";
+        break;
+      case '\r':
+        *out_ << "\\r";
+        break;
+      case '\t':
+        *out_ << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buffer[8];
+          std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+          *out_ << buffer;
+        } else {
+          *out_ << c;
+        }
+        break;
+    }
+  }
+  *out_ << '"';
+}
+
+}  // namespace sample
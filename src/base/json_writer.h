@@ -0,0 +1,45 @@
+#ifndef SAMPLE_BASE_JSON_WRITER_H_
+#define SAMPLE_BASE_JSON_WRITER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/**
+ * Streams compact JSON to an ostream.  Callers are responsible for balancing
+ * Begin/End calls and for calling Key() before each value inside an object.
+ */
+class JsonWriter {
+ public:
+  explicit JsonWriter(std::ostream* out);
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  void Key(const std::string& key);
+
+  void String(const std::string& value);
+  void Number(double value);
+  void Int(int64_t value);
+  void Uint(uint64_t value);
+  void Bool(bool value);
+  void Null();
+
+ private:
+  void BeforeValue();
+  void WriteEscaped(const std::string& value);
+
+  std::ostream* out_;
+  // One entry per open container: whether it already holds an element.
+  std::vector<bool> has_elements_;
+  bool after_key_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_JSON_WRITER_H_
@@ -0,0 +1,142 @@
+#include "base/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "base/json_writer.h"
+
+namespace sample {
+
+namespace {
+
+constexpr uint64_t kNoMinimum = std::numeric_limits<uint64_t>::max();
+
+int MostSignificantBit(uint64_t value) {
+  return 63 - __builtin_clzll(value);
+}
+
+}  // namespace
+
+double HistogramSnapshot::PercentileNs(double fraction) const {
+  uint64_t total = 0;
+  for (auto& bucket : buckets)
+    total += bucket.count;
+  if (total == 0)
+    return 0;
+
+  // Nearest rank, as Summarize() uses for exact samples.
+  const double rank = std::max(1.0, std::ceil(fraction * total));
+  uint64_t seen = 0;
+  for (auto& bucket : buckets) {
+    seen += bucket.count;
+    if (seen >= rank) {
+      const double mid =
+          bucket.lower_ns + (bucket.upper_ns - bucket.lower_ns) / 2.0;
+      return std::min<double>(std::max<double>(mid, min_ns), max_ns);
+    }
+  }
+  return max_ns;
+}
+
+Summary HistogramSnapshot::ToSummaryMs() const {
+  constexpr double kNsPerMs = 1e6;
+  Summary ret;
+  ret.count = count;
+  if (count == 0)
+    return ret;
+  ret.min = min_ns / kNsPerMs;
+  ret.max = max_ns / kNsPerMs;
+  ret.mean = static_cast<double>(sum_ns) / count / kNsPerMs;
+  ret.p50 = PercentileNs(0.5) / kNsPerMs;
+  ret.p90 = PercentileNs(0.9) / kNsPerMs;
+  ret.p99 = PercentileNs(0.99) / kNsPerMs;
+  return ret;
+}
+
+LatencyHistogram::LatencyHistogram() {
+  Reset();
+}
+
+void LatencyHistogram::Record(uint64_t value_ns) {
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+  buckets_[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+
+  uint64_t min = min_ns_.load(std::memory_order_relaxed);
+  while (value_ns < min &&
+         !min_ns_.compare_exchange_weak(min, value_ns,
+                                        std::memory_order_relaxed)) {
+  }
+  uint64_t max = max_ns_.load(std::memory_order_relaxed);
+  while (value_ns > max &&
+         !max_ns_.compare_exchange_weak(max, value_ns,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const {
+  HistogramSnapshot ret;
+  ret.count = count_.load(std::memory_order_relaxed);
+  ret.sum_ns = sum_ns_.load(std::memory_order_relaxed);
+  const uint64_t min = min_ns_.load(std::memory_order_relaxed);
+  ret.min_ns = min == kNoMinimum ? 0 : min;
+  ret.max_ns = max_ns_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kBucketCount; i++) {
+    const uint64_t count = buckets_[i].load(std::memory_order_relaxed);
+    if (count == 0)
+      continue;
+    HistogramBucket bucket;
+    bucket.lower_ns = BucketLowerBound(i);
+    bucket.upper_ns = i + 1 < kBucketCount
+                          ? BucketLowerBound(i + 1)
+                          : std::numeric_limits<uint64_t>::max();
+    bucket.count = count;
+    ret.buckets.push_back(bucket);
+  }
+  return ret;
+}
+
+void LatencyHistogram::Reset() {
+  count_.store(0, std::memory_order_relaxed);
+  sum_ns_.store(0, std::memory_order_relaxed);
+  min_ns_.store(kNoMinimum, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+  for (auto& bucket : buckets_)
+    bucket.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value_ns) {
+  if (value_ns < kLinearBuckets)
+    return static_cast<size_t>(value_ns);
+  const int msb = MostSignificantBit(value_ns);
+  const size_t sub = (value_ns >> (msb - 3)) & (kSubBuckets - 1);
+  return kLinearBuckets + (msb - 4) * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+  if (index < kLinearBuckets)
+    return index;
+  const size_t msb = (index - kLinearBuckets) / kSubBuckets + 4;
+  const uint64_t sub = (index - kLinearBuckets) % kSubBuckets;
+  return (kSubBuckets + sub) << (msb - 3);
+}
+
+void WriteHistogram(const HistogramSnapshot& snapshot, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("ms");
+  WriteSummary(snapshot.ToSummaryMs(), writer);
+  writer->Key("buckets");
+  writer->BeginArray();
+  for (auto& bucket : snapshot.buckets) {
+    writer->BeginArray();
+    writer->Uint(bucket.lower_ns);
+    writer->Uint(bucket.upper_ns);
+    writer->Uint(bucket.count);
+    writer->EndArray();
+  }
+  writer->EndArray();
+  writer->EndObject();
+}
+
+}  // namespace sample
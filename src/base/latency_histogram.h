@@ -0,0 +1,88 @@
+#ifndef SAMPLE_BASE_LATENCY_HISTOGRAM_H_
+#define SAMPLE_BASE_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/summary.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** A bucket of a LatencyHistogram snapshot, covering [lower, upper) ns. */
+struct HistogramBucket {
+  uint64_t lower_ns = 0;
+  uint64_t upper_ns = 0;
+  uint64_t count = 0;
+};
+
+/** A consistent-enough copy of a LatencyHistogram taken while recording. */
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t min_ns = 0;
+  uint64_t max_ns = 0;
+  /** Only the buckets that hold samples, in increasing order. */
+  std::vector<HistogramBucket> buckets;
+
+  /**
+   * Returns the value below which |fraction| of the samples fall, as the
+   * midpoint of the bucket holding it, clamped to [min_ns, max_ns].
+   */
+  double PercentileNs(double fraction) const;
+
+  /** Summarizes the snapshot in milliseconds. */
+  Summary ToSummaryMs() const;
+};
+
+/**
+ * A fixed-size, lock-free histogram of durations in nanoseconds.
+ *
+ * Values are bucketed log-linearly: exact below 16 ns, then every power of two
+ * is split into 8 buckets, so a bucket is never more than 12.5% wide.  Any
+ * thread may Record() concurrently; each sample costs a few relaxed atomic
+ * adds and never allocates or blocks.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Record(uint64_t value_ns);
+
+  /** Copies the current counters; concurrent samples may be partly seen. */
+  HistogramSnapshot Snapshot() const;
+
+  /** Clears every counter.  Must not race with Record(). */
+  void Reset();
+
+  static size_t BucketIndex(uint64_t value_ns);
+  static uint64_t BucketLowerBound(size_t index);
+
+ private:
+  static constexpr size_t kLinearBuckets = 16;
+  static constexpr size_t kSubBuckets = 8;
+  static constexpr size_t kBucketCount =
+      kLinearBuckets + (64 - 4) * kSubBuckets;
+
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_ns_;
+  std::atomic<uint64_t> min_ns_;
+  std::atomic<uint64_t> max_ns_;
+  std::atomic<uint64_t> buckets_[kBucketCount];
+};
+
+/**
+ * Writes |snapshot| as a JSON object holding a millisecond Summary and the
+ * non-empty buckets as [lower_ns, upper_ns, count] triples.
+ */
+void WriteHistogram(const HistogramSnapshot& snapshot, JsonWriter* writer);
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_LATENCY_HISTOGRAM_H_
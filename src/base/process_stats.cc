@@ -0,0 +1,59 @@
+#include "base/process_stats.h"
+
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+namespace sample {
+
+namespace {
+
+double TimevalToSeconds(const timeval& tv) {
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+}  // namespace
+
+uint64_t PeakRssBytes() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  // macOS reports bytes, Linux reports kilobytes.
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+uint64_t CurrentRssBytes() {
+  FILE* file = std::fopen("/proc/self/statm", "r");
+  if (!file)
+    return 0;
+  unsigned long long size_pages = 0;
+  unsigned long long resident_pages = 0;
+  const int count =
+      std::fscanf(file, "%llu %llu", &size_pages, &resident_pages);
+  std::fclose(file);
+  if (count != 2)
+    return 0;
+  return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+double ProcessCpuSeconds() {
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return TimevalToSeconds(usage.ru_utime) + TimevalToSeconds(usage.ru_stime);
+}
+
+double ThreadCpuSeconds() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0;
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}  // namespace sample
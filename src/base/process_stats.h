@@ -0,0 +1,22 @@
+#ifndef SAMPLE_BASE_PROCESS_STATS_H_
+#define SAMPLE_BASE_PROCESS_STATS_H_
+
+#include <cstdint>
+
+namespace sample {
+
+/** Returns the peak resident set size of this process, in bytes. */
+uint64_t PeakRssBytes();
+
+/** Returns the current resident set size of this process, or 0 if unknown. */
+uint64_t CurrentRssBytes();
+
+/** Returns the user + system CPU time this process has used, in seconds. */
+double ProcessCpuSeconds();
+
+/** Returns the CPU time the calling thread has used, in seconds. */
+double ThreadCpuSeconds();
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_PROCESS_STATS_H_
@@ -0,0 +1,81 @@
+#include "base/stage_timings.h"
+
+#include <cstdio>
+
+#include "base/json_writer.h"
+
+namespace sample {
+
+namespace internal {
+std::atomic<bool> g_stage_timings_enabled{false};
+}  // namespace internal
+
+namespace {
+
+LatencyHistogram g_histograms[kStageCount];
+
+}  // namespace
+
+const char* StageName(Stage stage) {
+  switch (stage) {
+    case Stage::kManifestFetch:
+      return "manifest_fetch";
+    case Stage::kManifestParse:
+      return "manifest_parse";
+    case Stage::kSegmentFetch:
+      return "segment_fetch";
+    case Stage::kDemux:
+      return "demux";
+    case Stage::kDecode:
+      return "decode";
+    case Stage::kRender:
+      return "render";
+  }
+  return "unknown";
+}
+
+void EnableStageTimings(bool enabled) {
+  internal::g_stage_timings_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+LatencyHistogram* StageHistogram(Stage stage) {
+  return &g_histograms[static_cast<size_t>(stage)];
+}
+
+void ResetStageTimings() {
+  for (auto& histogram : g_histograms)
+    histogram.Reset();
+}
+
+std::string FormatStageTimings() {
+  std::string ret;
+  for (size_t i = 0; i < kStageCount; i++) {
+    const Stage stage = static_cast<Stage>(i);
+    const HistogramSnapshot snapshot = StageHistogram(stage)->Snapshot();
+    if (snapshot.count == 0)
+      continue;
+    // Render and decode samples are well under a millisecond, so use more
+    // precision than FormatSummary().
+    const Summary summary = snapshot.ToSummaryMs();
+    char line[256];
+    std::snprintf(line, sizeof(line),
+                  "  %-15s n=%-7zu p50=%9.3f p90=%9.3f p99=%9.3f "
+                  "max=%9.3f mean=%9.3f ms\n",
+                  StageName(stage), summary.count, summary.p50, summary.p90,
+                  summary.p99, summary.max, summary.mean);
+    ret += line;
+  }
+  return ret;
+}
+
+void WriteStageTimings(JsonWriter* writer) {
+  writer->BeginObject();
+  for (size_t i = 0; i < kStageCount; i++) {
+    const Stage stage = static_cast<Stage>(i);
+    writer->Key(StageName(stage));
+    WriteHistogram(StageHistogram(stage)->Snapshot(), writer);
+  }
+  writer->EndObject();
+}
+
+}  // namespace sample
@@ -0,0 +1,97 @@
+#ifndef SAMPLE_BASE_STAGE_TIMINGS_H_
+#define SAMPLE_BASE_STAGE_TIMINGS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+#include "base/clock.h"
+#include "base/latency_histogram.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** The timed stages of the playback pipeline. */
+enum class Stage {
+  /** From the manifest request until its response arrived. */
+  kManifestFetch,
+  /** From the manifest response until the first segment was requested. */
+  kManifestParse,
+  /** From a segment request until its response arrived. */
+  kSegmentFetch,
+  /** One Demuxer::Demux() call over an appended segment. */
+  kDemux,
+  /** One Decoder::Decode() call over an encoded frame. */
+  kDecode,
+  /** Presenting one frame on the render thread. */
+  kRender,
+};
+
+constexpr size_t kStageCount = 6;
+
+/** Returns the snake_case name used for |stage| in reports. */
+const char* StageName(Stage stage);
+
+namespace internal {
+extern std::atomic<bool> g_stage_timings_enabled;
+}  // namespace internal
+
+/**
+ * Turns recording on or off for the whole process.  Off by default; while off
+ * every timer costs one relaxed atomic load and reads no clock.
+ */
+void EnableStageTimings(bool enabled);
+
+inline bool StageTimingsEnabled() {
+  return internal::g_stage_timings_enabled.load(std::memory_order_relaxed);
+}
+
+/** Returns the process-wide histogram for |stage|. */
+LatencyHistogram* StageHistogram(Stage stage);
+
+/** Records |duration| for |stage| if recording is enabled. */
+inline void RecordStage(Stage stage, Clock::duration duration) {
+  if (!StageTimingsEnabled())
+    return;
+  const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+  StageHistogram(stage)->Record(ns < 0 ? 0 : static_cast<uint64_t>(ns));
+}
+
+/** Records the lifetime of the object for a stage. */
+class ScopedStageTimer {
+ public:
+  explicit ScopedStageTimer(Stage stage)
+      : stage_(stage), enabled_(StageTimingsEnabled()) {
+    if (enabled_)
+      start_ = Clock::now();
+  }
+
+  ~ScopedStageTimer() {
+    if (enabled_)
+      RecordStage(stage_, Clock::now() - start_);
+  }
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+ private:
+  const Stage stage_;
+  const bool enabled_;
+  Clock::time_point start_;
+};
+
+/** Clears every stage histogram.  Must not race with recording. */
+void ResetStageTimings();
+
+/** Formats one line per stage that has samples. */
+std::string FormatStageTimings();
+
+/** Writes an object holding a histogram per stage, keyed by StageName(). */
+void WriteStageTimings(JsonWriter* writer);
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_STAGE_TIMINGS_H_
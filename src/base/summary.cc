@@ -0,0 +1,71 @@
+#include "base/summary.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+#include "base/json_writer.h"
+
+namespace sample {
+
+namespace {
+
+/** Nearest-rank percentile over sorted, non-empty |sorted|. */
+double Percentile(const std::vector<double>& sorted, double percent) {
+  const double rank = std::ceil(percent / 100 * sorted.size());
+  const size_t index = rank < 1 ? 0 : static_cast<size_t>(rank) - 1;
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}  // namespace
+
+Summary Summarize(std::vector<double> samples) {
+  Summary ret;
+  if (samples.empty())
+    return ret;
+
+  std::sort(samples.begin(), samples.end());
+  ret.count = samples.size();
+  ret.min = samples.front();
+  ret.max = samples.back();
+  ret.mean =
+      std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+  ret.p50 = Percentile(samples, 50);
+  ret.p90 = Percentile(samples, 90);
+  ret.p99 = Percentile(samples, 99);
+  return ret;
+}
+
+std::string FormatSummary(const Summary& summary, const std::string& unit) {
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer),
+                "n=%zu min=%.1f%s p50=%.1f%s p90=%.1f%s p99=%.1f%s "
+                "max=%.1f%s mean=%.1f%s",
+                summary.count, summary.min, unit.c_str(), summary.p50,
+                unit.c_str(), summary.p90, unit.c_str(), summary.p99,
+                unit.c_str(), summary.max, unit.c_str(), summary.mean,
+                unit.c_str());
+  return buffer;
+}
+
+void WriteSummary(const Summary& summary, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("count");
+  writer->Uint(summary.count);
+  writer->Key("min");
+  writer->Number(summary.min);
+  writer->Key("mean");
+  writer->Number(summary.mean);
+  writer->Key("p50");
+  writer->Number(summary.p50);
+  writer->Key("p90");
+  writer->Number(summary.p90);
+  writer->Key("p99");
+  writer->Number(summary.p99);
+  writer->Key("max");
+  writer->Number(summary.max);
+  writer->EndObject();
+}
+
+}  // namespace sample
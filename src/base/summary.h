@@ -0,0 +1,34 @@
+#ifndef SAMPLE_BASE_SUMMARY_H_
+#define SAMPLE_BASE_SUMMARY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+class JsonWriter;
+
+/** Order statistics over a set of samples, e.g. per-run startup times. */
+struct Summary {
+  size_t count = 0;
+  double min = 0;
+  double mean = 0;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+  double max = 0;
+};
+
+/** Computes a Summary of |samples|.  An empty input gives a zeroed Summary. */
+Summary Summarize(std::vector<double> samples);
+
+/** Formats |summary| as a single human-readable line with the given unit. */
+std::string FormatSummary(const Summary& summary, const std::string& unit);
+
+/** Writes |summary| as a JSON object. */
+void WriteSummary(const Summary& summary, JsonWriter* writer);
+
+}  // namespace sample
+
+#endif  // SAMPLE_BASE_SUMMARY_H_
@@ -0,0 +1,282 @@
+#include "media/abr_simulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+
+#include "base/json_writer.h"
+#include "media/bandwidth_estimator.h"
+
+namespace sample {
+
+namespace {
+
+/** Mean-reversion rate and volatility of the synthetic log bandwidth. */
+constexpr double kSyntheticReversion = 0.1;
+constexpr double kSyntheticVolatility = 0.25;
+/** Chance per second of a synthetic outage, and its depth. */
+constexpr double kSyntheticDropChance = 0.02;
+constexpr double kSyntheticDropFactor = 0.1;
+
+/**
+ * A position in a BandwidthTrace that only moves forward, wrapping to the
+ * start at the end so sessions may outlast their trace.
+ */
+class TraceCursor {
+ public:
+  explicit TraceCursor(const BandwidthTrace& trace) : trace_(trace) {}
+
+  /** Moves |seconds| ahead. */
+  void Advance(double seconds) {
+    while (seconds > 0) {
+      const double remaining = trace_.steps[step_].seconds - offset_;
+      if (seconds < remaining) {
+        offset_ += seconds;
+        return;
+      }
+      seconds -= remaining;
+      NextStep();
+    }
+  }
+
+  /** Moves ahead until |bits| have been carried and returns the time taken. */
+  double Transfer(double bits) {
+    double seconds = 0;
+    while (true) {
+      const BandwidthTrace::Step& step = trace_.steps[step_];
+      const double remaining = step.seconds - offset_;
+      if (step.bits_per_second > 0 &&
+          bits <= step.bits_per_second * remaining) {
+        const double needed = bits / step.bits_per_second;
+        offset_ += needed;
+        return seconds + needed;
+      }
+      bits -= step.bits_per_second * remaining;
+      seconds += remaining;
+      NextStep();
+    }
+  }
+
+ private:
+  void NextStep() {
+    offset_ = 0;
+    if (++step_ == trace_.steps.size())
+      step_ = 0;
+  }
+
+  const BandwidthTrace& trace_;
+  size_t step_ = 0;
+  double offset_ = 0;
+};
+
+/** The first representation with listed segments, preferring video. */
+const Representation* FindSegmentedRepresentation(const Manifest& manifest) {
+  const Representation* found = nullptr;
+  for (auto& rep : manifest.representations) {
+    if (rep.segments.empty())
+      continue;
+    if (rep.type == StreamType::kVideo)
+      return &rep;
+    if (!found)
+      found = &rep;
+  }
+  return found;
+}
+
+}  // namespace
+
+bool ParseBandwidthTrace(const std::string& name, const std::string& text,
+                         BandwidthTrace* trace, std::string* error) {
+  trace->name = name;
+  trace->steps.clear();
+  double total_bits = 0;
+  std::istringstream lines(text);
+  std::string line;
+  for (size_t number = 1; std::getline(lines, line); number++) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    BandwidthTrace::Step step;
+    double kbps;
+    if (!(fields >> step.seconds)) {
+      if (line.find_first_not_of(" \t\r") == std::string::npos)
+        continue;
+    } else if (fields >> kbps && step.seconds > 0 && kbps >= 0) {
+      std::string rest;
+      if (!(fields >> rest)) {
+        step.bits_per_second = kbps * 1000;
+        total_bits += step.seconds * step.bits_per_second;
+        trace->steps.push_back(step);
+        continue;
+      }
+    }
+    *error = name + ":" + std::to_string(number) +
+             ": expected '<seconds> <kbit/s>'";
+    return false;
+  }
+  if (total_bits <= 0) {
+    *error = name + ": trace carries no bandwidth";
+    return false;
+  }
+  return true;
+}
+
+BandwidthTrace SyntheticBandwidthTrace(uint32_t seed, double seconds,
+                                       double mean_bps) {
+  BandwidthTrace trace;
+  trace.name = "synthetic-" + std::to_string(seed);
+  std::mt19937 random(seed);
+  std::normal_distribution<double> noise(0, kSyntheticVolatility);
+  std::uniform_real_distribution<double> chance(0, 1);
+  const double mean = std::log(mean_bps);
+  double level = mean;
+  const size_t count = std::max<size_t>(1, static_cast<size_t>(seconds));
+  for (size_t i = 0; i < count; i++) {
+    level += kSyntheticReversion * (mean - level) + noise(random);
+    BandwidthTrace::Step step;
+    step.seconds = 1;
+    step.bits_per_second = std::exp(level);
+    if (chance(random) < kSyntheticDropChance)
+      step.bits_per_second *= kSyntheticDropFactor;
+    trace.steps.push_back(step);
+  }
+  return trace;
+}
+
+bool ContentFromManifest(const Manifest& manifest, SimulatedContent* content,
+                         std::string* error) {
+  if (manifest.variants.empty()) {
+    *error = "No variants in " + manifest.url;
+    return false;
+  }
+  content->variants = manifest.variants;
+  std::stable_sort(content->variants.begin(), content->variants.end(),
+                   [](const Variant& a, const Variant& b) {
+                     return a.bandwidth < b.bandwidth;
+                   });
+
+  // HLS media playlists are not loaded, so their segments may be unknown;
+  // the defaults stand in then.
+  const Representation* rep = FindSegmentedRepresentation(manifest);
+  if (rep) {
+    const double span = rep->segments.back().end - rep->segments[0].start;
+    if (span > 0) {
+      content->segment_seconds = span / rep->segments.size();
+      content->duration = span;
+    }
+  }
+  if (manifest.duration > 0)
+    content->duration = manifest.duration;
+  return true;
+}
+
+void WriteSimulationResult(const SimulationResult& result,
+                           JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("trace");
+  writer->String(result.trace);
+  writer->Key("average_bitrate");
+  writer->Number(result.average_bitrate);
+  writer->Key("switches");
+  writer->Uint(result.switches);
+  writer->Key("startup_seconds");
+  writer->Number(result.startup_seconds);
+  writer->Key("stalls");
+  writer->Uint(result.stalls);
+  writer->Key("stall_seconds");
+  writer->Number(result.stall_seconds);
+  writer->Key("session_seconds");
+  writer->Number(result.session_seconds);
+  writer->EndObject();
+}
+
+SimulationResult SimulateSession(const SimulatedContent& content,
+                                 const BandwidthTrace& trace,
+                                 const AbrConfig& config) {
+  SimulationResult result;
+  result.trace = trace.name;
+  if (content.variants.empty() || trace.steps.empty() ||
+      content.segment_seconds <= 0 || content.duration <= 0) {
+    return result;
+  }
+
+  TraceCursor cursor(trace);
+  BandwidthEstimator estimator;
+  const double rtt = config.rtt_ms / 1000;
+  size_t variant = ChooseVariant(
+      content.variants, config.default_bandwidth_estimate,
+      config.upgrade_target, config.downgrade_target);
+  size_t previous_variant = variant;
+  bool startup_complete = false;
+  double last_chosen = 0;
+
+  double now = 0;
+  double buffered = 0;
+  bool playing = false;
+  bool started = false;
+  double stall_start = 0;
+  double bits_played = 0;
+
+  const size_t segments = static_cast<size_t>(
+      std::ceil(content.duration / content.segment_seconds - 1e-9));
+  for (size_t i = 0; i < segments; i++) {
+    // Wait for playback to drain the buffer below the goal.
+    if (playing && buffered >= config.buffering_goal) {
+      const double idle = buffered - config.buffering_goal;
+      cursor.Advance(idle);
+      now += idle;
+      buffered -= idle;
+    }
+
+    const double remaining = content.duration - i * content.segment_seconds;
+    const double length = std::min(content.segment_seconds, remaining);
+    const double bits = content.variants[variant].bandwidth * length;
+    cursor.Advance(rtt);
+    const double elapsed = rtt + cursor.Transfer(bits);
+    if (playing && elapsed > buffered) {
+      playing = false;
+      stall_start = now + buffered;
+      result.stalls++;
+      buffered = 0;
+    } else if (playing) {
+      buffered -= elapsed;
+    }
+    now += elapsed;
+    buffered += length;
+    bits_played += bits;
+    if (variant != previous_variant)
+      result.switches++;
+    previous_variant = variant;
+
+    if (!playing &&
+        (buffered >= config.rebuffering_goal || i + 1 == segments)) {
+      playing = true;
+      if (started) {
+        result.stall_seconds += now - stall_start;
+      } else {
+        started = true;
+        result.startup_seconds = now;
+      }
+    }
+
+    estimator.Sample(elapsed * 1000, static_cast<uint64_t>(bits / 8));
+    if (!startup_complete) {
+      if (!estimator.HasGoodEstimate())
+        continue;
+      startup_complete = true;
+    } else if (now - last_chosen < config.switch_interval) {
+      continue;
+    }
+    last_chosen = now;
+    variant = ChooseVariant(
+        content.variants,
+        estimator.Estimate(config.default_bandwidth_estimate),
+        config.upgrade_target, config.downgrade_target);
+  }
+
+  result.average_bitrate = bits_played / content.duration;
+  result.session_seconds = now + buffered;
+  return result;
+}
+
+}  // namespace sample
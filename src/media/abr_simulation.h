@@ -0,0 +1,100 @@
+#ifndef SAMPLE_MEDIA_ABR_SIMULATION_H_
+#define SAMPLE_MEDIA_ABR_SIMULATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** Available bandwidth over time, as consecutive constant steps. */
+struct BandwidthTrace {
+  struct Step {
+    double seconds = 0;
+    double bits_per_second = 0;
+  };
+
+  std::string name;
+  std::vector<Step> steps;
+};
+
+/**
+ * Parses a bandwidth trace: one "<seconds> <kbit/s>" step per line, with '#'
+ * starting a comment.  The trace must carry some bandwidth.
+ */
+bool ParseBandwidthTrace(const std::string& name, const std::string& text,
+                         BandwidthTrace* trace, std::string* error);
+
+/**
+ * Returns a trace of one-second steps that wanders around |mean_bps| the
+ * way a mobile link does: a log-normal random walk with occasional deep
+ * drops.  The same seed gives the same trace.
+ */
+BandwidthTrace SyntheticBandwidthTrace(uint32_t seed, double seconds,
+                                       double mean_bps);
+
+/** What is streamed: a ladder of constant bit rate variants. */
+struct SimulatedContent {
+  /** Sorted by increasing bandwidth. */
+  std::vector<Variant> variants;
+  double segment_seconds = 4;
+  double duration = 600;
+};
+
+/** Builds content from |manifest|'s variants and listed segments. */
+bool ContentFromManifest(const Manifest& manifest, SimulatedContent* content,
+                         std::string* error);
+
+/** The ABR and buffering settings under test, with Shaka's defaults. */
+struct AbrConfig {
+  double default_bandwidth_estimate = kDefaultBandwidthEstimate;
+  double switch_interval = 8;
+  double upgrade_target = kDefaultBandwidthUpgradeTarget;
+  double downgrade_target = kDefaultBandwidthDowngradeTarget;
+  double buffering_goal = 10;
+  double rebuffering_goal = 2;
+  /** Round-trip time added to every segment request, in milliseconds. */
+  double rtt_ms = 50;
+};
+
+/** The outcome of one simulated session. */
+struct SimulationResult {
+  std::string trace;
+  /** Mean bit rate of the media played, weighted by duration. */
+  double average_bitrate = 0;
+  /** Variant changes between consecutive segments. */
+  size_t switches = 0;
+  /** Time until playback first started. */
+  double startup_seconds = 0;
+  /** Stalls after playback started, and their total length. */
+  size_t stalls = 0;
+  double stall_seconds = 0;
+  /** Simulated wall-clock length of the session. */
+  double session_seconds = 0;
+};
+
+void WriteSimulationResult(const SimulationResult& result, JsonWriter* writer);
+
+/**
+ * Streams |content| over |trace|, repeated as needed, in simulated time with
+ * nothing fetched or decoded.
+ *
+ * Segments are requested one at a time while less than the buffering goal
+ * is buffered.  Playback starts, and resumes after a stall, once the
+ * rebuffering goal is buffered.  After each segment the download feeds a
+ * BandwidthEstimator and the variant is chosen again the way Shaka Player's
+ * SimpleAbrManager does: first once the estimate is good, then at most every
+ * switch interval.  A new variant applies from the next segment.
+ */
+SimulationResult SimulateSession(const SimulatedContent& content,
+                                 const BandwidthTrace& trace,
+                                 const AbrConfig& config);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_ABR_SIMULATION_H_
@@ -0,0 +1,63 @@
+#include "media/bandwidth_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sample {
+
+namespace {
+
+/** Half-lives, in seconds of sampled download time. */
+constexpr double kFastHalfLife = 2;
+constexpr double kSlowHalfLife = 5;
+/** Smaller downloads say more about latency than bandwidth; ignored. */
+constexpr uint64_t kMinSampleBytes = 16000;
+/** Bytes to sample before the estimate replaces the default. */
+constexpr uint64_t kMinTotalBytes = 128000;
+
+}  // namespace
+
+Ewma::Ewma(double half_life)
+    : alpha_(std::exp(std::log(0.5) / half_life)),
+      estimate_(0),
+      total_weight_(0) {}
+
+void Ewma::Sample(double weight, double value) {
+  const double adjusted_alpha = std::pow(alpha_, weight);
+  const double estimate = value * (1 - adjusted_alpha) +
+                          adjusted_alpha * estimate_;
+  if (!std::isnan(estimate)) {
+    estimate_ = estimate;
+    total_weight_ += weight;
+  }
+}
+
+double Ewma::Estimate() const {
+  const double zero_factor = 1 - std::pow(alpha_, total_weight_);
+  return estimate_ / zero_factor;
+}
+
+BandwidthEstimator::BandwidthEstimator()
+    : fast_(kFastHalfLife), slow_(kSlowHalfLife), bytes_sampled_(0) {}
+
+void BandwidthEstimator::Sample(double duration_ms, uint64_t bytes) {
+  if (bytes < kMinSampleBytes || duration_ms <= 0)
+    return;
+  const double bandwidth = 8000 * bytes / duration_ms;
+  const double weight = duration_ms / 1000;
+  bytes_sampled_ += bytes;
+  fast_.Sample(weight, bandwidth);
+  slow_.Sample(weight, bandwidth);
+}
+
+double BandwidthEstimator::Estimate(double default_estimate) const {
+  if (!HasGoodEstimate())
+    return default_estimate;
+  return std::min(fast_.Estimate(), slow_.Estimate());
+}
+
+bool BandwidthEstimator::HasGoodEstimate() const {
+  return bytes_sampled_ >= kMinTotalBytes;
+}
+
+}  // namespace sample
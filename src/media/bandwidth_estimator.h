@@ -0,0 +1,53 @@
+#ifndef SAMPLE_MEDIA_BANDWIDTH_ESTIMATOR_H_
+#define SAMPLE_MEDIA_BANDWIDTH_ESTIMATOR_H_
+
+#include <cstdint>
+
+namespace sample {
+
+/**
+ * An exponentially weighted moving average whose samples are weighted by
+ * duration, so the estimate halves its memory every |half_life| seconds of
+ * sampled time.  Mirrors shaka.abr.Ewma.
+ */
+class Ewma {
+ public:
+  explicit Ewma(double half_life);
+
+  void Sample(double weight, double value);
+  /** The estimate, corrected for the zero it started from. */
+  double Estimate() const;
+
+ private:
+  const double alpha_;
+  double estimate_;
+  double total_weight_;
+};
+
+/**
+ * Estimates bandwidth from segment downloads with a fast and a slow moving
+ * average, reporting the lower of the two, so drops are followed quickly
+ * and rises slowly.  Mirrors shaka.abr.EwmaBandwidthEstimator with its
+ * default settings.
+ */
+class BandwidthEstimator {
+ public:
+  BandwidthEstimator();
+
+  /** Records a download of |bytes| that took |duration_ms|. */
+  void Sample(double duration_ms, uint64_t bytes);
+
+  /** The estimate in bit/s, or |default_estimate| until it is good. */
+  double Estimate(double default_estimate) const;
+  /** Whether enough bytes were sampled for the estimate to be used. */
+  bool HasGoodEstimate() const;
+
+ private:
+  Ewma fast_;
+  Ewma slow_;
+  uint64_t bytes_sampled_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_BANDWIDTH_ESTIMATOR_H_
@@ -0,0 +1,89 @@
+#include "media/buffer_policy.h"
+
+#include <algorithm>
+
+#include "base/json_writer.h"
+#include "media/sample_arena.h"
+
+namespace sample {
+
+namespace {
+
+/** The share of the budget planned at the declared bandwidth. */
+constexpr double kBandwidthHeadroom = 0.8;
+/** Shaka Player's defaults, which are kept when the budget allows. */
+constexpr double kDefaultRebufferingGoal = 2;
+constexpr double kDefaultBufferBehind = 30;
+/** The share of the buffered time kept behind the playhead. */
+constexpr double kBehindShare = 0.2;
+/** Less than this ahead of the playhead cannot ride out a segment fetch. */
+constexpr double kMinBufferingGoal = 1;
+/** Assumed when segment durations are not listed in the manifest. */
+constexpr double kDefaultSegmentDuration = 10;
+
+/** The longest listed segment of any representation. */
+double MaxSegmentDuration(const Manifest& manifest) {
+  double ret = 0;
+  for (auto& representation : manifest.representations) {
+    for (auto& segment : representation.segments)
+      ret = std::max(ret, segment.end - segment.start);
+  }
+  return ret > 0 ? ret : kDefaultSegmentDuration;
+}
+
+}  // namespace
+
+bool ChooseBufferPolicy(const Manifest& manifest, uint64_t byte_budget,
+                        BufferPolicy* policy, std::string* error) {
+  uint64_t variant_bandwidth = 0;
+  for (auto& variant : manifest.variants)
+    variant_bandwidth = std::max(variant_bandwidth, variant.bandwidth);
+  uint64_t text_bandwidth = 0;
+  for (auto& representation : manifest.representations) {
+    if (representation.type == StreamType::kText)
+      text_bandwidth = std::max(text_bandwidth, representation.bandwidth);
+  }
+  if (variant_bandwidth == 0) {
+    *error = "The manifest declares no variant bandwidth to plan buffers for";
+    return false;
+  }
+
+  *policy = BufferPolicy();
+  policy->byte_budget = byte_budget;
+  policy->peak_bandwidth =
+      static_cast<double>(variant_bandwidth + text_bandwidth);
+  const double budget_seconds =
+      SampleArena::PlannedCapacity(byte_budget) * 8 * kBandwidthHeadroom /
+          policy->peak_bandwidth -
+      MaxSegmentDuration(manifest);
+  policy->buffer_behind =
+      std::min(kDefaultBufferBehind, budget_seconds * kBehindShare);
+  policy->buffering_goal = budget_seconds - policy->buffer_behind;
+  if (policy->buffering_goal < kMinBufferingGoal) {
+    *error = "A buffer budget of " + std::to_string(byte_budget) +
+             " bytes is too small for " +
+             std::to_string(static_cast<uint64_t>(policy->peak_bandwidth)) +
+             " bit/s with its segments";
+    return false;
+  }
+  policy->rebuffering_goal =
+      std::min(kDefaultRebufferingGoal, policy->buffering_goal);
+  return true;
+}
+
+void WriteBufferPolicy(const BufferPolicy& policy, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("byte_budget");
+  writer->Uint(policy.byte_budget);
+  writer->Key("peak_bandwidth");
+  writer->Number(policy.peak_bandwidth);
+  writer->Key("buffering_goal");
+  writer->Number(policy.buffering_goal);
+  writer->Key("rebuffering_goal");
+  writer->Number(policy.rebuffering_goal);
+  writer->Key("buffer_behind");
+  writer->Number(policy.buffer_behind);
+  writer->EndObject();
+}
+
+}  // namespace sample
@@ -0,0 +1,44 @@
+#ifndef SAMPLE_MEDIA_BUFFER_POLICY_H_
+#define SAMPLE_MEDIA_BUFFER_POLICY_H_
+
+#include <cstdint>
+#include <string>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** Player buffer lengths, in seconds, as Shaka Player's streaming config. */
+struct BufferPolicy {
+  /** The byte budget the lengths were chosen for. */
+  uint64_t byte_budget = 0;
+  /** The combined audio, video and text bit rate planned for. */
+  double peak_bandwidth = 0;
+  /** streaming.bufferingGoal: media buffered ahead of the playhead. */
+  double buffering_goal = 0;
+  /** streaming.rebufferingGoal: media needed to start or resume. */
+  double rebuffering_goal = 0;
+  /** streaming.bufferBehind: media kept behind the playhead. */
+  double buffer_behind = 0;
+};
+
+/**
+ * Chooses buffer lengths so the media of |manifest| buffered across audio,
+ * video and text stays under |byte_budget| bytes at any variant.
+ *
+ * The player buffers by time, so the SampleArena::PlannedCapacity() of the
+ * budget is converted at the highest variant's bandwidth plus the highest
+ * text bandwidth, with headroom for bit rate peaks above the declared
+ * average and for the whole segment the player appends past its goal.
+ * Fails if the budget cannot hold the minimum needed to play.
+ */
+bool ChooseBufferPolicy(const Manifest& manifest, uint64_t byte_budget,
+                        BufferPolicy* policy, std::string* error);
+
+void WriteBufferPolicy(const BufferPolicy& policy, JsonWriter* writer);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_BUFFER_POLICY_H_
@@ -0,0 +1,129 @@
+#include "media/cue_store.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+namespace sample {
+
+namespace {
+
+constexpr double kNoEnd = -std::numeric_limits<double>::infinity();
+
+bool ByTime(const Cue& a, const Cue& b) {
+  return std::tie(a.start, a.end) < std::tie(b.start, b.end);
+}
+
+/** Orders a batch so that duplicates are adjacent. */
+bool ByTimeAndPayload(const Cue& a, const Cue& b) {
+  return std::tie(a.start, a.end, a.payload) <
+         std::tie(b.start, b.end, b.payload);
+}
+
+bool SameCue(const Cue& a, const Cue& b) {
+  return a.start == b.start && a.end == b.end && a.payload == b.payload;
+}
+
+}  // namespace
+
+size_t CueStore::AddSegment(std::vector<Cue> cues) {
+  cues.erase(
+      std::remove_if(cues.begin(), cues.end(),
+                     [](const Cue& cue) { return !(cue.end > cue.start); }),
+      cues.end());
+  std::sort(cues.begin(), cues.end(), ByTimeAndPayload);
+  cues.erase(std::unique(cues.begin(), cues.end(), SameCue), cues.end());
+
+  const size_t old_size = cues_.size();
+  for (auto& cue : cues) {
+    if (!Contains(cue, old_size))
+      cues_.push_back(std::move(cue));
+  }
+  const size_t added = cues_.size() - old_size;
+  if (added == 0)
+    return 0;
+
+  // Cues repeated from the previous segment were skipped above, so a live
+  // stream's segments append.
+  if (old_size > 0 && ByTime(cues_[old_size], cues_[old_size - 1])) {
+    std::inplace_merge(cues_.begin(), cues_.begin() + old_size, cues_.end(),
+                       ByTime);
+    Rebuild();
+  } else if (cues_.size() > leaves_) {
+    Rebuild();
+  } else {
+    for (size_t i = old_size; i < cues_.size(); i++)
+      UpdateLeaf(i);
+  }
+  return added;
+}
+
+size_t CueStore::RemoveBefore(double time) {
+  const size_t old_size = cues_.size();
+  cues_.erase(
+      std::remove_if(cues_.begin(), cues_.end(),
+                     [time](const Cue& cue) { return cue.end <= time; }),
+      cues_.end());
+  const size_t removed = old_size - cues_.size();
+  if (removed > 0)
+    Rebuild();
+  return removed;
+}
+
+void CueStore::ActiveAt(double time, std::vector<const Cue*>* active) const {
+  active->clear();
+  if (cues_.empty())
+    return;
+  // Only cues that start by |time| can show, and they form a prefix.
+  const size_t limit =
+      std::upper_bound(cues_.begin(), cues_.end(), time,
+                       [](double value, const Cue& cue) {
+                         return value < cue.start;
+                       }) -
+      cues_.begin();
+  Collect(1, 0, leaves_, limit, time, active);
+}
+
+void CueStore::Rebuild() {
+  leaves_ = 1;
+  while (leaves_ < cues_.size())
+    leaves_ *= 2;
+  max_end_.assign(2 * leaves_, kNoEnd);
+  for (size_t i = 0; i < cues_.size(); i++)
+    max_end_[leaves_ + i] = cues_[i].end;
+  for (size_t node = leaves_ - 1; node > 0; node--)
+    max_end_[node] = std::max(max_end_[2 * node], max_end_[2 * node + 1]);
+}
+
+void CueStore::UpdateLeaf(size_t index) {
+  size_t node = leaves_ + index;
+  max_end_[node] = cues_[index].end;
+  for (node /= 2; node > 0; node /= 2)
+    max_end_[node] = std::max(max_end_[2 * node], max_end_[2 * node + 1]);
+}
+
+void CueStore::Collect(size_t node, size_t node_begin, size_t node_size,
+                       size_t limit, double time,
+                       std::vector<const Cue*>* active) const {
+  if (node_begin >= limit || max_end_[node] <= time)
+    return;
+  if (node_size == 1) {
+    active->push_back(&cues_[node_begin]);
+    return;
+  }
+  const size_t half = node_size / 2;
+  Collect(2 * node, node_begin, half, limit, time, active);
+  Collect(2 * node + 1, node_begin + half, half, limit, time, active);
+}
+
+bool CueStore::Contains(const Cue& cue, size_t count) const {
+  auto range =
+      std::equal_range(cues_.begin(), cues_.begin() + count, cue, ByTime);
+  for (auto it = range.first; it != range.second; it++) {
+    if (it->payload == cue.payload)
+      return true;
+  }
+  return false;
+}
+
+}  // namespace sample
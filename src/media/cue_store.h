@@ -0,0 +1,85 @@
+#ifndef SAMPLE_MEDIA_CUE_STORE_H_
+#define SAMPLE_MEDIA_CUE_STORE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/** A timed text cue, e.g. one WebVTT caption. */
+struct Cue {
+  /** Presentation times in seconds; the cue shows in [start, end). */
+  double start = 0;
+  double end = 0;
+  std::string id;
+  std::string payload;
+};
+
+/**
+ * The cues of a text stream, indexed by time so the cues showing at a given
+ * time are found without scanning the rest.
+ *
+ * Cues are kept sorted by start time over an implicit binary tree holding
+ * the latest end time below each node.  A lookup descends only into subtrees
+ * that start early enough and end late enough, so it costs O(log n) per cue
+ * found, however many cues are stored.  Segments of a stream arrive mostly
+ * in order, so a batch whose cues start after every stored cue is appended
+ * with O(log n) updates per cue; an earlier batch is merged and the tree
+ * rebuilt.
+ */
+class CueStore {
+ public:
+  CueStore() = default;
+
+  CueStore(const CueStore&) = delete;
+  CueStore& operator=(const CueStore&) = delete;
+
+  /**
+   * Adds the cues parsed from one text segment.  Cues already stored with
+   * the same times and payload, as when a cue spans a segment boundary and
+   * is repeated in both, are skipped, as are empty cues.  Returns how many
+   * cues were added.
+   */
+  size_t AddSegment(std::vector<Cue> cues);
+
+  /** Removes the cues that end at or before |time|; returns how many. */
+  size_t RemoveBefore(double time);
+
+  /**
+   * Replaces the contents of |active| with the cues showing at |time|, in
+   * start order.  The pointers are valid until the store next changes.
+   */
+  void ActiveAt(double time, std::vector<const Cue*>* active) const;
+
+  size_t size() const {
+    return cues_.size();
+  }
+  bool empty() const {
+    return cues_.empty();
+  }
+
+ private:
+  /** Sets the tree over |cues_| from scratch. */
+  void Rebuild();
+  /** Recomputes the nodes above leaf |index|. */
+  void UpdateLeaf(size_t index);
+  void Collect(size_t node, size_t node_begin, size_t node_size, size_t limit,
+               double time, std::vector<const Cue*>* active) const;
+  /** Whether one of the first |count| cues has |cue|'s times and payload. */
+  bool Contains(const Cue& cue, size_t count) const;
+
+  /** Sorted by start, then end. */
+  std::vector<Cue> cues_;
+  /**
+   * A power of two no smaller than the cue count.  Node 1 is the root, node
+   * i has children 2i and 2i + 1, and cue i is node leaves_ + i.
+   */
+  size_t leaves_ = 0;
+  /** The latest end time under each node; -infinity when empty. */
+  std::vector<double> max_end_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_CUE_STORE_H_
@@ -0,0 +1,400 @@
+#include "media/dash_parser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+
+#include "media/mini_xml.h"
+
+namespace sample {
+
+namespace {
+
+/** Bounds template expansion for very long or malformed presentations. */
+constexpr size_t kMaxSegmentsPerRepresentation = 200000;
+
+/** SegmentTemplate attributes, inherited down Period, AdaptationSet, Rep. */
+struct TemplateInfo {
+  std::string media;
+  std::string initialization;
+  uint64_t timescale = 1;
+  uint64_t duration = 0;
+  uint64_t start_number = 1;
+  uint64_t presentation_time_offset = 0;
+  const XmlElement* timeline = nullptr;
+};
+
+uint64_t ParseUint(const std::string& text, uint64_t default_value) {
+  if (text.empty())
+    return default_value;
+  return std::strtoull(text.c_str(), nullptr, 10);
+}
+
+void MergeTemplate(const XmlElement* element, TemplateInfo* info) {
+  if (!element)
+    return;
+  info->media = element->Attribute("media", info->media);
+  info->initialization =
+      element->Attribute("initialization", info->initialization);
+  info->timescale =
+      std::max<uint64_t>(1, ParseUint(element->Attribute("timescale"),
+                                      info->timescale));
+  info->duration = ParseUint(element->Attribute("duration"), info->duration);
+  info->start_number =
+      ParseUint(element->Attribute("startNumber"), info->start_number);
+  info->presentation_time_offset =
+      ParseUint(element->Attribute("presentationTimeOffset"),
+                info->presentation_time_offset);
+  if (const XmlElement* timeline = element->Child("SegmentTimeline"))
+    info->timeline = timeline;
+}
+
+/**
+ * Expands the $RepresentationID$, $Number$, $Bandwidth$ and $Time$
+ * identifiers, with optional printf-style width ("$Number%05d$"), and "$$".
+ */
+std::string ExpandTemplate(const std::string& pattern, const std::string& id,
+                           uint64_t number, uint64_t bandwidth,
+                           uint64_t time) {
+  std::string ret;
+  size_t pos = 0;
+  while (pos < pattern.size()) {
+    const size_t open = pattern.find('$', pos);
+    const size_t close = open == std::string::npos
+                             ? std::string::npos
+                             : pattern.find('$', open + 1);
+    if (close == std::string::npos) {
+      ret.append(pattern, pos, std::string::npos);
+      break;
+    }
+    ret.append(pattern, pos, open - pos);
+    pos = close + 1;
+
+    const std::string token = pattern.substr(open + 1, close - open - 1);
+    if (token.empty()) {
+      ret += '$';
+      continue;
+    }
+    const size_t percent = token.find('%');
+    const std::string name = token.substr(0, percent);
+    if (name == "RepresentationID") {
+      ret += id;
+      continue;
+    }
+
+    uint64_t value;
+    if (name == "Number") {
+      value = number;
+    } else if (name == "Bandwidth") {
+      value = bandwidth;
+    } else if (name == "Time") {
+      value = time;
+    } else {
+      ret += pattern.substr(open, close - open + 1);
+      continue;
+    }
+    std::string digits = std::to_string(value);
+    if (percent != std::string::npos) {
+      const size_t width =
+          std::strtoul(token.c_str() + percent + 1, nullptr, 10);
+      if (digits.size() < width)
+        digits.insert(0, width - digits.size(), '0');
+    }
+    ret += digits;
+  }
+  return ret;
+}
+
+/** Returns |base| resolved against the element's BaseURL child, if any. */
+std::string ResolveBaseUrl(const XmlElement* element,
+                           const std::string& base) {
+  const XmlElement* base_url = element ? element->Child("BaseURL") : nullptr;
+  if (!base_url)
+    return base;
+  std::string text = base_url->text;
+  const size_t start = text.find_first_not_of(" \t\r\n");
+  const size_t end = text.find_last_not_of(" \t\r\n");
+  text = start == std::string::npos ? "" : text.substr(start, end - start + 1);
+  return ResolveUrl(base, text);
+}
+
+/** Parses a "start-end" byte range attribute. */
+bool ParseRange(const std::string& text, SegmentReference* reference) {
+  const size_t dash = text.find('-');
+  if (text.empty() || dash == std::string::npos)
+    return false;
+  reference->has_range = true;
+  reference->range_start = std::strtoull(text.c_str(), nullptr, 10);
+  reference->range_end = std::strtoull(text.c_str() + dash + 1, nullptr, 10);
+  return true;
+}
+
+StreamType GuessType(const std::string& content_type,
+                     const std::string& mime_type, const std::string& codecs) {
+  if (content_type == "audio" || mime_type.compare(0, 6, "audio/") == 0)
+    return StreamType::kAudio;
+  if (content_type == "text" || mime_type.compare(0, 5, "text/") == 0 ||
+      mime_type == "application/ttml+xml" || codecs == "wvtt" ||
+      codecs.compare(0, 4, "stpp") == 0) {
+    return StreamType::kText;
+  }
+  return StreamType::kVideo;
+}
+
+void ExpandTimeline(const TemplateInfo& info, const std::string& id,
+                    uint64_t bandwidth, double period_duration,
+                    const std::string& base, Representation* rep) {
+  const double timescale = static_cast<double>(info.timescale);
+  const double period_end =
+      period_duration * timescale + info.presentation_time_offset;
+  uint64_t time = 0;
+  uint64_t number = info.start_number;
+  for (const XmlElement* s : info.timeline->Children("S")) {
+    time = ParseUint(s->Attribute("t"), time);
+    const uint64_t duration = ParseUint(s->Attribute("d"), 0);
+    if (duration == 0)
+      break;
+    int64_t repeat = std::strtoll(s->Attribute("r", "0").c_str(), nullptr, 10);
+    if (repeat < 0) {
+      // Repeats until the end of the Period.
+      repeat = period_duration > 0
+                   ? static_cast<int64_t>(
+                         std::ceil((period_end - time) / duration)) - 1
+                   : 0;
+    }
+    for (int64_t i = 0; i <= repeat; i++) {
+      if (rep->segments.size() >= kMaxSegmentsPerRepresentation)
+        return;
+      SegmentReference segment;
+      segment.start = (static_cast<double>(time) -
+                       info.presentation_time_offset) / timescale;
+      segment.end = segment.start + duration / timescale;
+      segment.url = ResolveUrl(
+          base, ExpandTemplate(info.media, id, number, bandwidth, time));
+      rep->segments.push_back(segment);
+      time += duration;
+      number++;
+    }
+  }
+}
+
+void ExpandTemplateSegments(const TemplateInfo& info, const std::string& id,
+                            uint64_t bandwidth, double period_duration,
+                            const std::string& base, Representation* rep) {
+  if (!info.initialization.empty()) {
+    rep->init.url = ResolveUrl(
+        base, ExpandTemplate(info.initialization, id, 0, bandwidth, 0));
+  }
+  if (info.timeline) {
+    ExpandTimeline(info, id, bandwidth, period_duration, base, rep);
+    return;
+  }
+  if (info.duration == 0 || period_duration <= 0)
+    return;
+
+  const double segment_duration =
+      static_cast<double>(info.duration) / info.timescale;
+  const size_t count = std::min<size_t>(
+      kMaxSegmentsPerRepresentation,
+      static_cast<size_t>(std::ceil(period_duration / segment_duration)));
+  for (size_t i = 0; i < count; i++) {
+    SegmentReference segment;
+    segment.start = i * segment_duration;
+    segment.end = std::min(period_duration, (i + 1) * segment_duration);
+    // $Time$ is in media time, which presentationTimeOffset shifts.
+    segment.url = ResolveUrl(
+        base, ExpandTemplate(info.media, id, info.start_number + i, bandwidth,
+                             info.presentation_time_offset +
+                                 info.duration * i));
+    rep->segments.push_back(segment);
+  }
+}
+
+void ParseSegmentList(const XmlElement* list, double period_duration,
+                      const std::string& base, Representation* rep) {
+  const double timescale =
+      static_cast<double>(std::max<uint64_t>(
+          1, ParseUint(list->Attribute("timescale"), 1)));
+  const double duration =
+      ParseUint(list->Attribute("duration"), 0) / timescale;
+  if (const XmlElement* init = list->Child("Initialization")) {
+    rep->init.url = ResolveUrl(base, init->Attribute("sourceURL"));
+    ParseRange(init->Attribute("range"), &rep->init);
+  }
+
+  double time = 0;
+  for (const XmlElement* url : list->Children("SegmentURL")) {
+    SegmentReference segment;
+    segment.url = ResolveUrl(base, url->Attribute("media"));
+    ParseRange(url->Attribute("mediaRange"), &segment);
+    segment.start = time;
+    segment.end = duration > 0 ? time + duration : period_duration;
+    time = segment.end;
+    rep->segments.push_back(segment);
+  }
+}
+
+}  // namespace
+
+bool ParseIsoDuration(const std::string& text, double* seconds) {
+  if (text.empty() || text[0] != 'P')
+    return false;
+  double total = 0;
+  bool in_time = false;
+  const char* pos = text.c_str() + 1;
+  while (*pos) {
+    if (*pos == 'T') {
+      in_time = true;
+      pos++;
+      continue;
+    }
+    char* end;
+    const double value = std::strtod(pos, &end);
+    if (end == pos)
+      return false;
+    switch (*end) {
+      case 'Y':
+        total += value * 365 * 86400;
+        break;
+      case 'D':
+        total += value * 86400;
+        break;
+      case 'H':
+        total += value * 3600;
+        break;
+      case 'M':
+        total += value * (in_time ? 60 : 30 * 86400);
+        break;
+      case 'S':
+        total += value;
+        break;
+      default:
+        return false;
+    }
+    pos = end + 1;
+  }
+  *seconds = total;
+  return true;
+}
+
+bool ParseDashManifest(const std::string& url, const std::string& body,
+                       Manifest* manifest, std::string* error) {
+  std::unique_ptr<XmlElement> mpd = ParseXml(body, error);
+  if (!mpd)
+    return false;
+  if (mpd->name != "MPD") {
+    *error = "DASH: root element is <" + mpd->name + ">";
+    return false;
+  }
+  const XmlElement* period = mpd->Child("Period");
+  if (!period) {
+    *error = "DASH: no Period";
+    return false;
+  }
+
+  manifest->format = Manifest::Format::kDash;
+  manifest->url = url;
+  manifest->live = mpd->Attribute("type") == "dynamic";
+  double duration = 0;
+  if (!ParseIsoDuration(period->Attribute("duration"), &duration))
+    ParseIsoDuration(mpd->Attribute("mediaPresentationDuration"), &duration);
+  manifest->duration = duration;
+
+  const std::string period_base =
+      ResolveBaseUrl(period, ResolveBaseUrl(mpd.get(), url));
+  TemplateInfo period_template;
+  MergeTemplate(period->Child("SegmentTemplate"), &period_template);
+
+  std::vector<size_t> videos;
+  std::vector<size_t> audios;
+  for (const XmlElement* set : period->Children("AdaptationSet")) {
+    const std::string set_base = ResolveBaseUrl(set, period_base);
+    TemplateInfo set_template = period_template;
+    MergeTemplate(set->Child("SegmentTemplate"), &set_template);
+
+    for (const XmlElement* element : set->Children("Representation")) {
+      Representation rep;
+      rep.id = element->Attribute("id");
+      rep.mime_type = element->Attribute("mimeType",
+                                         set->Attribute("mimeType"));
+      rep.codecs = element->Attribute("codecs", set->Attribute("codecs"));
+      rep.language = set->Attribute("lang");
+      rep.bandwidth = ParseUint(element->Attribute("bandwidth"), 0);
+      rep.width = ParseUint(element->Attribute("width",
+                                               set->Attribute("width")), 0);
+      rep.height = ParseUint(element->Attribute("height",
+                                                set->Attribute("height")), 0);
+      rep.type = GuessType(set->Attribute("contentType"), rep.mime_type,
+                           rep.codecs);
+      const std::string base = ResolveBaseUrl(element, set_base);
+
+      const XmlElement* list = element->Child("SegmentList");
+      const XmlElement* segment_base = element->Child("SegmentBase");
+      if (!list && !segment_base && !element->Child("SegmentTemplate")) {
+        list = set->Child("SegmentList");
+        segment_base = set->Child("SegmentBase");
+      }
+      TemplateInfo rep_template = set_template;
+      MergeTemplate(element->Child("SegmentTemplate"), &rep_template);
+
+      if (!rep_template.media.empty()) {
+        ExpandTemplateSegments(rep_template, rep.id, rep.bandwidth, duration,
+                               base, &rep);
+      } else if (list) {
+        ParseSegmentList(list, duration, base, &rep);
+      } else {
+        // A single file, indexed by a sidx box when SegmentBase says where.
+        if (segment_base) {
+          if (const XmlElement* init = segment_base->Child("Initialization")) {
+            rep.init.url = base;
+            ParseRange(init->Attribute("range"), &rep.init);
+          }
+          rep.index.url = base;
+          ParseRange(segment_base->Attribute("indexRange"), &rep.index);
+          const double timescale = static_cast<double>(std::max<uint64_t>(
+              1, ParseUint(segment_base->Attribute("timescale"), 1)));
+          rep.index_time_offset =
+              ParseUint(segment_base->Attribute("presentationTimeOffset"), 0) /
+              timescale;
+        }
+        if (!rep.index.has_range) {
+          SegmentReference whole;
+          whole.url = base;
+          whole.end = duration;
+          rep.segments.push_back(whole);
+        }
+      }
+
+      if (rep.type == StreamType::kVideo)
+        videos.push_back(manifest->representations.size());
+      else if (rep.type == StreamType::kAudio)
+        audios.push_back(manifest->representations.size());
+      manifest->representations.push_back(rep);
+    }
+  }
+
+  // Like Shaka Player, every video stream pairs with every audio stream.
+  const std::vector<size_t> none = {Variant::kNone};
+  for (size_t video : videos.empty() ? none : videos) {
+    for (size_t audio : audios.empty() ? none : audios) {
+      if (video == Variant::kNone && audio == Variant::kNone)
+        continue;
+      Variant variant;
+      variant.video = video;
+      variant.audio = audio;
+      if (video != Variant::kNone)
+        variant.bandwidth += manifest->representations[video].bandwidth;
+      if (audio != Variant::kNone)
+        variant.bandwidth += manifest->representations[audio].bandwidth;
+      manifest->variants.push_back(variant);
+    }
+  }
+  std::stable_sort(manifest->variants.begin(), manifest->variants.end(),
+                   [](const Variant& a, const Variant& b) {
+                     return a.bandwidth < b.bandwidth;
+                   });
+  return true;
+}
+
+}  // namespace sample
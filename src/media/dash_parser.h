@@ -0,0 +1,23 @@
+#ifndef SAMPLE_MEDIA_DASH_PARSER_H_
+#define SAMPLE_MEDIA_DASH_PARSER_H_
+
+#include <string>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+/**
+ * Parses the first Period of a DASH MPD.  SegmentTemplate (with or without a
+ * SegmentTimeline) and SegmentList are expanded into segment references;
+ * SegmentBase representations only get their init and index ranges.
+ */
+bool ParseDashManifest(const std::string& url, const std::string& body,
+                       Manifest* manifest, std::string* error);
+
+/** Parses an ISO 8601 duration such as "PT1M30.5S" into seconds. */
+bool ParseIsoDuration(const std::string& text, double* seconds);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_DASH_PARSER_H_
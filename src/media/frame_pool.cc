@@ -0,0 +1,120 @@
+#include "media/frame_pool.h"
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace sample {
+
+bool ParseFrameHandoff(const std::string& name, FrameHandoff* handoff) {
+  if (name == "copy") {
+    *handoff = FrameHandoff::kCopy;
+    return true;
+  }
+  if (name == "zero-copy") {
+    *handoff = FrameHandoff::kZeroCopy;
+    return true;
+  }
+  return false;
+}
+
+const char* FrameHandoffName(FrameHandoff handoff) {
+  return handoff == FrameHandoff::kCopy ? "copy" : "zero-copy";
+}
+
+FrameBuffer::FrameBuffer() : pool_(nullptr), refs_(0), pts_(0) {}
+
+FrameRef::FrameRef(const FrameRef& other) : buffer_(other.buffer_) {
+  if (buffer_)
+    buffer_->refs_.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameRef::FrameRef(FrameRef&& other) noexcept : buffer_(other.buffer_) {
+  other.buffer_ = nullptr;
+}
+
+FrameRef::~FrameRef() {
+  Reset();
+}
+
+FrameRef& FrameRef::operator=(FrameRef other) noexcept {
+  std::swap(buffer_, other.buffer_);
+  return *this;
+}
+
+void FrameRef::Reset() {
+  if (buffer_ && buffer_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    buffer_->pool_->Release(buffer_);
+  buffer_ = nullptr;
+}
+
+FramePool::FramePool(FrameHandoff handoff, size_t capacity)
+    : handoff_(handoff) {
+  for (size_t i = 0; i < capacity; i++) {
+    buffers_.emplace_back(new FrameBuffer);
+    buffers_.back()->pool_ = this;
+    free_.push_back(buffers_.back().get());
+  }
+}
+
+FramePool::~FramePool() {
+  // Every FrameRef must be dropped before the pool is destroyed.
+  assert(free_.size() == buffers_.size());
+}
+
+FrameRef FramePool::Wrap(const FramePlanes& planes, double pts,
+                         std::shared_ptr<const void> source) {
+  FrameBuffer* buffer;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.frames++;
+    if (free_.empty()) {
+      stats_.exhausted++;
+      return FrameRef();
+    }
+    buffer = free_.back();
+    free_.pop_back();
+  }
+
+  buffer->pts_ = pts;
+  buffer->planes_ = planes;
+  if (handoff_ == FrameHandoff::kZeroCopy) {
+    buffer->source_ = std::move(source);
+  } else {
+    size_t total = 0;
+    for (size_t i = 0; i < planes.count; i++)
+      total += planes.linesize[i] * planes.rows[i];
+    // resize() only allocates the first time a buffer sees a larger frame.
+    buffer->storage_.resize(total);
+
+    uint8_t* dest = buffer->storage_.data();
+    for (size_t i = 0; i < planes.count; i++) {
+      const size_t size = planes.linesize[i] * planes.rows[i];
+      std::memcpy(dest, planes.data[i], size);
+      buffer->planes_.data[i] = dest;
+      dest += size;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.bytes_copied += total;
+  }
+
+  buffer->refs_.store(1, std::memory_order_relaxed);
+  return FrameRef(buffer);
+}
+
+FramePoolStats FramePool::stats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void FramePool::Release(FrameBuffer* buffer) {
+  // Drop the decoder frame outside the lock; its destructor may be costly.
+  std::shared_ptr<const void> source;
+  source.swap(buffer->source_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  free_.push_back(buffer);
+}
+
+}  // namespace sample
@@ -0,0 +1,147 @@
+#ifndef SAMPLE_MEDIA_FRAME_POOL_H_
+#define SAMPLE_MEDIA_FRAME_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+class FramePool;
+
+/** How decoded frames reach the renderer. */
+enum class FrameHandoff {
+  /** Plane bytes are copied into an app-owned buffer, as naive embedders do. */
+  kCopy,
+  /** The buffer references the decoder's planes and keeps the frame alive. */
+  kZeroCopy,
+};
+
+/** Parses "copy" or "zero-copy"; returns false on anything else. */
+bool ParseFrameHandoff(const std::string& name, FrameHandoff* handoff);
+const char* FrameHandoffName(FrameHandoff handoff);
+
+/** Describes the planes of one decoded video frame. */
+struct FramePlanes {
+  static constexpr size_t kMaxPlanes = 4;
+
+  size_t count = 0;
+  const uint8_t* data[kMaxPlanes] = {};
+  size_t linesize[kMaxPlanes] = {};
+  /** Rows in each plane; chroma planes of subsampled formats have fewer. */
+  uint32_t rows[kMaxPlanes] = {};
+};
+
+/**
+ * One pooled frame.  Reached only through FrameRef, which keeps a reference
+ * count; when the last FrameRef goes away the buffer returns to its pool.
+ */
+class FrameBuffer {
+ public:
+  double pts() const {
+    return pts_;
+  }
+  const FramePlanes& planes() const {
+    return planes_;
+  }
+
+ private:
+  friend class FramePool;
+  friend class FrameRef;
+
+  FrameBuffer();
+
+  FramePool* pool_;
+  std::atomic<uint32_t> refs_;
+  double pts_;
+  FramePlanes planes_;
+  /** Copy mode: backing store, reused across frames to avoid allocation. */
+  std::vector<uint8_t> storage_;
+  /** Zero-copy mode: the decoder frame that owns the planes. */
+  std::shared_ptr<const void> source_;
+};
+
+/** A counted reference to a pooled FrameBuffer; may be null. */
+class FrameRef {
+ public:
+  FrameRef() : buffer_(nullptr) {}
+  FrameRef(const FrameRef& other);
+  FrameRef(FrameRef&& other) noexcept;
+  ~FrameRef();
+
+  FrameRef& operator=(FrameRef other) noexcept;
+
+  explicit operator bool() const {
+    return buffer_ != nullptr;
+  }
+  const FrameBuffer* operator->() const {
+    return buffer_;
+  }
+
+  /** Drops this reference, returning the buffer to the pool if it was last. */
+  void Reset();
+
+ private:
+  friend class FramePool;
+
+  explicit FrameRef(FrameBuffer* buffer) : buffer_(buffer) {}
+
+  FrameBuffer* buffer_;
+};
+
+/** Counters kept by a FramePool. */
+struct FramePoolStats {
+  uint64_t frames = 0;
+  /** Frames dropped because every buffer was still held by the renderer. */
+  uint64_t exhausted = 0;
+  uint64_t bytes_copied = 0;
+};
+
+/**
+ * A fixed set of reference-counted frame buffers shared between the decoder
+ * side and the renderer.  Buffers are handed out by Wrap() and come back when
+ * the renderer drops its last FrameRef, so steady-state playback performs no
+ * per-frame allocation in either mode.
+ */
+class FramePool {
+ public:
+  FramePool(FrameHandoff handoff, size_t capacity);
+  ~FramePool();
+
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  FrameHandoff handoff() const {
+    return handoff_;
+  }
+
+  /**
+   * Wraps a decoded frame in a pooled buffer.  |source| owns the plane memory
+   * and is retained in zero-copy mode.  Returns a null ref if all buffers are
+   * in use.
+   */
+  FrameRef Wrap(const FramePlanes& planes, double pts,
+                std::shared_ptr<const void> source);
+
+  FramePoolStats stats() const;
+
+ private:
+  friend class FrameRef;
+
+  void Release(FrameBuffer* buffer);
+
+  const FrameHandoff handoff_;
+  std::vector<std::unique_ptr<FrameBuffer>> buffers_;
+
+  mutable std::mutex mutex_;
+  std::vector<FrameBuffer*> free_;
+  FramePoolStats stats_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_FRAME_POOL_H_
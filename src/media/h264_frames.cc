@@ -0,0 +1,65 @@
+#include "media/h264_frames.h"
+
+namespace sample {
+
+namespace {
+
+// Coded slices of non-IDR (1 to 4) and IDR (5) pictures.
+constexpr uint8_t kFirstSliceType = 1;
+constexpr uint8_t kLastSliceType = 5;
+
+/**
+ * Checks one NAL unit header.  Sets |*slices| when it is a slice and returns
+ * false when that slice is referenced.
+ */
+bool CheckNalUnit(uint8_t header, bool* slices) {
+  const uint8_t type = header & 0x1f;
+  if (type < kFirstSliceType || type > kLastSliceType)
+    return true;
+  *slices = true;
+  return (header & 0x60) == 0;
+}
+
+}  // namespace
+
+size_t AvcLengthSize(const uint8_t* config, size_t size) {
+  if (size < 5 || config[0] != 1)
+    return 0;
+  return (config[4] & 0x3) + 1;
+}
+
+bool IsDisposableH264Frame(const uint8_t* data, size_t size,
+                           size_t length_size) {
+  bool slices = false;
+  size_t pos = 0;
+  if (length_size == 0) {
+    // Annex B: each NAL unit follows a 00 00 01 start code.
+    while (pos + 3 < size) {
+      if (data[pos] == 0 && data[pos + 1] == 0 && data[pos + 2] == 1) {
+        if (!CheckNalUnit(data[pos + 3], &slices))
+          return false;
+        pos += 3;
+      } else {
+        pos++;
+      }
+    }
+    return slices;
+  }
+
+  while (pos < size) {
+    if (size - pos < length_size)
+      return false;
+    size_t length = 0;
+    for (size_t i = 0; i < length_size; i++)
+      length = (length << 8) | data[pos + i];
+    pos += length_size;
+    if (length == 0 || length > size - pos)
+      return false;
+    if (!CheckNalUnit(data[pos], &slices))
+      return false;
+    pos += length;
+  }
+  return slices;
+}
+
+}  // namespace sample
@@ -0,0 +1,28 @@
+#ifndef SAMPLE_MEDIA_H264_FRAMES_H_
+#define SAMPLE_MEDIA_H264_FRAMES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sample {
+
+/**
+ * Returns the size of the NAL unit length prefixes declared by an
+ * AVCDecoderConfigurationRecord ("avcC" body), or 0 if |config| is not one,
+ * meaning frames use Annex B start codes.
+ */
+size_t AvcLengthSize(const uint8_t* config, size_t size);
+
+/**
+ * Returns whether every coded slice in an H.264 access unit has a
+ * nal_ref_idc of 0.  No other frame predicts from such a frame, so a decoder
+ * can skip it without changing any later frame.  |length_size| comes from
+ * AvcLengthSize().  Returns false for data that does not parse or that has
+ * no slices.
+ */
+bool IsDisposableH264Frame(const uint8_t* data, size_t size,
+                           size_t length_size);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_H264_FRAMES_H_
@@ -0,0 +1,257 @@
+#include "media/hls_parser.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace sample {
+
+namespace {
+
+bool StartsWith(const std::string& str, const char* prefix) {
+  return str.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+/** Parses 'KEY=value,KEY="quoted, value"' into a map. */
+std::map<std::string, std::string> ParseAttributes(const std::string& list) {
+  std::map<std::string, std::string> ret;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    const size_t equals = list.find('=', pos);
+    if (equals == std::string::npos)
+      break;
+    const std::string key = list.substr(pos, equals - pos);
+    size_t end;
+    std::string value;
+    if (equals + 1 < list.size() && list[equals + 1] == '"') {
+      const size_t close = list.find('"', equals + 2);
+      value = list.substr(equals + 2, close - equals - 2);
+      end = close == std::string::npos ? list.size() : close + 1;
+    } else {
+      end = std::min(list.find(',', equals), list.size());
+      value = list.substr(equals + 1, end - equals - 1);
+    }
+    ret[key] = value;
+    pos = list.find(',', end);
+    pos = pos == std::string::npos ? list.size() : pos + 1;
+  }
+  return ret;
+}
+
+std::vector<std::string> ReadLines(const std::string& body) {
+  std::vector<std::string> ret;
+  std::istringstream stream(body);
+  std::string line;
+  while (std::getline(stream, line)) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+      line.pop_back();
+    if (!line.empty())
+      ret.push_back(line);
+  }
+  return ret;
+}
+
+bool IsAudioCodec(const std::string& codec) {
+  return StartsWith(codec, "mp4a") || StartsWith(codec, "ac-3") ||
+         StartsWith(codec, "ec-3") || StartsWith(codec, "opus") ||
+         StartsWith(codec, "flac");
+}
+
+/** Splits a CODECS attribute into its video and audio parts. */
+void SplitCodecs(const std::string& codecs, std::string* video,
+                 std::string* audio) {
+  std::istringstream stream(codecs);
+  std::string codec;
+  while (std::getline(stream, codec, ',')) {
+    const size_t start = codec.find_first_not_of(' ');
+    if (start == std::string::npos)
+      continue;
+    codec = codec.substr(start);
+    std::string* target = IsAudioCodec(codec) ? audio : video;
+    if (!target->empty())
+      *target += ',';
+    *target += codec;
+  }
+}
+
+/** Parses an EXT-X-BYTERANGE value "length[@offset]". */
+void ParseByteRange(const std::string& value, uint64_t default_offset,
+                    SegmentReference* reference) {
+  const size_t at = value.find('@');
+  const uint64_t length = std::strtoull(value.c_str(), nullptr, 10);
+  const uint64_t offset =
+      at == std::string::npos
+          ? default_offset
+          : std::strtoull(value.c_str() + at + 1, nullptr, 10);
+  reference->has_range = length > 0;
+  reference->range_start = offset;
+  reference->range_end = offset + length - 1;
+}
+
+}  // namespace
+
+bool ParseHlsPlaylist(const std::string& url, const std::string& body,
+                      Manifest* manifest, std::string* error) {
+  manifest->format = Manifest::Format::kHls;
+  manifest->url = url;
+  const std::vector<std::string> lines = ReadLines(body);
+  if (lines.empty() || lines[0] != "#EXTM3U") {
+    *error = "HLS: missing #EXTM3U";
+    return false;
+  }
+
+  bool is_master = false;
+  for (auto& line : lines)
+    is_master |= StartsWith(line, "#EXT-X-STREAM-INF:");
+  if (!is_master) {
+    Representation representation;
+    representation.id = "0";
+    representation.mime_type = "video/mp4";
+    representation.playlist_url = url;
+    if (!ParseHlsMediaPlaylist(url, body, &representation, manifest, error))
+      return false;
+    manifest->representations.push_back(representation);
+    Variant variant;
+    variant.video = 0;
+    manifest->variants.push_back(variant);
+    return true;
+  }
+
+  // Audio renditions by group, then one video stream per EXT-X-STREAM-INF.
+  std::map<std::string, std::vector<size_t>> audio_groups;
+  for (auto& line : lines) {
+    if (!StartsWith(line, "#EXT-X-MEDIA:"))
+      continue;
+    auto attributes = ParseAttributes(line.substr(13));
+    if (attributes["URI"].empty())
+      continue;
+    Representation representation;
+    representation.id = std::to_string(manifest->representations.size());
+    representation.language = attributes["LANGUAGE"];
+    representation.playlist_url = ResolveUrl(url, attributes["URI"]);
+    if (attributes["TYPE"] == "AUDIO") {
+      representation.type = StreamType::kAudio;
+      representation.mime_type = "audio/mp4";
+      audio_groups[attributes["GROUP-ID"]].push_back(
+          manifest->representations.size());
+    } else if (attributes["TYPE"] == "SUBTITLES") {
+      representation.type = StreamType::kText;
+      representation.mime_type = "text/vtt";
+    } else {
+      continue;
+    }
+    manifest->representations.push_back(representation);
+  }
+
+  for (size_t i = 0; i < lines.size(); i++) {
+    if (!StartsWith(lines[i], "#EXT-X-STREAM-INF:") || i + 1 >= lines.size())
+      continue;
+    auto attributes = ParseAttributes(lines[i].substr(18));
+    Representation video;
+    video.id = std::to_string(manifest->representations.size());
+    video.mime_type = "video/mp4";
+    video.playlist_url = ResolveUrl(url, lines[i + 1]);
+    video.bandwidth = std::strtoull(attributes["BANDWIDTH"].c_str(), nullptr,
+                                    10);
+    std::string audio_codecs;
+    SplitCodecs(attributes["CODECS"], &video.codecs, &audio_codecs);
+    const std::string& resolution = attributes["RESOLUTION"];
+    const size_t x = resolution.find('x');
+    if (x != std::string::npos) {
+      video.width = std::strtoul(resolution.c_str(), nullptr, 10);
+      video.height = std::strtoul(resolution.c_str() + x + 1, nullptr, 10);
+    }
+
+    const size_t video_index = manifest->representations.size();
+    manifest->representations.push_back(video);
+    auto group = audio_groups.find(attributes["AUDIO"]);
+    if (group == audio_groups.end() || group->second.empty()) {
+      Variant variant;
+      variant.video = video_index;
+      variant.bandwidth = video.bandwidth;
+      manifest->variants.push_back(variant);
+      continue;
+    }
+    for (size_t audio : group->second) {
+      Representation& rendition = manifest->representations[audio];
+      if (rendition.codecs.empty())
+        rendition.codecs = audio_codecs;
+      Variant variant;
+      variant.video = video_index;
+      variant.audio = audio;
+      // BANDWIDTH already covers the rendition in the group.
+      variant.bandwidth = video.bandwidth;
+      manifest->variants.push_back(variant);
+    }
+  }
+
+  std::stable_sort(manifest->variants.begin(), manifest->variants.end(),
+                   [](const Variant& a, const Variant& b) {
+                     return a.bandwidth < b.bandwidth;
+                   });
+  return true;
+}
+
+bool ParseHlsMediaPlaylist(const std::string& url, const std::string& body,
+                           Representation* representation, Manifest* manifest,
+                           std::string* error) {
+  const std::vector<std::string> lines = ReadLines(body);
+  if (lines.empty() || lines[0] != "#EXTM3U") {
+    *error = "HLS: missing #EXTM3U in " + url;
+    return false;
+  }
+
+  representation->segments.clear();
+  bool ended = false;
+  double time = 0;
+  double segment_duration = 0;
+  bool pending_range = false;
+  SegmentReference range;
+  uint64_t next_offset = 0;
+  for (auto& line : lines) {
+    if (StartsWith(line, "#EXTINF:")) {
+      segment_duration = std::strtod(line.c_str() + 8, nullptr);
+    } else if (StartsWith(line, "#EXT-X-BYTERANGE:")) {
+      ParseByteRange(line.substr(17), next_offset, &range);
+      pending_range = true;
+    } else if (StartsWith(line, "#EXT-X-MAP:")) {
+      auto attributes = ParseAttributes(line.substr(11));
+      representation->init = SegmentReference();
+      representation->init.url = ResolveUrl(url, attributes["URI"]);
+      if (!attributes["BYTERANGE"].empty())
+        ParseByteRange(attributes["BYTERANGE"], 0, &representation->init);
+    } else if (line == "#EXT-X-ENDLIST") {
+      ended = true;
+    } else if (line[0] != '#') {
+      SegmentReference segment;
+      if (pending_range) {
+        segment = range;
+        next_offset = range.range_end + 1;
+        pending_range = false;
+      }
+      segment.url = ResolveUrl(url, line);
+      segment.start = time;
+      segment.end = time + segment_duration;
+      time = segment.end;
+      representation->segments.push_back(segment);
+    }
+  }
+
+  if (!representation->segments.empty()) {
+    const std::string& first = representation->segments[0].url;
+    const std::string path = first.substr(0, first.find('?'));
+    if (path.size() >= 3 && path.compare(path.size() - 3, 3, ".ts") == 0) {
+      representation->mime_type =
+          representation->type == StreamType::kAudio ? "audio/mp2t"
+                                                     : "video/mp2t";
+    }
+  }
+  manifest->live = !ended;
+  if (ended)
+    manifest->duration = std::max(manifest->duration, time);
+  return true;
+}
+
+}  // namespace sample
@@ -0,0 +1,28 @@
+#ifndef SAMPLE_MEDIA_HLS_PARSER_H_
+#define SAMPLE_MEDIA_HLS_PARSER_H_
+
+#include <string>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+/**
+ * Parses an HLS master or media playlist.  For a master playlist every
+ * representation gets a |playlist_url| and no segments; a media playlist
+ * becomes a single video representation with its segments.
+ */
+bool ParseHlsPlaylist(const std::string& url, const std::string& body,
+                      Manifest* manifest, std::string* error);
+
+/**
+ * Fills the init segment and segments of |representation| from its media
+ * playlist, and updates the manifest's duration and live flag.
+ */
+bool ParseHlsMediaPlaylist(const std::string& url, const std::string& body,
+                           Representation* representation, Manifest* manifest,
+                           std::string* error);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_HLS_PARSER_H_
@@ -0,0 +1,227 @@
+#include "media/keyframe_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "media/hls_parser.h"
+
+namespace sample {
+
+namespace {
+
+uint32_t ReadUint32(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+uint64_t ReadUint64(const uint8_t* data) {
+  return (static_cast<uint64_t>(ReadUint32(data)) << 32) |
+         ReadUint32(data + 4);
+}
+
+bool ParseSidxBody(const uint8_t* data, size_t size, uint64_t anchor,
+                   std::vector<SidxReference>* references,
+                   std::string* error) {
+  if (size < 4 + 8) {
+    *error = "sidx: truncated header";
+    return false;
+  }
+  const uint8_t version = data[0];
+  const uint32_t timescale = ReadUint32(data + 8);
+  size_t pos = 12;
+  uint64_t earliest_time;
+  uint64_t first_offset;
+  if (version == 0) {
+    if (size < pos + 8 + 4)
+      return *error = "sidx: truncated header", false;
+    earliest_time = ReadUint32(data + pos);
+    first_offset = ReadUint32(data + pos + 4);
+    pos += 8;
+  } else {
+    if (size < pos + 16 + 4)
+      return *error = "sidx: truncated header", false;
+    earliest_time = ReadUint64(data + pos);
+    first_offset = ReadUint64(data + pos + 8);
+    pos += 16;
+  }
+  pos += 2;  // reserved
+  const uint16_t count =
+      static_cast<uint16_t>((data[pos] << 8) | data[pos + 1]);
+  pos += 2;
+  if (timescale == 0 || size < pos + count * 12u) {
+    *error = "sidx: bad timescale or truncated references";
+    return false;
+  }
+
+  uint64_t time = earliest_time;
+  uint64_t offset = anchor + first_offset;
+  for (uint16_t i = 0; i < count; i++, pos += 12) {
+    const uint32_t type_and_size = ReadUint32(data + pos);
+    const uint32_t duration = ReadUint32(data + pos + 4);
+    const uint32_t sap = ReadUint32(data + pos + 8);
+
+    SidxReference reference;
+    reference.start = static_cast<double>(time) / timescale;
+    reference.end = static_cast<double>(time + duration) / timescale;
+    reference.offset = offset;
+    reference.size = type_and_size & 0x7fffffff;
+    // SAP types 1 to 3 start with a frame that decodes on its own.
+    const uint32_t sap_type = (sap >> 28) & 0x7;
+    reference.starts_with_sap =
+        (sap & 0x80000000) != 0 && sap_type >= 1 && sap_type <= 3;
+    reference.sap_delta = static_cast<double>(sap & 0x0fffffff) / timescale;
+    references->push_back(reference);
+
+    time += duration;
+    offset += reference.size;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ParseSidx(const uint8_t* data, size_t size, uint64_t data_offset,
+               std::vector<SidxReference>* references, std::string* error) {
+  size_t pos = 0;
+  while (pos + 8 <= size) {
+    uint64_t box_size = ReadUint32(data + pos);
+    size_t header = 8;
+    if (box_size == 1) {
+      if (pos + 16 > size)
+        break;
+      box_size = ReadUint64(data + pos + 8);
+      header = 16;
+    } else if (box_size == 0) {
+      box_size = size - pos;
+    }
+    if (box_size < header || pos + box_size > size)
+      break;
+
+    if (std::equal(data + pos + 4, data + pos + 8, "sidx")) {
+      return ParseSidxBody(data + pos + header, box_size - header,
+                           data_offset + pos + box_size, references, error);
+    }
+    pos += box_size;
+  }
+  *error = "No complete sidx box in the segment index";
+  return false;
+}
+
+KeyframeIndex KeyframeIndex::FromSegments(
+    const std::vector<SegmentReference>& segments) {
+  KeyframeIndex ret;
+  for (auto& segment : segments)
+    ret.times_.push_back(segment.start);
+  std::sort(ret.times_.begin(), ret.times_.end());
+  ret.times_.erase(std::unique(ret.times_.begin(), ret.times_.end()),
+                   ret.times_.end());
+  return ret;
+}
+
+KeyframeIndex KeyframeIndex::FromSidx(
+    const std::vector<SidxReference>& references) {
+  KeyframeIndex ret;
+  for (auto& reference : references) {
+    if (reference.starts_with_sap)
+      ret.times_.push_back(reference.start + reference.sap_delta);
+  }
+  std::sort(ret.times_.begin(), ret.times_.end());
+  ret.times_.erase(std::unique(ret.times_.begin(), ret.times_.end()),
+                   ret.times_.end());
+  return ret;
+}
+
+double KeyframeIndex::AtOrBefore(double time) const {
+  if (times_.empty())
+    return time;
+  auto it = std::upper_bound(times_.begin(), times_.end(), time);
+  return it == times_.begin() ? times_.front() : *(it - 1);
+}
+
+double KeyframeIndex::Nearest(double time) const {
+  if (times_.empty())
+    return time;
+  auto it = std::lower_bound(times_.begin(), times_.end(), time);
+  if (it == times_.end())
+    return times_.back();
+  if (it == times_.begin())
+    return *it;
+  const double before = *(it - 1);
+  return time - before <= *it - time ? before : *it;
+}
+
+KeyframeIndexSet::KeyframeIndexSet(const Manifest& manifest, Fetcher fetcher)
+    : fetcher_(std::move(fetcher)), manifest_(manifest) {}
+
+KeyframeIndexSet::~KeyframeIndexSet() {}
+
+const KeyframeIndex* KeyframeIndexSet::Get(size_t representation,
+                                           std::string* error) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = indexes_.find(representation);
+  if (it != indexes_.end())
+    return it->second.get();
+  if (representation >= manifest_.representations.size()) {
+    *error = "No such representation";
+    return nullptr;
+  }
+
+  std::unique_ptr<KeyframeIndex> index(new KeyframeIndex);
+  if (!Build(&manifest_.representations[representation], index.get(), error))
+    return nullptr;
+  const KeyframeIndex* ret = index.get();
+  indexes_[representation] = std::move(index);
+  return ret;
+}
+
+bool KeyframeIndexSet::Build(Representation* representation,
+                             KeyframeIndex* index, std::string* error) {
+  if (representation->segments.empty() &&
+      !representation->playlist_url.empty()) {
+    std::string playlist;
+    if (!fetcher_(representation->playlist_url, "", &playlist, error) ||
+        !ParseHlsMediaPlaylist(representation->playlist_url, playlist,
+                               representation, &manifest_, error)) {
+      return false;
+    }
+  }
+
+  if (representation->segments.empty() && representation->index.has_range) {
+    std::string body;
+    std::vector<SidxReference> references;
+    if (!fetcher_(representation->index.url,
+                  representation->index.RangeHeader(), &body, error) ||
+        !ParseSidx(reinterpret_cast<const uint8_t*>(body.data()), body.size(),
+                   representation->index.range_start, &references, error)) {
+      return false;
+    }
+    // Like segment times from a template, sidx times are media times.
+    for (auto& reference : references) {
+      reference.start -= representation->index_time_offset;
+      reference.end -= representation->index_time_offset;
+    }
+    for (auto& reference : references) {
+      SegmentReference segment;
+      segment.url = representation->index.url;
+      segment.start = reference.start;
+      segment.end = reference.end;
+      segment.has_range = true;
+      segment.range_start = reference.offset;
+      segment.range_end = reference.offset + reference.size - 1;
+      representation->segments.push_back(segment);
+    }
+    *index = KeyframeIndex::FromSidx(references);
+  } else {
+    *index = KeyframeIndex::FromSegments(representation->segments);
+  }
+
+  if (index->empty()) {
+    *error = "No keyframes found for representation " + representation->id;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sample
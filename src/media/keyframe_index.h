@@ -0,0 +1,106 @@
+#ifndef SAMPLE_MEDIA_KEYFRAME_INDEX_H_
+#define SAMPLE_MEDIA_KEYFRAME_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+/** One entry of an ISO BMFF segment index ("sidx") box. */
+struct SidxReference {
+  double start = 0;
+  double end = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+  bool starts_with_sap = false;
+  /** Seconds from |start| to the first stream access point. */
+  double sap_delta = 0;
+};
+
+/**
+ * Parses the first sidx box in |data|, which starts at byte |data_offset| of
+ * the file.  Byte offsets in the result are absolute in the file.
+ */
+bool ParseSidx(const uint8_t* data, size_t size, uint64_t data_offset,
+               std::vector<SidxReference>* references, std::string* error);
+
+/** The times seeks can land on without decoding any earlier frames. */
+class KeyframeIndex {
+ public:
+  /**
+   * Every segment of a DASH or HLS representation starts with a keyframe, so
+   * segment start times are keyframe times.
+   */
+  static KeyframeIndex FromSegments(
+      const std::vector<SegmentReference>& segments);
+  /** Uses the stream access points a segment index declares. */
+  static KeyframeIndex FromSidx(const std::vector<SidxReference>& references);
+
+  /** The latest keyframe at or before |time|, or the first keyframe. */
+  double AtOrBefore(double time) const;
+  /** The keyframe closest to |time|; ties go to the earlier one. */
+  double Nearest(double time) const;
+
+  size_t size() const {
+    return times_.size();
+  }
+  bool empty() const {
+    return times_.empty();
+  }
+
+ private:
+  /** Sorted and unique. */
+  std::vector<double> times_;
+};
+
+/**
+ * Builds a KeyframeIndex per representation of a manifest on first use.
+ * Representations whose segments are not listed in the manifest need a
+ * fetch first: the sidx range of a single-file representation, or the media
+ * playlist of an HLS stream.
+ */
+class KeyframeIndexSet {
+ public:
+  /** Fetches |url|, or the byte |range| of it if not empty. */
+  using Fetcher = std::function<bool(const std::string& url,
+                                     const std::string& range,
+                                     std::string* body, std::string* error)>;
+
+  KeyframeIndexSet(const Manifest& manifest, Fetcher fetcher);
+  ~KeyframeIndexSet();
+
+  KeyframeIndexSet(const KeyframeIndexSet&) = delete;
+  KeyframeIndexSet& operator=(const KeyframeIndexSet&) = delete;
+
+  /**
+   * Returns the index of manifest().representations[representation],
+   * building it if needed, or null on error.  Indexes stay valid for the
+   * life of the set.
+   */
+  const KeyframeIndex* Get(size_t representation, std::string* error);
+
+  const Manifest& manifest() const {
+    return manifest_;
+  }
+
+ private:
+  bool Build(Representation* representation, KeyframeIndex* index,
+             std::string* error);
+
+  const Fetcher fetcher_;
+  std::mutex mutex_;
+  Manifest manifest_;
+  std::map<size_t, std::unique_ptr<KeyframeIndex>> indexes_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_KEYFRAME_INDEX_H_
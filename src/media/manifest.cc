@@ -0,0 +1,139 @@
+#include "media/manifest.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "media/dash_parser.h"
+#include "media/hls_parser.h"
+
+namespace sample {
+
+namespace {
+
+/** Removes "." and ".." segments from an absolute path. */
+std::string RemoveDotSegments(const std::string& path) {
+  std::vector<std::string> parts;
+  size_t pos = 0;
+  while (pos <= path.size()) {
+    const size_t slash = std::min(path.find('/', pos), path.size());
+    const std::string part = path.substr(pos, slash - pos);
+    if (part == "..") {
+      if (parts.size() > 1)
+        parts.pop_back();
+    } else if (part != "." || slash == path.size()) {
+      parts.push_back(part == "." ? "" : part);
+    }
+    pos = slash + 1;
+  }
+
+  std::string ret;
+  for (size_t i = 0; i < parts.size(); i++) {
+    if (i > 0)
+      ret += '/';
+    ret += parts[i];
+  }
+  return ret;
+}
+
+}  // namespace
+
+const char* StreamTypeName(StreamType type) {
+  switch (type) {
+    case StreamType::kVideo:
+      return "video";
+    case StreamType::kAudio:
+      return "audio";
+    case StreamType::kText:
+      return "text";
+  }
+  return "unknown";
+}
+
+std::string SegmentReference::RangeHeader() const {
+  if (!has_range)
+    return "";
+  return "bytes=" + std::to_string(range_start) + "-" +
+         std::to_string(range_end);
+}
+
+std::string Representation::FullMimeType() const {
+  if (codecs.empty())
+    return mime_type;
+  return mime_type + "; codecs=\"" + codecs + "\"";
+}
+
+std::string ResolveUrl(const std::string& base, const std::string& reference) {
+  if (reference.empty())
+    return base;
+  const size_t colon = reference.find(':');
+  if (colon != std::string::npos &&
+      reference.find_first_of("/?#") > colon) {
+    return reference;  // Already absolute.
+  }
+
+  const size_t scheme_end = base.find("://");
+  if (scheme_end == std::string::npos)
+    return reference;
+  if (reference.compare(0, 2, "//") == 0)
+    return base.substr(0, scheme_end + 1) + reference;
+
+  const size_t path_start = base.find('/', scheme_end + 3);
+  const std::string origin = base.substr(0, path_start);
+  std::string base_path =
+      path_start == std::string::npos ? "/" : base.substr(path_start);
+  base_path = base_path.substr(0, base_path.find_first_of("?#"));
+
+  if (reference[0] == '?')
+    return origin + base_path + reference;
+  const size_t query = reference.find_first_of("?#");
+  const std::string ref_path = reference.substr(0, query);
+  const std::string ref_rest =
+      query == std::string::npos ? "" : reference.substr(query);
+  const std::string path =
+      ref_path[0] == '/'
+          ? ref_path
+          : base_path.substr(0, base_path.rfind('/') + 1) + ref_path;
+  return origin + RemoveDotSegments(path) + ref_rest;
+}
+
+bool ParseManifest(const std::string& url, const std::string& body,
+                   Manifest* manifest, std::string* error) {
+  const size_t start = body.find_first_not_of(" \t\r\n\xef\xbb\xbf");
+  if (start != std::string::npos && body.compare(start, 7, "#EXTM3U") == 0)
+    return ParseHlsPlaylist(url, body, manifest, error);
+  if (start != std::string::npos && body[start] == '<')
+    return ParseDashManifest(url, body, manifest, error);
+  *error = "Unrecognized manifest format";
+  return false;
+}
+
+size_t ChooseVariant(const std::vector<Variant>& variants,
+                     double bandwidth_estimate, double upgrade_target,
+                     double downgrade_target) {
+  std::vector<size_t> sorted;
+  for (size_t i = 0; i < variants.size(); i++)
+    sorted.push_back(i);
+  std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+    return variants[a].bandwidth < variants[b].bandwidth;
+  });
+  if (sorted.empty())
+    return Variant::kNone;
+
+  // Mirrors SimpleAbrManager.chooseVariant().
+  size_t chosen = sorted[0];
+  for (size_t i = 0; i < sorted.size(); i++) {
+    const double min_bandwidth =
+        variants[sorted[i]].bandwidth / downgrade_target;
+    const double max_bandwidth =
+        i + 1 < sorted.size()
+            ? variants[sorted[i + 1]].bandwidth / upgrade_target
+            : std::numeric_limits<double>::infinity();
+    if (bandwidth_estimate >= min_bandwidth &&
+        bandwidth_estimate <= max_bandwidth) {
+      chosen = sorted[i];
+    }
+  }
+  return chosen;
+}
+
+}  // namespace sample
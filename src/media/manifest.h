@@ -0,0 +1,129 @@
+#ifndef SAMPLE_MEDIA_MANIFEST_H_
+#define SAMPLE_MEDIA_MANIFEST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+enum class StreamType {
+  kVideo,
+  kAudio,
+  kText,
+};
+
+const char* StreamTypeName(StreamType type);
+
+/** A resource, or a byte range of one, holding media for a time span. */
+struct SegmentReference {
+  /** Presentation times in seconds; zero for init segments. */
+  double start = 0;
+  double end = 0;
+  /** Absolute URL. */
+  std::string url;
+  /** Inclusive byte range, when |has_range| is set. */
+  bool has_range = false;
+  uint64_t range_start = 0;
+  uint64_t range_end = 0;
+
+  /** Returns the Range header value for this reference, or "". */
+  std::string RangeHeader() const;
+};
+
+/** One encoding of one stream, as much of it as the startup path needs. */
+struct Representation {
+  std::string id;
+  StreamType type = StreamType::kVideo;
+  /** E.g. "video/mp4".  Codecs are kept separately. */
+  std::string mime_type;
+  std::string codecs;
+  std::string language;
+  uint64_t bandwidth = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+
+  /** The init segment; the URL is empty for self-initializing segments. */
+  SegmentReference init;
+  /**
+   * For single-file representations, the segment index ("sidx") that lists
+   * the segments; |segments| stays empty until it is read.
+   */
+  SegmentReference index;
+  /**
+   * Seconds to subtract from the media times in |index| to get presentation
+   * times: the SegmentBase presentationTimeOffset.
+   */
+  double index_time_offset = 0;
+  /** For HLS, the media playlist that must be loaded to fill |segments|. */
+  std::string playlist_url;
+  std::vector<SegmentReference> segments;
+
+  /** Returns e.g. 'video/mp4; codecs="avc1.64001f"'. */
+  std::string FullMimeType() const;
+};
+
+/** A playable combination of at most one video and one audio stream. */
+struct Variant {
+  static constexpr size_t kNone = static_cast<size_t>(-1);
+
+  /** Indexes into Manifest::representations, or kNone. */
+  size_t video = kNone;
+  size_t audio = kNone;
+  /** The bit/s the player's ABR logic assigns the combination. */
+  uint64_t bandwidth = 0;
+};
+
+/** The parts of a DASH or HLS manifest the sample reasons about. */
+struct Manifest {
+  enum class Format {
+    kDash,
+    kHls,
+  };
+
+  Format format = Format::kDash;
+  std::string url;
+  bool live = false;
+  /** Presentation duration in seconds, or 0 if unknown. */
+  double duration = 0;
+  std::vector<Representation> representations;
+  /** Sorted by increasing bandwidth. */
+  std::vector<Variant> variants;
+};
+
+/** Resolves |reference| against the absolute URL |base|, as in RFC 3986. */
+std::string ResolveUrl(const std::string& base, const std::string& reference);
+
+/**
+ * Parses a DASH MPD or an HLS playlist, deciding by content.  HLS media
+ * playlists referenced by a master playlist are not loaded; see
+ * ParseHlsMediaPlaylist().
+ */
+bool ParseManifest(const std::string& url, const std::string& body,
+                   Manifest* manifest, std::string* error);
+
+/** Shaka Player's default abr.bandwidthUpgradeTarget and DowngradeTarget. */
+constexpr double kDefaultBandwidthUpgradeTarget = 0.85;
+constexpr double kDefaultBandwidthDowngradeTarget = 0.95;
+
+/**
+ * Returns the index of the variant Shaka Player's SimpleAbrManager chooses
+ * for the given bandwidth estimate in bit/s: the highest variant whose
+ * bandwidth fits the estimate with the up- and downgrade margins.  Returns
+ * Variant::kNone if there are no variants.
+ */
+size_t ChooseVariant(
+    const std::vector<Variant>& variants, double bandwidth_estimate,
+    double upgrade_target = kDefaultBandwidthUpgradeTarget,
+    double downgrade_target = kDefaultBandwidthDowngradeTarget);
+
+/**
+ * The initial bandwidth estimate, in bit/s, players are configured with so
+ * ChooseVariant() predicts their first variant.
+ */
+constexpr double kDefaultBandwidthEstimate = 1e6;
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_MANIFEST_H_
@@ -0,0 +1,246 @@
+#include "media/mini_xml.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace sample {
+
+namespace {
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else {
+    out->push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  }
+}
+
+/** Decodes entity references in |raw|; unknown entities are kept as-is. */
+std::string DecodeEntities(const std::string& raw) {
+  std::string ret;
+  ret.reserve(raw.size());
+  size_t pos = 0;
+  while (pos < raw.size()) {
+    const size_t amp = raw.find('&', pos);
+    const size_t semi =
+        amp == std::string::npos ? std::string::npos : raw.find(';', amp);
+    if (semi == std::string::npos) {
+      ret.append(raw, pos, std::string::npos);
+      break;
+    }
+    ret.append(raw, pos, amp - pos);
+    const std::string entity = raw.substr(amp + 1, semi - amp - 1);
+    if (entity == "lt") {
+      ret += '<';
+    } else if (entity == "gt") {
+      ret += '>';
+    } else if (entity == "amp") {
+      ret += '&';
+    } else if (entity == "quot") {
+      ret += '"';
+    } else if (entity == "apos") {
+      ret += '\'';
+    } else if (entity.size() > 1 && entity[0] == '#') {
+      const bool hex = entity[1] == 'x' || entity[1] == 'X';
+      AppendUtf8(static_cast<uint32_t>(std::strtoul(
+                     entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10)),
+                 &ret);
+    } else {
+      ret.append(raw, amp, semi - amp + 1);
+    }
+    pos = semi + 1;
+  }
+  return ret;
+}
+
+class Parser {
+ public:
+  explicit Parser(const std::string& document) : doc_(document), pos_(0) {}
+
+  std::unique_ptr<XmlElement> Parse(std::string* error) {
+    std::vector<XmlElement*> stack;
+    std::unique_ptr<XmlElement> root;
+    while (pos_ < doc_.size()) {
+      if (doc_[pos_] != '<') {
+        const size_t end = std::min(doc_.find('<', pos_), doc_.size());
+        if (!stack.empty())
+          stack.back()->text += DecodeEntities(doc_.substr(pos_, end - pos_));
+        pos_ = end;
+        continue;
+      }
+
+      if (Skip("<!--", "-->") || Skip("<?", "?>") || Skip("<!DOCTYPE", ">"))
+        continue;
+      if (StartsWith("<![CDATA[")) {
+        const size_t end = doc_.find("]]>", pos_);
+        if (end == std::string::npos)
+          return Fail("Unterminated CDATA section", error);
+        if (!stack.empty())
+          stack.back()->text += doc_.substr(pos_ + 9, end - pos_ - 9);
+        pos_ = end + 3;
+        continue;
+      }
+
+      if (StartsWith("</")) {
+        const size_t end = doc_.find('>', pos_);
+        if (end == std::string::npos || stack.empty())
+          return Fail("Unexpected closing tag", error);
+        std::string name = doc_.substr(pos_ + 2, end - pos_ - 2);
+        while (!name.empty() && IsSpace(name.back()))
+          name.pop_back();
+        if (name != stack.back()->name)
+          return Fail("Mismatched closing tag </" + name + ">", error);
+        stack.pop_back();
+        pos_ = end + 1;
+        continue;
+      }
+
+      std::unique_ptr<XmlElement> element(new XmlElement);
+      bool self_closing;
+      if (!ParseStartTag(element.get(), &self_closing))
+        return Fail("Malformed start tag", error);
+      XmlElement* raw = element.get();
+      if (stack.empty()) {
+        if (root)
+          return Fail("More than one root element", error);
+        root = std::move(element);
+      } else {
+        stack.back()->children.push_back(std::move(element));
+      }
+      if (!self_closing)
+        stack.push_back(raw);
+    }
+
+    if (!root || !stack.empty())
+      return Fail("Unterminated document", error);
+    return root;
+  }
+
+ private:
+  std::unique_ptr<XmlElement> Fail(const std::string& message,
+                                   std::string* error) {
+    *error = "XML: " + message;
+    return nullptr;
+  }
+
+  bool StartsWith(const char* prefix) const {
+    return doc_.compare(pos_, std::strlen(prefix), prefix) == 0;
+  }
+
+  /** Skips a construct from |open| through |close|, if one starts here. */
+  bool Skip(const char* open, const char* close) {
+    if (!StartsWith(open))
+      return false;
+    const size_t end = doc_.find(close, pos_);
+    pos_ = end == std::string::npos ? doc_.size() : end + std::strlen(close);
+    return true;
+  }
+
+  void SkipSpace() {
+    while (pos_ < doc_.size() && IsSpace(doc_[pos_]))
+      pos_++;
+  }
+
+  std::string ReadName() {
+    const size_t start = pos_;
+    while (pos_ < doc_.size() && !IsSpace(doc_[pos_]) && doc_[pos_] != '>' &&
+           doc_[pos_] != '/' && doc_[pos_] != '=') {
+      pos_++;
+    }
+    return doc_.substr(start, pos_ - start);
+  }
+
+  bool ParseStartTag(XmlElement* element, bool* self_closing) {
+    pos_++;  // '<'
+    element->name = ReadName();
+    if (element->name.empty())
+      return false;
+    while (true) {
+      SkipSpace();
+      if (pos_ >= doc_.size())
+        return false;
+      if (doc_[pos_] == '>') {
+        pos_++;
+        *self_closing = false;
+        return true;
+      }
+      if (StartsWith("/>")) {
+        pos_ += 2;
+        *self_closing = true;
+        return true;
+      }
+
+      const std::string key = ReadName();
+      SkipSpace();
+      if (key.empty() || pos_ >= doc_.size() || doc_[pos_] != '=')
+        return false;
+      pos_++;
+      SkipSpace();
+      if (pos_ >= doc_.size() || (doc_[pos_] != '"' && doc_[pos_] != '\''))
+        return false;
+      const char quote = doc_[pos_];
+      const size_t end = doc_.find(quote, pos_ + 1);
+      if (end == std::string::npos)
+        return false;
+      element->attributes[key] =
+          DecodeEntities(doc_.substr(pos_ + 1, end - pos_ - 1));
+      pos_ = end + 1;
+    }
+  }
+
+  const std::string& doc_;
+  size_t pos_;
+};
+
+}  // namespace
+
+std::string XmlElement::Attribute(const std::string& key,
+                                  const std::string& default_value) const {
+  auto it = attributes.find(key);
+  return it == attributes.end() ? default_value : it->second;
+}
+
+bool XmlElement::HasAttribute(const std::string& key) const {
+  return attributes.count(key) != 0;
+}
+
+const XmlElement* XmlElement::Child(const std::string& child_name) const {
+  for (auto& child : children) {
+    if (child->name == child_name)
+      return child.get();
+  }
+  return nullptr;
+}
+
+std::vector<const XmlElement*> XmlElement::Children(
+    const std::string& child_name) const {
+  std::vector<const XmlElement*> ret;
+  for (auto& child : children) {
+    if (child->name == child_name)
+      ret.push_back(child.get());
+  }
+  return ret;
+}
+
+std::unique_ptr<XmlElement> ParseXml(const std::string& document,
+                                     std::string* error) {
+  return Parser(document).Parse(error);
+}
+
+}  // namespace sample
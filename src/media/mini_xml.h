@@ -0,0 +1,43 @@
+#ifndef SAMPLE_MEDIA_MINI_XML_H_
+#define SAMPLE_MEDIA_MINI_XML_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/**
+ * An element of a parsed XML document.  Only what manifests use is kept:
+ * names, attributes, child elements and concatenated text.  Namespace
+ * prefixes are left on names.
+ */
+struct XmlElement {
+  std::string name;
+  std::map<std::string, std::string> attributes;
+  std::vector<std::unique_ptr<XmlElement>> children;
+  std::string text;
+
+  /** Returns the attribute, or |default_value| if it is missing. */
+  std::string Attribute(const std::string& key,
+                        const std::string& default_value = "") const;
+  bool HasAttribute(const std::string& key) const;
+
+  /** Returns the first child with the given name, or null. */
+  const XmlElement* Child(const std::string& child_name) const;
+  std::vector<const XmlElement*> Children(const std::string& child_name) const;
+};
+
+/**
+ * Parses a well-formed document without DTDs.  Comments, processing
+ * instructions and CDATA markers are skipped; the five predefined entities
+ * and numeric character references are decoded.  Returns null and fills
+ * |error| on malformed input.
+ */
+std::unique_ptr<XmlElement> ParseXml(const std::string& document,
+                                     std::string* error);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_MINI_XML_H_
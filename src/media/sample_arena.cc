@@ -0,0 +1,260 @@
+#include "media/sample_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace sample {
+
+namespace {
+
+constexpr size_t kMinClassSize = 256;
+constexpr size_t kMaxClassSize = 64 * 1024;
+/** Class sizes are multiples of this, which keeps blocks aligned. */
+constexpr size_t kClassAlignment = 64;
+/**
+ * Slabs are kept small, as a partly used slab in every class is budget that
+ * holds few samples; larger samples are rare enough to go to the heap.
+ */
+constexpr size_t kMinSlabBytes = 16 * 1024;
+constexpr size_t kMinBlocksPerSlab = 2;
+
+size_t SlabBytes(size_t class_size) {
+  return std::max(kMinSlabBytes, class_size * kMinBlocksPerSlab);
+}
+
+/**
+ * Each class is a quarter larger than the last, rounded down to the
+ * alignment, so no sample is rounded up by more than a quarter.
+ */
+std::vector<size_t> ClassSizes() {
+  std::vector<size_t> ret;
+  for (size_t size = kMinClassSize; size < kMaxClassSize;) {
+    ret.push_back(size);
+    size += size / 4;
+    size = size / kClassAlignment * kClassAlignment;
+  }
+  ret.push_back(kMaxClassSize);
+  return ret;
+}
+
+}  // namespace
+
+struct SampleArena::Slab {
+  size_t class_index;
+  size_t block_size;
+  size_t capacity;
+  size_t bytes;
+  std::unique_ptr<uint8_t[]> memory;
+  /** Freed blocks, linked through their first bytes. */
+  uint8_t* free_list;
+  /** Blocks past this one have never been handed out. */
+  size_t next_unused;
+  size_t used;
+};
+
+SampleBuffer::SampleBuffer()
+    : arena_(nullptr),
+      data_(nullptr),
+      size_(0),
+      type_(StreamType::kVideo),
+      slab_(nullptr),
+      reserved_(false) {}
+
+SampleBuffer::SampleBuffer(SampleBuffer&& other) noexcept : SampleBuffer() {
+  *this = std::move(other);
+}
+
+SampleBuffer::~SampleBuffer() {
+  Reset();
+}
+
+SampleBuffer& SampleBuffer::operator=(SampleBuffer&& other) noexcept {
+  if (this != &other) {
+    Reset();
+    std::swap(arena_, other.arena_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(type_, other.type_);
+    std::swap(slab_, other.slab_);
+    std::swap(reserved_, other.reserved_);
+  }
+  return *this;
+}
+
+void SampleBuffer::Reset() {
+  if (arena_)
+    arena_->Free(this);
+  arena_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+  slab_ = nullptr;
+  reserved_ = false;
+}
+
+SampleArena::SampleArena(uint64_t byte_budget)
+    : byte_budget_(byte_budget), class_sizes_(ClassSizes()) {
+  slabs_.resize(class_sizes_.size());
+  stats_.byte_budget = byte_budget;
+}
+
+SampleArena::~SampleArena() {}
+
+uint64_t SampleArena::PlannedCapacity(uint64_t byte_budget) {
+  uint64_t unused = 0;
+  for (size_t class_size : ClassSizes())
+    unused += SlabBytes(class_size) - class_size;
+  if (byte_budget <= unused)
+    return 0;
+  return (byte_budget - unused) * 4 / 5;
+}
+
+SampleBuffer SampleArena::Allocate(size_t size, StreamType type) {
+  SampleBuffer ret;
+  if (size == 0)
+    return ret;
+  ret.arena_ = this;
+  ret.size_ = size;
+  ret.type_ = type;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  stats_.allocations++;
+  CountInUseLocked(type, size);
+
+  auto size_class =
+      std::lower_bound(class_sizes_.begin(), class_sizes_.end(), size);
+  if (size_class == class_sizes_.end()) {
+    stats_.large_allocations++;
+    stats_.heap_allocations++;
+    ret.data_ = new uint8_t[size];
+    if (ReleaseEmptySlabsLocked(size)) {
+      ret.reserved_ = true;
+      stats_.bytes_reserved += size;
+      stats_.peak_bytes_reserved =
+          std::max(stats_.peak_bytes_reserved, stats_.bytes_reserved);
+    } else {
+      stats_.over_budget++;
+    }
+    return ret;
+  }
+
+  const size_t class_index = size_class - class_sizes_.begin();
+  std::vector<std::unique_ptr<Slab>>& slabs = slabs_[class_index];
+  // The fullest slab with room is used, so freed blocks are refilled before
+  // an empty slab is touched and the class's unused blocks stay few.
+  Slab* slab = nullptr;
+  for (auto& candidate : slabs) {
+    if (candidate->used < candidate->capacity &&
+        (!slab || candidate->used > slab->used)) {
+      slab = candidate.get();
+    }
+  }
+
+  if (!slab) {
+    const size_t bytes = SlabBytes(*size_class);
+    stats_.heap_allocations++;
+    if (!ReleaseEmptySlabsLocked(bytes)) {
+      stats_.over_budget++;
+      ret.data_ = new uint8_t[size];
+      return ret;
+    }
+
+    slabs.emplace_back(new Slab);
+    slab = slabs.back().get();
+    slab->class_index = class_index;
+    slab->block_size = *size_class;
+    slab->capacity = bytes / *size_class;
+    slab->bytes = bytes;
+    // Pages are only touched as blocks are handed out, so a fresh slab
+    // costs address space rather than resident memory.
+    slab->memory.reset(new uint8_t[bytes]);
+    slab->free_list = nullptr;
+    slab->next_unused = 0;
+    slab->used = 0;
+    stats_.bytes_reserved += bytes;
+    stats_.peak_bytes_reserved =
+        std::max(stats_.peak_bytes_reserved, stats_.bytes_reserved);
+  }
+
+  if (slab->free_list) {
+    ret.data_ = slab->free_list;
+    std::memcpy(&slab->free_list, slab->free_list, sizeof(uint8_t*));
+  } else {
+    ret.data_ = slab->memory.get() + slab->next_unused * slab->block_size;
+    slab->next_unused++;
+  }
+  slab->used++;
+  ret.slab_ = slab;
+  return ret;
+}
+
+SampleArenaStats SampleArena::stats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void SampleArena::Free(SampleBuffer* buffer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const size_t type = static_cast<size_t>(buffer->type_);
+  stats_.bytes_in_use -= buffer->size_;
+  stats_.bytes_in_use_by_type[type] -= buffer->size_;
+
+  if (!buffer->slab_) {
+    delete[] buffer->data_;
+    if (buffer->reserved_)
+      stats_.bytes_reserved -= buffer->size_;
+    return;
+  }
+
+  Slab* slab = static_cast<Slab*>(buffer->slab_);
+  std::memcpy(buffer->data_, &slab->free_list, sizeof(uint8_t*));
+  slab->free_list = buffer->data_;
+  slab->used--;
+
+  // One empty slab per class is kept so a class whose working set hovers at
+  // a slab boundary does not allocate and free a slab on every sample.
+  if (slab->used == 0) {
+    for (auto& other : slabs_[slab->class_index]) {
+      if (other.get() != slab && other->used == 0) {
+        ReleaseSlabLocked(slab);
+        break;
+      }
+    }
+  }
+}
+
+bool SampleArena::ReleaseEmptySlabsLocked(size_t bytes) {
+  for (auto& slabs : slabs_) {
+    for (size_t i = slabs.size(); i-- > 0;) {
+      if (stats_.bytes_reserved + bytes <= byte_budget_)
+        return true;
+      if (slabs[i]->used == 0)
+        ReleaseSlabLocked(slabs[i].get());
+    }
+  }
+  return stats_.bytes_reserved + bytes <= byte_budget_;
+}
+
+void SampleArena::ReleaseSlabLocked(Slab* slab) {
+  std::vector<std::unique_ptr<Slab>>& slabs = slabs_[slab->class_index];
+  for (auto it = slabs.begin(); it != slabs.end(); ++it) {
+    if (it->get() == slab) {
+      stats_.bytes_reserved -= slab->bytes;
+      slabs.erase(it);
+      return;
+    }
+  }
+}
+
+void SampleArena::CountInUseLocked(StreamType type, size_t size) {
+  const size_t index = static_cast<size_t>(type);
+  stats_.bytes_in_use += size;
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  stats_.bytes_in_use_by_type[index] += size;
+  stats_.peak_bytes_in_use_by_type[index] = std::max(
+      stats_.peak_bytes_in_use_by_type[index],
+      stats_.bytes_in_use_by_type[index]);
+}
+
+}  // namespace sample
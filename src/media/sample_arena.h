@@ -0,0 +1,140 @@
+#ifndef SAMPLE_MEDIA_SAMPLE_ARENA_H_
+#define SAMPLE_MEDIA_SAMPLE_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "media/manifest.h"
+
+namespace sample {
+
+class SampleArena;
+
+/** The number of StreamType values, for per-type counters. */
+constexpr size_t kStreamTypeCount = 3;
+
+/**
+ * The bytes of one demuxed sample, allocated from a SampleArena.  They go
+ * back to the arena when the buffer is destroyed.  May be empty.
+ */
+class SampleBuffer {
+ public:
+  SampleBuffer();
+  SampleBuffer(SampleBuffer&& other) noexcept;
+  ~SampleBuffer();
+
+  SampleBuffer& operator=(SampleBuffer&& other) noexcept;
+  SampleBuffer(const SampleBuffer&) = delete;
+  SampleBuffer& operator=(const SampleBuffer&) = delete;
+
+  uint8_t* data() const {
+    return data_;
+  }
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  friend class SampleArena;
+
+  /** Returns the bytes to the arena and leaves this empty. */
+  void Reset();
+
+  SampleArena* arena_;
+  uint8_t* data_;
+  size_t size_;
+  StreamType type_;
+  /** The slab holding the bytes, or null if they came from the heap. */
+  void* slab_;
+  /** Whether heap bytes count toward the arena's budget. */
+  bool reserved_;
+};
+
+/** Counters kept by a SampleArena. */
+struct SampleArenaStats {
+  /** Samples allocated, and the heap allocations made to hold them. */
+  uint64_t allocations = 0;
+  uint64_t heap_allocations = 0;
+  /** Samples too large for any slab, which get their own allocation. */
+  uint64_t large_allocations = 0;
+  /** Samples that did not fit in the budget and went to the heap anyway. */
+  uint64_t over_budget = 0;
+
+  /** Sample bytes currently held, in total and per StreamType. */
+  uint64_t bytes_in_use = 0;
+  uint64_t peak_bytes_in_use = 0;
+  uint64_t bytes_in_use_by_type[kStreamTypeCount] = {};
+  uint64_t peak_bytes_in_use_by_type[kStreamTypeCount] = {};
+  /**
+   * Memory reserved from the heap within the budget: slabs plus large
+   * samples.  Stays at or under |byte_budget|.
+   */
+  uint64_t bytes_reserved = 0;
+  uint64_t peak_bytes_reserved = 0;
+  uint64_t byte_budget = 0;
+};
+
+/**
+ * A slab allocator for demuxed samples with a fixed byte budget.
+ *
+ * Samples are rounded up to one of a series of size classes, each growing by
+ * a quarter, and carved from slabs of that class.  Freed samples go on the
+ * slab's free list for reuse, so steady-state buffering performs no heap
+ * allocation and long-lived samples do not fragment the heap.  Each class
+ * keeps at most one empty slab; others are returned to the heap, as are
+ * spare empty slabs of any class when the budget is needed elsewhere.
+ *
+ * Samples above the largest class get their own allocation.  When a new slab
+ * or large sample would exceed the budget the sample is still served from
+ * the heap, so playback continues, but counted as over budget.
+ */
+class SampleArena {
+ public:
+  explicit SampleArena(uint64_t byte_budget);
+  ~SampleArena();
+
+  SampleArena(const SampleArena&) = delete;
+  SampleArena& operator=(const SampleArena&) = delete;
+
+  /** Allocates |size| bytes for a sample of a stream of the given type. */
+  SampleBuffer Allocate(size_t size, StreamType type);
+
+  SampleArenaStats stats() const;
+
+  /**
+   * The sample bytes an arena of |byte_budget| bytes should be planned to
+   * hold: the budget less a partly used slab in every size class, with every
+   * sample rounded up a whole class step.
+   */
+  static uint64_t PlannedCapacity(uint64_t byte_budget);
+
+ private:
+  friend class SampleBuffer;
+
+  struct Slab;
+
+  void Free(SampleBuffer* buffer);
+  /**
+   * Frees empty slabs until |bytes| more fit in the budget.  Returns whether
+   * they do.
+   */
+  bool ReleaseEmptySlabsLocked(size_t bytes);
+  void ReleaseSlabLocked(Slab* slab);
+  /** Adds |size| bytes of |type| to the in-use counters. */
+  void CountInUseLocked(StreamType type, size_t size);
+
+  const uint64_t byte_budget_;
+  const std::vector<size_t> class_sizes_;
+
+  mutable std::mutex mutex_;
+  /** The slabs of each size class. */
+  std::vector<std::vector<std::unique_ptr<Slab>>> slabs_;
+  SampleArenaStats stats_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_SAMPLE_ARENA_H_
@@ -0,0 +1,134 @@
+#include "media/webvtt_parser.h"
+
+#include <sstream>
+
+namespace sample {
+
+namespace {
+
+bool StartsWith(const std::string& str, const char* prefix) {
+  return str.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+/** Reads a run of digits at |*pos|; false if there are none. */
+bool ReadNumber(const std::string& str, size_t* pos, double* value,
+                size_t* digits) {
+  *value = 0;
+  *digits = 0;
+  for (; *pos < str.size() && str[*pos] >= '0' && str[*pos] <= '9'; (*pos)++) {
+    *value = *value * 10 + (str[*pos] - '0');
+    (*digits)++;
+  }
+  return *digits > 0;
+}
+
+/** Parses "[hh:]mm:ss.ttt" at |*pos| into seconds. */
+bool ParseTimestamp(const std::string& str, size_t* pos, double* seconds) {
+  double parts[3];
+  size_t count = 0;
+  size_t digits;
+  while (true) {
+    if (count == 3 || !ReadNumber(str, pos, &parts[count], &digits))
+      return false;
+    count++;
+    if (*pos >= str.size() || str[*pos] != ':')
+      break;
+    (*pos)++;
+  }
+  double millis;
+  if (count < 2 || *pos >= str.size() || str[*pos] != '.')
+    return false;
+  (*pos)++;
+  if (!ReadNumber(str, pos, &millis, &digits) || digits != 3)
+    return false;
+
+  *seconds = 0;
+  for (size_t i = 0; i < count; i++)
+    *seconds = *seconds * 60 + parts[i];
+  *seconds += millis / 1000;
+  return true;
+}
+
+/** Parses "start --> end [settings]". */
+bool ParseTiming(const std::string& line, double* start, double* end) {
+  size_t pos = 0;
+  if (!ParseTimestamp(line, &pos, start))
+    return false;
+  while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+    pos++;
+  if (line.compare(pos, 3, "-->") != 0)
+    return false;
+  pos += 3;
+  while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+    pos++;
+  return ParseTimestamp(line, &pos, end) &&
+         (pos == line.size() || line[pos] == ' ' || line[pos] == '\t');
+}
+
+}  // namespace
+
+bool ParseWebVtt(const std::string& body, double offset,
+                 std::vector<Cue>* cues, std::string* error) {
+  std::istringstream stream(body);
+  std::vector<std::string> block;
+  std::string line;
+  bool header = true;
+  bool done = false;
+  while (!done) {
+    done = !std::getline(stream, line);
+    if (!done) {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (!line.empty()) {
+        block.push_back(line);
+        continue;
+      }
+    }
+    if (block.empty())
+      continue;
+
+    if (header) {
+      // A byte order mark may precede the signature.
+      std::string& signature = block[0];
+      if (StartsWith(signature, "\xEF\xBB\xBF"))
+        signature.erase(0, 3);
+      if (!StartsWith(signature, "WEBVTT") ||
+          (signature.size() > 6 && signature[6] != ' ' &&
+           signature[6] != '\t')) {
+        *error = "WebVTT: missing WEBVTT signature";
+        return false;
+      }
+      header = false;
+    } else if (!StartsWith(block[0], "NOTE") &&
+               !StartsWith(block[0], "STYLE") &&
+               !StartsWith(block[0], "REGION")) {
+      // The timing line may follow a cue identifier.
+      size_t timing = 0;
+      if (block[0].find("-->") == std::string::npos && block.size() > 1)
+        timing = 1;
+      Cue cue;
+      if (!ParseTiming(block[timing], &cue.start, &cue.end)) {
+        *error = "WebVTT: bad cue timing: " + block[timing];
+        return false;
+      }
+      cue.start += offset;
+      cue.end += offset;
+      if (timing == 1)
+        cue.id = block[0];
+      for (size_t i = timing + 1; i < block.size(); i++) {
+        if (i > timing + 1)
+          cue.payload += '\n';
+        cue.payload += block[i];
+      }
+      cues->push_back(std::move(cue));
+    }
+    block.clear();
+  }
+  if (header) {
+    *error = "WebVTT: missing WEBVTT signature";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sample
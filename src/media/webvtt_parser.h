@@ -0,0 +1,22 @@
+#ifndef SAMPLE_MEDIA_WEBVTT_PARSER_H_
+#define SAMPLE_MEDIA_WEBVTT_PARSER_H_
+
+#include <string>
+#include <vector>
+
+#include "media/cue_store.h"
+
+namespace sample {
+
+/**
+ * Parses the cues of a WebVTT file or segment and appends them to |cues|,
+ * with |offset| seconds added to their times.  Cue settings, NOTE, STYLE
+ * and REGION blocks and header metadata such as HLS's X-TIMESTAMP-MAP are
+ * ignored; payloads are kept as written, tags included.
+ */
+bool ParseWebVtt(const std::string& body, double offset,
+                 std::vector<Cue>* cues, std::string* error);
+
+}  // namespace sample
+
+#endif  // SAMPLE_MEDIA_WEBVTT_PARSER_H_
@@ -0,0 +1,297 @@
+#include "net/caching_proxy.h"
+
+#include <cstdlib>
+
+#include "net/http_client.h"
+
+namespace sample {
+
+namespace {
+
+/** Bounds the prefetch backlog so stale representations are dropped. */
+constexpr size_t kMaxQueuedPrefetchesPerSegment = 4;
+
+/**
+ * Failed guesses after which a segment name pattern with no successful
+ * guess is no longer prefetched, e.g. $Time$ names, where the next number
+ * is never the next segment.
+ */
+constexpr uint64_t kMaxPrefetchMisses = 3;
+
+/**
+ * How long a preloaded manifest may wait for its request.  The player asks
+ * within moments of Load(); an older copy may be a stale live playlist.
+ */
+constexpr std::chrono::seconds kMaxPreloadAge{5};
+
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool IsManifest(const std::string& path) {
+  return EndsWith(path, ".mpd") || EndsWith(path, ".m3u8");
+}
+
+/** A segment path split around its segment number. */
+struct NumberedPath {
+  std::string prefix;
+  uint64_t number = 0;
+  size_t width = 0;
+  std::string suffix;
+};
+
+bool SplitSegmentNumber(const std::string& path, NumberedPath* split) {
+  const size_t slash = path.rfind('/');
+  const size_t name_start = slash == std::string::npos ? 0 : slash + 1;
+  const std::string name = path.substr(name_start);
+  if (IsManifest(name) || name.find("init") != std::string::npos)
+    return false;
+
+  // Search the stem only, or ".m4s" would give a segment number of 4.
+  const char kDigits[] = "0123456789";
+  const size_t dot = name.rfind('.');
+  const size_t last_digit =
+      name.find_last_of(kDigits, dot == std::string::npos || dot == 0
+                                     ? std::string::npos
+                                     : dot - 1);
+  if (last_digit == std::string::npos)
+    return false;
+  size_t first_digit = name.find_last_not_of(kDigits, last_digit);
+  first_digit = first_digit == std::string::npos ? 0 : first_digit + 1;
+  split->width = last_digit - first_digit + 1;
+  if (split->width > 18)
+    return false;
+
+  split->number = std::strtoull(name.c_str() + first_digit, nullptr, 10);
+  split->prefix = path.substr(0, name_start + first_digit);
+  split->suffix = name.substr(last_digit + 1);
+  return true;
+}
+
+}  // namespace
+
+std::vector<std::string> NextSegmentPaths(const std::string& path,
+                                          size_t count) {
+  NumberedPath split;
+  if (count == 0 || !SplitSegmentNumber(path, &split))
+    return {};
+  std::vector<std::string> ret;
+  for (size_t i = 1; i <= count; i++) {
+    std::string digits = std::to_string(split.number + i);
+    if (digits.size() < split.width)
+      digits.insert(0, split.width - digits.size(), '0');
+    ret.push_back(split.prefix + digits + split.suffix);
+  }
+  return ret;
+}
+
+std::string SegmentPathPattern(const std::string& path) {
+  NumberedPath split;
+  if (!SplitSegmentNumber(path, &split))
+    return "";
+  return split.prefix + "*" + split.suffix;
+}
+
+CachingProxy::CachingProxy(const CachingProxyOptions& options)
+    : options_(options),
+      cache_(options.byte_budget),
+      in_flight_joins_(0),
+      shutdown_(false) {
+  if (options.prefetch_count > 0) {
+    for (size_t i = 0; i < options.prefetch_threads; i++)
+      prefetch_threads_.emplace_back(&CachingProxy::PrefetchLoop, this);
+  }
+}
+
+CachingProxy::~CachingProxy() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queue_cond_.notify_all();
+  for (auto& thread : prefetch_threads_)
+    thread.join();
+}
+
+void CachingProxy::Handle(const HttpRequest& request, HttpResponse* response) {
+  if (request.method != "GET" && request.method != "HEAD") {
+    response->status = 405;
+    return;
+  }
+
+  const std::string query = request.query.empty() ? "" : "?" + request.query;
+  const std::string range = request.Header("range");
+  std::string error;
+  std::shared_ptr<const CachedResponse> result =
+      Fetch(request.path + query, range, FetchKind::kClient, &error);
+  if (!result) {
+    response->status = 502;
+    response->SetBody(error);
+    return;
+  }
+
+  response->status = result->status;
+  response->content_type = result->content_type;
+  response->headers = result->headers;
+  response->body = result->body;
+
+  // Byte-range requests do not follow a numbered sequence, and a missing
+  // segment says nothing about the next one.
+  if (range.empty() && result->status == 200 &&
+      !prefetch_threads_.empty() && GuessesSucceed(request.path)) {
+    for (auto& next : NextSegmentPaths(request.path, options_.prefetch_count))
+      Prefetch(next + query);
+  }
+}
+
+bool CachingProxy::GuessesSucceed(const std::string& path) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = guesses_.find(SegmentPathPattern(path));
+  return it == guesses_.end() || it->second.hits > 0 ||
+         it->second.misses < kMaxPrefetchMisses;
+}
+
+void CachingProxy::Prefetch(const std::string& target) {
+  if (prefetch_threads_.empty() || cache_.Contains(target))
+    return;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (in_flight_.count(target) != 0)
+    return;
+  for (auto& queued : prefetch_queue_) {
+    if (queued == target)
+      return;
+  }
+  prefetch_queue_.push_back(target);
+  if (prefetch_queue_.size() >
+      options_.prefetch_count * kMaxQueuedPrefetchesPerSegment) {
+    prefetch_queue_.pop_front();
+  }
+  queue_cond_.notify_one();
+}
+
+bool CachingProxy::Preload(const std::string& target, const std::string& range,
+                           std::shared_ptr<const CachedResponse>* response,
+                           std::string* error) {
+  *response = Fetch(target, range, FetchKind::kPreload, error);
+  if (*response && (*response)->status != 200 && (*response)->status != 206) {
+    *error = "HTTP " + std::to_string((*response)->status) + " for " + target;
+    return false;
+  }
+  return *response != nullptr;
+}
+
+std::shared_ptr<const CachedResponse> CachingProxy::Fetch(
+    const std::string& target, const std::string& range, FetchKind kind,
+    std::string* error) {
+  const bool cacheable = !IsManifest(target.substr(0, target.find('?')));
+  const std::string key = range.empty() ? target : target + "#" + range;
+  if (cacheable && kind != FetchKind::kPrefetch) {
+    std::shared_ptr<const CachedResponse> cached =
+        kind == FetchKind::kClient ? cache_.Lookup(key) : cache_.Peek(key);
+    if (cached)
+      return cached;
+  }
+
+  std::shared_ptr<PendingFetch> pending;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cacheable && kind == FetchKind::kClient) {
+      requested_manifests_.insert(key);
+      auto preloaded = preloaded_.find(key);
+      if (preloaded != preloaded_.end()) {
+        const PreloadedManifest entry = preloaded->second;
+        preloaded_.erase(preloaded);
+        if (Clock::now() - entry.fetched <= kMaxPreloadAge)
+          return entry.response;
+      }
+    }
+
+    auto it = in_flight_.find(key);
+    if (it != in_flight_.end()) {
+      if (kind == FetchKind::kPrefetch)
+        return nullptr;
+      if (kind == FetchKind::kClient)
+        in_flight_joins_.fetch_add(1, std::memory_order_relaxed);
+      std::shared_ptr<PendingFetch> existing = it->second;
+      fetch_cond_.wait(lock, [&existing]() { return existing->done; });
+      // A request that joined a manifest preload has used it up.
+      if (!cacheable && kind == FetchKind::kClient)
+        preloaded_.erase(key);
+      if (!existing->response)
+        *error = "Upstream fetch of " + target + " failed";
+      return existing->response;
+    }
+    pending = std::make_shared<PendingFetch>();
+    in_flight_[key] = pending;
+  }
+
+  HttpResult result;
+  std::shared_ptr<CachedResponse> response;
+  const bool fetched =
+      HttpGet(options_.upstream + target, range, &result, error);
+  const bool ok = fetched && (result.status == 200 || result.status == 206);
+  if (fetched) {
+    response = std::make_shared<CachedResponse>();
+    response->status = result.status;
+    response->content_type = result.headers["content-type"];
+    auto content_range = result.headers.find("content-range");
+    if (content_range != result.headers.end())
+      response->headers["Content-Range"] = content_range->second;
+    response->body = result.body;
+
+    if (cacheable && ok) {
+      cache_.Insert(key, response,
+                    kind == FetchKind::kClient ? CacheInsertKind::kRequested
+                    : kind == FetchKind::kPrefetch
+                        ? CacheInsertKind::kPrefetched
+                        : CacheInsertKind::kPreloaded);
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A manifest the client already fetched itself will be reloaded later, and
+  // must not be answered with this copy then.
+  if (!cacheable && ok && kind == FetchKind::kPreload &&
+      requested_manifests_.count(key) == 0) {
+    preloaded_[key] = PreloadedManifest{response, Clock::now()};
+  }
+  pending->done = true;
+  pending->response = response;
+  in_flight_.erase(key);
+  fetch_cond_.notify_all();
+  return response;
+}
+
+void CachingProxy::PrefetchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queue_cond_.wait(
+        lock, [this]() { return shutdown_ || !prefetch_queue_.empty(); });
+    if (shutdown_)
+      return;
+
+    const std::string target = prefetch_queue_.front();
+    prefetch_queue_.pop_front();
+    lock.unlock();
+    std::shared_ptr<const CachedResponse> response;
+    if (!cache_.Contains(target)) {
+      std::string error;
+      response = Fetch(target, "", FetchKind::kPrefetch, &error);
+    }
+    lock.lock();
+    // Null means the fetch was skipped or failed on the network, which says
+    // nothing about the guess.
+    if (response) {
+      GuessStats& stats =
+          guesses_[SegmentPathPattern(target.substr(0, target.find('?')))];
+      if (response->status == 200)
+        stats.hits++;
+      else
+        stats.misses++;
+    }
+  }
+}
+
+}  // namespace sample
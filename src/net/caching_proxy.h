@@ -0,0 +1,152 @@
+#ifndef SAMPLE_NET_CACHING_PROXY_H_
+#define SAMPLE_NET_CACHING_PROXY_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/clock.h"
+#include "net/http_server.h"
+#include "net/segment_cache.h"
+
+namespace sample {
+
+struct CachingProxyOptions {
+  /** The origin to forward to, e.g. "http://127.0.0.1:8000". */
+  std::string upstream;
+  uint64_t byte_budget = 64 * 1024 * 1024;
+  /** How many following segments to fetch after each segment request. */
+  size_t prefetch_count = 0;
+  size_t prefetch_threads = 2;
+};
+
+/**
+ * Returns the paths of the |count| segments that follow |path| in a numbered
+ * sequence, keeping zero padding: "v/chunk-1-00004.m4s" gives
+ * "v/chunk-1-00005.m4s", ...  The last run of digits before the file
+ * extension is the segment number.  Returns nothing for manifests, init
+ * segments and names without a number.
+ */
+std::vector<std::string> NextSegmentPaths(const std::string& path,
+                                          size_t count);
+
+/**
+ * Returns |path| with its segment number replaced by '*', naming every
+ * segment NextSegmentPaths() could guess from it, or "" if it has none.
+ */
+std::string SegmentPathPattern(const std::string& path);
+
+/**
+ * An HTTP handler that forwards requests to an origin through a SegmentCache.
+ *
+ * Segment responses are cached; manifests always go to the origin so live
+ * updates are seen.  After each successful segment request the next few
+ * segments of the same representation are fetched in the background.  Names
+ * whose guesses keep failing without ever succeeding, as with time-based
+ * segment names, are no longer guessed from.  Concurrent requests for an
+ * entry that is already being fetched wait for that fetch instead of issuing
+ * their own.
+ */
+class CachingProxy : public HttpHandler {
+ public:
+  explicit CachingProxy(const CachingProxyOptions& options);
+  ~CachingProxy() override;
+
+  CachingProxy(const CachingProxy&) = delete;
+  CachingProxy& operator=(const CachingProxy&) = delete;
+
+  void Handle(const HttpRequest& request, HttpResponse* response) override;
+
+  /** Queues a background fetch of |target| unless cached or in flight. */
+  void Prefetch(const std::string& target);
+
+  /**
+   * Fetches |target| now so a later request is answered without waiting for
+   * the origin, and returns the response.  Segments go into the cache.
+   * Manifests are held for exactly one request, so later reloads of a live
+   * manifest still reach the origin; they are not held if a client already
+   * requested them, and expire after a few seconds.  A request that arrives
+   * while the preload is in flight waits for it.
+   */
+  bool Preload(const std::string& target, const std::string& range,
+               std::shared_ptr<const CachedResponse>* response,
+               std::string* error);
+
+  SegmentCacheStats cache_stats() const {
+    return cache_.stats();
+  }
+
+  /** Requests that waited for an in-flight fetch rather than the origin. */
+  uint64_t in_flight_joins() const {
+    return in_flight_joins_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /** Who a Fetch() is for. */
+  enum class FetchKind {
+    kClient,
+    kPrefetch,
+    kPreload,
+  };
+
+  /** A fetch in progress that other requests for the same key can wait on. */
+  struct PendingFetch {
+    bool done = false;
+    std::shared_ptr<const CachedResponse> response;
+  };
+
+  /** How prefetches guessed from one SegmentPathPattern() fared. */
+  struct GuessStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+  };
+
+  struct PreloadedManifest {
+    std::shared_ptr<const CachedResponse> response;
+    Clock::time_point fetched;
+  };
+
+  /**
+   * Returns the response for |target| and |range|, from the cache, an
+   * in-flight fetch or the origin.  Returns null on a network error.
+   */
+  std::shared_ptr<const CachedResponse> Fetch(const std::string& target,
+                                              const std::string& range,
+                                              FetchKind kind,
+                                              std::string* error);
+  void PrefetchLoop();
+  /** Whether prefetches guessed from |path| are still worth making. */
+  bool GuessesSucceed(const std::string& path);
+
+  const CachingProxyOptions options_;
+  SegmentCache cache_;
+  std::atomic<uint64_t> in_flight_joins_;
+
+  std::mutex mutex_;
+  /** Signalled when a fetch completes. */
+  std::condition_variable fetch_cond_;
+  /** Signalled when a prefetch is queued or on shutdown. */
+  std::condition_variable queue_cond_;
+  std::map<std::string, std::shared_ptr<PendingFetch>> in_flight_;
+  /** Preloaded manifests, each handed out once. */
+  std::map<std::string, PreloadedManifest> preloaded_;
+  /** Manifests clients have requested, which are no longer preloaded. */
+  std::set<std::string> requested_manifests_;
+  std::deque<std::string> prefetch_queue_;
+  /** Keyed by SegmentPathPattern(). */
+  std::map<std::string, GuessStats> guesses_;
+  bool shutdown_;
+  std::vector<std::thread> prefetch_threads_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_CACHING_PROXY_H_
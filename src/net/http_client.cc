@@ -0,0 +1,227 @@
+#include "net/http_client.h"
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace sample {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+/**
+ * How long a send or receive may make no progress before the fetch fails,
+ * so a stalled origin cannot hold a proxy or prefetch thread forever.
+ */
+constexpr int kSocketTimeoutSeconds = 30;
+
+/** Connects a TCP socket to |host|:|port|; returns -1 on failure. */
+int Connect(const std::string& host, uint16_t port, std::string* error) {
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  const int status = getaddrinfo(host.c_str(), std::to_string(port).c_str(),
+                                 &hints, &addresses);
+  if (status != 0) {
+    *error = "Unable to resolve " + host + ": " + gai_strerror(status);
+    return -1;
+  }
+
+  int fd = -1;
+  for (addrinfo* it = addresses; it; it = it->ai_next) {
+    fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+    if (fd < 0)
+      continue;
+    if (connect(fd, it->ai_addr, it->ai_addrlen) == 0)
+      break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0)
+    *error = "Unable to connect to " + host + ":" + std::to_string(port);
+  return fd;
+}
+
+/** Sends all of |data|, retrying short writes. */
+bool SendAll(int fd, const std::string& data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    const ssize_t count =
+        send(fd, data.data() + sent, data.size() - sent, kSendFlags);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return false;
+    sent += static_cast<size_t>(count);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool DecodeChunkedBody(const std::string& chunked, std::string* body) {
+  body->clear();
+  size_t pos = 0;
+  while (true) {
+    const size_t line_end = chunked.find("\r\n", pos);
+    if (line_end == std::string::npos)
+      return false;
+    // Chunk extensions after ';' are ignored.
+    const char* start = chunked.c_str() + pos;
+    char* end = nullptr;
+    const unsigned long long size = std::strtoull(start, &end, 16);
+    if (end == start || (*end != ';' && *end != '\r' && *end != ' '))
+      return false;
+    pos = line_end + 2;
+    if (size == 0)
+      return true;  // Trailers, if any, are ignored.
+    if (size > chunked.size() - pos ||
+        chunked.compare(pos + size, 2, "\r\n") != 0) {
+      return false;
+    }
+    body->append(chunked, pos, size);
+    pos += size + 2;
+  }
+}
+
+bool ParseHttpUrl(const std::string& url, ParsedUrl* parsed) {
+  const std::string kScheme = "http://";
+  if (url.compare(0, kScheme.size(), kScheme) != 0)
+    return false;
+
+  const size_t host_start = kScheme.size();
+  const size_t path_start = std::min(url.find('/', host_start), url.size());
+  const std::string authority =
+      url.substr(host_start, path_start - host_start);
+  const size_t colon = authority.rfind(':');
+  if (colon == std::string::npos) {
+    parsed->host = authority;
+    parsed->port = 80;
+  } else {
+    parsed->host = authority.substr(0, colon);
+    char* end = nullptr;
+    const long port = std::strtol(authority.c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || port <= 0 || port > 65535)
+      return false;
+    parsed->port = static_cast<uint16_t>(port);
+  }
+  parsed->target = path_start < url.size() ? url.substr(path_start) : "/";
+  return !parsed->host.empty();
+}
+
+bool HttpGet(const std::string& url, const std::string& range,
+             HttpResult* result, std::string* error) {
+  ParsedUrl parsed;
+  if (!ParseHttpUrl(url, &parsed)) {
+    *error = "Unsupported URL " + url;
+    return false;
+  }
+  const int fd = Connect(parsed.host, parsed.port, error);
+  if (fd < 0)
+    return false;
+
+  const timeval timeout = {kSocketTimeoutSeconds, 0};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  std::string request = "GET " + parsed.target + " HTTP/1.1\r\n" +
+                        "Host: " + parsed.host + "\r\n" +
+                        "Connection: close\r\n";
+  if (!range.empty())
+    request += "Range: " + range + "\r\n";
+  request += "\r\n";
+  if (!SendAll(fd, request)) {
+    close(fd);
+    *error = "Unable to send request for " + url;
+    return false;
+  }
+
+  // The request asked for Connection: close, so the response ends at EOF.
+  std::string response;
+  char buffer[64 * 1024];
+  ssize_t count;
+  while ((count = recv(fd, buffer, sizeof(buffer), 0)) != 0) {
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0)
+      break;
+    response.append(buffer, count);
+  }
+  close(fd);
+  if (count < 0) {
+    *error = errno == EAGAIN || errno == EWOULDBLOCK
+                 ? "Timed out reading " + url
+                 : "Connection reset while reading " + url;
+    return false;
+  }
+
+  const size_t head_end = response.find("\r\n\r\n");
+  if (head_end == std::string::npos ||
+      response.compare(0, 5, "HTTP/") != 0) {
+    *error = "Malformed response for " + url;
+    return false;
+  }
+  const size_t status_start = response.find(' ');
+  result->status = std::atoi(response.c_str() + status_start + 1);
+
+  size_t line_start = response.find("\r\n") + 2;
+  while (line_start < head_end) {
+    const size_t line_end = response.find("\r\n", line_start);
+    const std::string line = response.substr(line_start, line_end - line_start);
+    const size_t colon = line.find(':');
+    if (colon != std::string::npos) {
+      std::string name = line.substr(0, colon);
+      std::transform(name.begin(), name.end(), name.begin(),
+                     [](unsigned char c) { return std::tolower(c); });
+      const size_t value_start = line.find_first_not_of(' ', colon + 1);
+      result->headers[name] =
+          value_start == std::string::npos ? "" : line.substr(value_start);
+    }
+    line_start = line_end + 2;
+  }
+
+  std::string body = response.substr(head_end + 4);
+  // HTTP/1.1 origins may send the body in chunks; callers get it decoded.
+  auto encoding = result->headers.find("transfer-encoding");
+  if (encoding != result->headers.end()) {
+    std::string value = encoding->second;
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    if (value.find("chunked") != std::string::npos) {
+      std::string decoded;
+      if (!DecodeChunkedBody(body, &decoded)) {
+        *error = "Malformed chunked response for " + url;
+        return false;
+      }
+      body = std::move(decoded);
+      result->headers.erase(encoding);
+      result->headers.erase("content-length");
+    }
+  }
+  auto length = result->headers.find("content-length");
+  if (length != result->headers.end() &&
+      body.size() < std::strtoull(length->second.c_str(), nullptr, 10)) {
+    *error = "Truncated response for " + url;
+    return false;
+  }
+  result->body = std::make_shared<const std::string>(std::move(body));
+  return true;
+}
+
+}  // namespace sample
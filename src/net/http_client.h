@@ -0,0 +1,47 @@
+#ifndef SAMPLE_NET_HTTP_CLIENT_H_
+#define SAMPLE_NET_HTTP_CLIENT_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace sample {
+
+/** The parts of an http:// URL the client needs. */
+struct ParsedUrl {
+  std::string host;
+  uint16_t port = 80;
+  /** The path and query, always starting with '/'. */
+  std::string target;
+};
+
+/** Splits an http:// URL.  Returns false for other schemes or bad input. */
+bool ParseHttpUrl(const std::string& url, ParsedUrl* parsed);
+
+/** A fetched response.  Header names are lower-cased. */
+struct HttpResult {
+  int status = 0;
+  std::map<std::string, std::string> headers;
+  std::shared_ptr<const std::string> body;
+};
+
+/**
+ * Decodes an HTTP/1.1 chunked body into |body|.  Returns false if |chunked|
+ * is malformed or ends before the last chunk.
+ */
+bool DecodeChunkedBody(const std::string& chunked, std::string* body);
+
+/**
+ * Performs a blocking GET of |url| on a new connection.  |range| is sent as
+ * the Range header if not empty.  Chunked responses are decoded, and the
+ * fetch fails if the origin stalls for 30 seconds.  Returns false and fills
+ * |error| if no complete response was received; HTTP error statuses are not
+ * failures.
+ */
+bool HttpGet(const std::string& url, const std::string& range,
+             HttpResult* result, std::string* error);
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_HTTP_CLIENT_H_
@@ -0,0 +1,344 @@
+#include "net/http_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace sample {
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+/** Body writes are split so pacing and resets act at a fine granularity. */
+constexpr size_t kWriteChunkSize = 16 * 1024;
+/** Requests with a larger header block are rejected. */
+constexpr size_t kMaxHeaderSize = 64 * 1024;
+/** Idle keep-alive connections are closed after this long. */
+constexpr int kIdleTimeoutSeconds = 30;
+/** The pause after accept() fails for lack of a resource. */
+constexpr int kAcceptRetryMs = 50;
+
+std::string ToLower(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+
+std::string Trim(const std::string& str) {
+  const size_t start = str.find_first_not_of(" \t");
+  if (start == std::string::npos)
+    return "";
+  const size_t end = str.find_last_not_of(" \t");
+  return str.substr(start, end - start + 1);
+}
+
+const char* StatusText(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 206:
+      return "Partial Content";
+    case 400:
+      return "Bad Request";
+    case 403:
+      return "Forbidden";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 416:
+      return "Range Not Satisfiable";
+    case 500:
+      return "Internal Server Error";
+    case 502:
+      return "Bad Gateway";
+    case 503:
+      return "Service Unavailable";
+    default:
+      return "Unknown";
+  }
+}
+
+bool SendAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(fd, data, size, kSendFlags);
+    if (sent <= 0)
+      return false;
+    data += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+/**
+ * Parses the request header block in |head|.  Returns false if the request
+ * line is malformed.
+ */
+bool ParseRequest(const std::string& head, HttpRequest* request) {
+  size_t line_end = head.find("\r\n");
+  const std::string request_line = head.substr(0, line_end);
+  const size_t first_space = request_line.find(' ');
+  const size_t second_space = request_line.find(' ', first_space + 1);
+  if (first_space == std::string::npos || second_space == std::string::npos)
+    return false;
+
+  request->method = request_line.substr(0, first_space);
+  const std::string target =
+      request_line.substr(first_space + 1, second_space - first_space - 1);
+  const size_t query_start = target.find('?');
+  request->path = target.substr(0, query_start);
+  if (query_start != std::string::npos)
+    request->query = target.substr(query_start + 1);
+
+  while (line_end != std::string::npos && line_end + 2 < head.size()) {
+    const size_t start = line_end + 2;
+    line_end = head.find("\r\n", start);
+    const std::string line = head.substr(start, line_end - start);
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos)
+      continue;
+    request->headers[ToLower(Trim(line.substr(0, colon)))] =
+        Trim(line.substr(colon + 1));
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string HttpRequest::Header(const std::string& name) const {
+  auto it = headers.find(name);
+  return it == headers.end() ? "" : it->second;
+}
+
+void HttpResponse::SetBody(std::string data) {
+  body = std::make_shared<const std::string>(std::move(data));
+}
+
+HttpServer::HttpServer(HttpHandler* handler)
+    : handler_(handler), listen_fd_(-1), port_(0), stopping_(false) {}
+
+HttpServer::~HttpServer() {
+  Stop();
+}
+
+bool HttpServer::Start(uint16_t port, std::string* error) {
+  listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+  if (listen_fd_ < 0) {
+    *error = std::string("socket: ") + std::strerror(errno);
+    return false;
+  }
+  const int enable = 1;
+  setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      listen(listen_fd_, SOMAXCONN) != 0) {
+    *error = "Unable to listen on port " + std::to_string(port) + ": " +
+             std::strerror(errno);
+    close(listen_fd_);
+    listen_fd_ = -1;
+    return false;
+  }
+
+  socklen_t addr_size = sizeof(addr);
+  getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_size);
+  port_ = ntohs(addr.sin_port);
+  accept_thread_ = std::thread(&HttpServer::AcceptLoop, this);
+  return true;
+}
+
+void HttpServer::Stop() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_ || listen_fd_ < 0)
+      return;
+    stopping_ = true;
+    // Shutting the sockets down wakes the threads blocked on them.
+    shutdown(listen_fd_, SHUT_RDWR);
+    for (auto& connection : connections_) {
+      if (connection->fd >= 0)
+        shutdown(connection->fd, SHUT_RDWR);
+    }
+  }
+
+  accept_thread_.join();
+  close(listen_fd_);
+  listen_fd_ = -1;
+
+  std::list<std::unique_ptr<Connection>> connections;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    connections.swap(connections_);
+  }
+  for (auto& connection : connections) {
+    connection->thread.join();
+    if (connection->fd >= 0)
+      close(connection->fd);
+  }
+}
+
+std::string HttpServer::BaseUrl() const {
+  return "http://127.0.0.1:" + std::to_string(port_);
+}
+
+void HttpServer::AcceptLoop() {
+  while (true) {
+    const int fd = accept(listen_fd_, nullptr, nullptr);
+    const int accept_error = errno;
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+      if (fd >= 0)
+        close(fd);
+      return;
+    }
+    if (fd < 0) {
+      // Out of descriptors or memory, accept() fails at once until a
+      // connection closes, so wait rather than spin.
+      if (accept_error != EINTR && accept_error != ECONNABORTED) {
+        lock.unlock();
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kAcceptRetryMs));
+      }
+      continue;
+    }
+
+    const int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    timeval timeout = {kIdleTimeoutSeconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    JoinFinishedLocked();
+    connections_.emplace_back(new Connection);
+    Connection* connection = connections_.back().get();
+    connection->fd = fd;
+    connection->thread =
+        std::thread(&HttpServer::ServeConnection, this, connection);
+  }
+}
+
+void HttpServer::ServeConnection(Connection* connection) {
+  const int fd = connection->fd;
+  std::string buffer;
+  bool keep_alive = true;
+  bool reset = false;
+  while (keep_alive) {
+    // Read until the end of the header block.
+    size_t head_end;
+    while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+      if (buffer.size() > kMaxHeaderSize) {
+        keep_alive = false;
+        break;
+      }
+      char chunk[4096];
+      const ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+      if (count <= 0) {
+        keep_alive = false;
+        break;
+      }
+      buffer.append(chunk, count);
+    }
+    if (!keep_alive)
+      break;
+
+    HttpRequest request;
+    const bool parsed = ParseRequest(buffer.substr(0, head_end), &request);
+    buffer.erase(0, head_end + 4);
+
+    // Request bodies are not used by any handler, so they are discarded.
+    const size_t body_size =
+        std::strtoull(request.Header("content-length").c_str(), nullptr, 10);
+    while (buffer.size() < body_size) {
+      char chunk[4096];
+      const ssize_t count = recv(fd, chunk, sizeof(chunk), 0);
+      if (count <= 0)
+        break;
+      buffer.append(chunk, count);
+    }
+    buffer.erase(0, std::min(body_size, buffer.size()));
+
+    HttpResponse response;
+    if (parsed) {
+      handler_->Handle(request, &response);
+    } else {
+      response.status = 400;
+    }
+    reset = response.reset_connection;
+    keep_alive = parsed && ToLower(request.Header("connection")) != "close" &&
+                 !reset;
+
+    const size_t size = response.body ? response.body->size() : 0;
+    std::string head = "HTTP/1.1 " + std::to_string(response.status) + " " +
+                       StatusText(response.status) + "\r\n";
+    if (!response.content_type.empty())
+      head += "Content-Type: " + response.content_type + "\r\n";
+    for (auto& header : response.headers)
+      head += header.first + ": " + header.second + "\r\n";
+    head += "Content-Length: " + std::to_string(size) + "\r\n";
+    head += keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    head += "\r\n";
+    if (!SendAll(fd, head.data(), head.size()))
+      break;
+    if (request.method == "HEAD" || size == 0)
+      continue;
+
+    // A reset sends half the body and then drops the connection.
+    const size_t to_send = reset ? size / 2 : size;
+    for (size_t offset = 0; offset < to_send; offset += kWriteChunkSize) {
+      const size_t chunk = std::min(kWriteChunkSize, to_send - offset);
+      if (response.before_write)
+        response.before_write(chunk);
+      if (!SendAll(fd, response.body->data() + offset, chunk)) {
+        keep_alive = false;
+        break;
+      }
+    }
+  }
+
+  if (reset) {
+    // Closing with a zero linger time makes the peer see a reset rather than
+    // a clean close.  The lock keeps Stop() from using the closed descriptor.
+    linger no_linger = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_LINGER, &no_linger, sizeof(no_linger));
+    std::unique_lock<std::mutex> lock(mutex_);
+    close(fd);
+    connection->fd = -1;
+  } else {
+    // The descriptor is closed once the thread is joined, so Stop() never
+    // shuts down a descriptor number that has since been reused.
+    shutdown(fd, SHUT_RDWR);
+  }
+  connection->done = true;
+}
+
+void HttpServer::JoinFinishedLocked() {
+  for (auto it = connections_.begin(); it != connections_.end();) {
+    if ((*it)->done) {
+      (*it)->thread.join();
+      if ((*it)->fd >= 0)
+        close((*it)->fd);
+      it = connections_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace sample
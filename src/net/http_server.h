@@ -0,0 +1,107 @@
+#ifndef SAMPLE_NET_HTTP_SERVER_H_
+#define SAMPLE_NET_HTTP_SERVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace sample {
+
+/** A parsed HTTP request.  Header names are lower-cased. */
+struct HttpRequest {
+  std::string method;
+  /** The request target without the query string, e.g. "/video/seg-1.m4s". */
+  std::string path;
+  std::string query;
+  std::map<std::string, std::string> headers;
+
+  /** Returns the value of header |name| (lower-case), or "" if missing. */
+  std::string Header(const std::string& name) const;
+};
+
+/** The response a handler fills in; the server serializes it. */
+struct HttpResponse {
+  int status = 200;
+  std::string content_type;
+  /** Extra headers; Content-Type and Content-Length are added by the server. */
+  std::map<std::string, std::string> headers;
+  /** The body.  Shared so cached bodies are not copied per response. */
+  std::shared_ptr<const std::string> body;
+
+  /**
+   * If set, called with the size of each chunk of the body before it is
+   * written.  Used to pace responses to a bandwidth limit.
+   */
+  std::function<void(size_t bytes)> before_write;
+  /**
+   * If true, the connection is closed half-way through the body, which the
+   * client sees as a reset.
+   */
+  bool reset_connection = false;
+
+  void SetBody(std::string data);
+};
+
+/** Produces responses; called concurrently from connection threads. */
+class HttpHandler {
+ public:
+  virtual ~HttpHandler() {}
+
+  virtual void Handle(const HttpRequest& request, HttpResponse* response) = 0;
+};
+
+/**
+ * A small HTTP/1.1 server bound to the loopback interface.  Each connection
+ * is served on its own thread and kept alive between requests.
+ */
+class HttpServer {
+ public:
+  explicit HttpServer(HttpHandler* handler);
+  ~HttpServer();
+
+  HttpServer(const HttpServer&) = delete;
+  HttpServer& operator=(const HttpServer&) = delete;
+
+  /** Starts listening on 127.0.0.1:|port|; a port of 0 picks a free one. */
+  bool Start(uint16_t port, std::string* error);
+
+  /** Stops accepting, closes every connection and joins all threads. */
+  void Stop();
+
+  uint16_t port() const {
+    return port_;
+  }
+
+  /** Returns e.g. "http://127.0.0.1:8000" with no trailing slash. */
+  std::string BaseUrl() const;
+
+ private:
+  struct Connection {
+    int fd;
+    std::thread thread;
+    std::atomic<bool> done{false};
+  };
+
+  void AcceptLoop();
+  void ServeConnection(Connection* connection);
+  void JoinFinishedLocked();
+
+  HttpHandler* const handler_;
+  int listen_fd_;
+  uint16_t port_;
+  std::thread accept_thread_;
+
+  std::mutex mutex_;
+  std::list<std::unique_ptr<Connection>> connections_;
+  bool stopping_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_HTTP_SERVER_H_
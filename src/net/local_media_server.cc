@@ -0,0 +1,17 @@
+#include "net/local_media_server.h"
+
+namespace sample {
+
+LocalMediaServer::LocalMediaServer(const std::string& root,
+                                   const NetworkConditions& conditions)
+    : files_(root), conditioned_(conditions, &files_), server_(&conditioned_) {}
+
+std::string LocalMediaServer::ResolveUrl(const std::string& path_or_url) const {
+  if (path_or_url.find("://") != std::string::npos)
+    return path_or_url;
+  if (!path_or_url.empty() && path_or_url[0] == '/')
+    return BaseUrl() + path_or_url;
+  return BaseUrl() + "/" + path_or_url;
+}
+
+}  // namespace sample
@@ -0,0 +1,53 @@
+#ifndef SAMPLE_NET_LOCAL_MEDIA_SERVER_H_
+#define SAMPLE_NET_LOCAL_MEDIA_SERVER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "net/http_server.h"
+#include "net/network_conditions.h"
+#include "net/static_file_handler.h"
+
+namespace sample {
+
+/**
+ * A stand-in for a CDN: serves a directory of generated media over loopback
+ * HTTP with simulated latency, bandwidth limits and failures.
+ */
+class LocalMediaServer {
+ public:
+  LocalMediaServer(const std::string& root,
+                   const NetworkConditions& conditions);
+
+  LocalMediaServer(const LocalMediaServer&) = delete;
+  LocalMediaServer& operator=(const LocalMediaServer&) = delete;
+
+  bool Start(uint16_t port, std::string* error) {
+    return server_.Start(port, error);
+  }
+  void Stop() {
+    server_.Stop();
+  }
+
+  std::string BaseUrl() const {
+    return server_.BaseUrl();
+  }
+  NetworkStats stats() const {
+    return conditioned_.stats();
+  }
+
+  /**
+   * Returns |path_or_url| unchanged if it is an absolute URL, otherwise the
+   * URL of that path on this server.
+   */
+  std::string ResolveUrl(const std::string& path_or_url) const;
+
+ private:
+  StaticFileHandler files_;
+  ConditionedHandler conditioned_;
+  HttpServer server_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_LOCAL_MEDIA_SERVER_H_
@@ -0,0 +1,164 @@
+#include "net/network_conditions.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "base/flags.h"
+
+namespace sample {
+
+namespace {
+
+// Distinguishes the independent random draws made for one request.
+constexpr uint64_t kJitterDraw = 1;
+constexpr uint64_t kFailureDraw = 2;
+
+uint64_t HashString(const std::string& str) {
+  // 64-bit FNV-1a; unlike std::hash it is the same on every platform.
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+uint64_t SplitMix64(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ull;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+}  // namespace
+
+const char kNetworkConditionsUsage[] =
+    "  --latency-ms=MS        Delay before each response starts\n"
+    "  --jitter-ms=MS         Extra random delay per request, 0 to MS\n"
+    "  --bandwidth-kbps=KBPS  Shared link rate for response bodies\n"
+    "  --failure-rate=P       Probability in [0,1] that a request fails\n"
+    "  --failure-filter=STR   Only paths containing STR may fail\n"
+    "  --failure-mode=MODE    'status' (HTTP 503) or 'reset' (drop mid-body)\n"
+    "  --seed=N               Seed for jitter and failure draws\n";
+
+bool NetworkConditionsFromFlags(const Flags& flags,
+                                NetworkConditions* conditions,
+                                std::string* error) {
+  conditions->latency_ms = flags.GetDouble("latency-ms", 0);
+  conditions->jitter_ms = flags.GetDouble("jitter-ms", 0);
+  conditions->bandwidth_kbps = flags.GetDouble("bandwidth-kbps", 0);
+  conditions->failure_rate = flags.GetDouble("failure-rate", 0);
+  conditions->failure_filter = flags.GetString("failure-filter", "");
+  conditions->seed = static_cast<uint64_t>(flags.GetInt("seed", 1));
+
+  const std::string mode = flags.GetString("failure-mode", "status");
+  if (mode == "status") {
+    conditions->failure_mode = FailureMode::kStatus;
+  } else if (mode == "reset") {
+    conditions->failure_mode = FailureMode::kReset;
+  } else {
+    *error = "--failure-mode must be 'status' or 'reset'";
+    return false;
+  }
+
+  if (conditions->latency_ms < 0 || conditions->jitter_ms < 0 ||
+      conditions->bandwidth_kbps < 0) {
+    *error = "Latency, jitter and bandwidth must not be negative";
+    return false;
+  }
+  if (conditions->failure_rate < 0 || conditions->failure_rate > 1) {
+    *error = "--failure-rate must be between 0 and 1";
+    return false;
+  }
+  return true;
+}
+
+LinkPacer::LinkPacer(double bytes_per_second)
+    : bytes_per_second_(bytes_per_second), next_free_(Clock::now()) {}
+
+void LinkPacer::Consume(size_t bytes) {
+  Clock::time_point done;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const Clock::time_point start = std::max(Clock::now(), next_free_);
+    next_free_ = start + SecondsToDuration(bytes / bytes_per_second_);
+    done = next_free_;
+  }
+  std::this_thread::sleep_until(done);
+}
+
+ConditionedHandler::ConditionedHandler(const NetworkConditions& conditions,
+                                       HttpHandler* inner)
+    : conditions_(conditions),
+      inner_(inner),
+      requests_(0),
+      failures_(0),
+      bytes_sent_(0) {
+  if (conditions.bandwidth_kbps > 0)
+    pacer_.reset(new LinkPacer(conditions.bandwidth_kbps * 1000 / 8));
+}
+
+void ConditionedHandler::Handle(const HttpRequest& request,
+                                HttpResponse* response) {
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  uint64_t occurrence;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    occurrence = occurrences_[request.path]++;
+  }
+
+  const double delay_ms = DelayMs(request.path, occurrence);
+  if (delay_ms > 0)
+    std::this_thread::sleep_for(SecondsToDuration(delay_ms / 1000));
+
+  const bool fail = Fails(request.path, occurrence);
+  if (fail) {
+    failures_.fetch_add(1, std::memory_order_relaxed);
+    if (conditions_.failure_mode == FailureMode::kStatus) {
+      response->status = conditions_.failure_status;
+      return;
+    }
+  }
+
+  inner_->Handle(request, response);
+  response->reset_connection = fail;
+  response->before_write = [this](size_t bytes) {
+    bytes_sent_.fetch_add(bytes, std::memory_order_relaxed);
+    if (pacer_)
+      pacer_->Consume(bytes);
+  };
+}
+
+NetworkStats ConditionedHandler::stats() const {
+  NetworkStats ret;
+  ret.requests = requests_.load(std::memory_order_relaxed);
+  ret.failures = failures_.load(std::memory_order_relaxed);
+  ret.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+  return ret;
+}
+
+double ConditionedHandler::DelayMs(const std::string& path,
+                                   uint64_t occurrence) const {
+  return conditions_.latency_ms +
+         conditions_.jitter_ms * Random(path, occurrence, kJitterDraw);
+}
+
+bool ConditionedHandler::Fails(const std::string& path,
+                               uint64_t occurrence) const {
+  const bool eligible =
+      conditions_.failure_filter.empty() ||
+      path.find(conditions_.failure_filter) != std::string::npos;
+  return eligible && conditions_.failure_rate > 0 &&
+         Random(path, occurrence, kFailureDraw) < conditions_.failure_rate;
+}
+
+double ConditionedHandler::Random(const std::string& path, uint64_t occurrence,
+                                  uint64_t purpose) const {
+  uint64_t value = SplitMix64(conditions_.seed ^ HashString(path));
+  value = SplitMix64(value ^ occurrence);
+  value = SplitMix64(value ^ purpose);
+  // Use the top 53 bits to build a double in [0, 1).
+  return (value >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}  // namespace sample
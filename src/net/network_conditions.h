@@ -0,0 +1,121 @@
+#ifndef SAMPLE_NET_NETWORK_CONDITIONS_H_
+#define SAMPLE_NET_NETWORK_CONDITIONS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "base/clock.h"
+#include "net/http_server.h"
+
+namespace sample {
+
+class Flags;
+
+/** How an injected failure shows up to the client. */
+enum class FailureMode {
+  /** The server answers with an error status and no body. */
+  kStatus,
+  /** The connection is dropped half-way through the body. */
+  kReset,
+};
+
+/** Simulated network behaviour applied to every response. */
+struct NetworkConditions {
+  /** Delay before each response starts, i.e. added time to first byte. */
+  double latency_ms = 0;
+  /** Extra delay drawn uniformly from [0, jitter_ms] per request. */
+  double jitter_ms = 0;
+  /** Rate of the link shared by all response bodies; 0 means unlimited. */
+  double bandwidth_kbps = 0;
+  /** Probability in [0, 1] that an eligible request fails. */
+  double failure_rate = 0;
+  /** Only paths containing this substring may fail; empty means all paths. */
+  std::string failure_filter;
+  FailureMode failure_mode = FailureMode::kStatus;
+  int failure_status = 503;
+  /** Seeds the per-request random draws so runs are reproducible. */
+  uint64_t seed = 1;
+};
+
+/** Flag documentation for NetworkConditionsFromFlags(), for usage strings. */
+extern const char kNetworkConditionsUsage[];
+
+/**
+ * Reads --latency-ms, --jitter-ms, --bandwidth-kbps, --failure-rate,
+ * --failure-filter, --failure-mode and --seed.  Returns false and fills
+ * |error| on an invalid value.
+ */
+bool NetworkConditionsFromFlags(const Flags& flags,
+                                NetworkConditions* conditions,
+                                std::string* error);
+
+/** Counters kept by a ConditionedHandler. */
+struct NetworkStats {
+  uint64_t requests = 0;
+  uint64_t failures = 0;
+  uint64_t bytes_sent = 0;
+};
+
+/**
+ * Serializes body bytes through a single simulated link of fixed rate, so
+ * concurrent responses share the bandwidth the way they would on a real link.
+ */
+class LinkPacer {
+ public:
+  explicit LinkPacer(double bytes_per_second);
+
+  /** Blocks until the link has had time to carry |bytes| more bytes. */
+  void Consume(size_t bytes);
+
+ private:
+  const double bytes_per_second_;
+  std::mutex mutex_;
+  Clock::time_point next_free_;
+};
+
+/**
+ * Wraps another handler and applies NetworkConditions to its responses.
+ *
+ * Random draws depend only on the seed, the request path and how many times
+ * that path has been requested, so a run is reproducible even when requests
+ * arrive in a different order.
+ */
+class ConditionedHandler : public HttpHandler {
+ public:
+  ConditionedHandler(const NetworkConditions& conditions, HttpHandler* inner);
+
+  void Handle(const HttpRequest& request, HttpResponse* response) override;
+
+  NetworkStats stats() const;
+
+  /**
+   * The delay before, and whether to fail, the response to the request of
+   * |path| made |occurrence| times before.
+   */
+  double DelayMs(const std::string& path, uint64_t occurrence) const;
+  bool Fails(const std::string& path, uint64_t occurrence) const;
+
+ private:
+  /** Returns a uniform value in [0, 1) for the given draw. */
+  double Random(const std::string& path, uint64_t occurrence,
+                uint64_t purpose) const;
+
+  const NetworkConditions conditions_;
+  HttpHandler* const inner_;
+  std::unique_ptr<LinkPacer> pacer_;
+
+  std::mutex mutex_;
+  std::map<std::string, uint64_t> occurrences_;
+
+  std::atomic<uint64_t> requests_;
+  std::atomic<uint64_t> failures_;
+  std::atomic<uint64_t> bytes_sent_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_NETWORK_CONDITIONS_H_
@@ -0,0 +1,83 @@
+#include "net/segment_cache.h"
+
+#include <iterator>
+
+namespace sample {
+
+SegmentCache::SegmentCache(uint64_t byte_budget) : byte_budget_(byte_budget) {
+  stats_.byte_budget = byte_budget;
+}
+
+std::shared_ptr<const CachedResponse> SegmentCache::Lookup(
+    const std::string& key) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    stats_.misses++;
+    return nullptr;
+  }
+
+  lru_.splice(lru_.begin(), lru_, it->second);
+  Entry& entry = *it->second;
+  stats_.hits++;
+  stats_.bytes_saved += entry.size;
+  if (entry.unused) {
+    entry.unused = false;
+    if (entry.kind == CacheInsertKind::kPrefetched)
+      stats_.prefetch_hits++;
+    else
+      stats_.preload_hits++;
+  }
+  return entry.response;
+}
+
+std::shared_ptr<const CachedResponse> SegmentCache::Peek(
+    const std::string& key) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  return it == index_.end() ? nullptr : it->second->response;
+}
+
+bool SegmentCache::Contains(const std::string& key) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return index_.count(key) != 0;
+}
+
+void SegmentCache::Insert(const std::string& key,
+                          std::shared_ptr<const CachedResponse> response,
+                          CacheInsertKind kind) {
+  const uint64_t size = response->body ? response->body->size() : 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto existing = index_.find(key);
+  if (existing != index_.end())
+    EraseLocked(existing->second);
+  if (size > byte_budget_)
+    return;
+
+  while (stats_.bytes_cached + size > byte_budget_) {
+    EraseLocked(std::prev(lru_.end()));
+    stats_.evictions++;
+  }
+
+  const bool ahead = kind != CacheInsertKind::kRequested;
+  lru_.push_front(Entry{key, std::move(response), size, kind, ahead});
+  index_[key] = lru_.begin();
+  stats_.bytes_cached += size;
+  if (kind == CacheInsertKind::kPrefetched)
+    stats_.prefetched++;
+  else if (kind == CacheInsertKind::kPreloaded)
+    stats_.preloaded++;
+}
+
+SegmentCacheStats SegmentCache::stats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void SegmentCache::EraseLocked(std::list<Entry>::iterator it) {
+  stats_.bytes_cached -= it->size;
+  index_.erase(it->key);
+  lru_.erase(it);
+}
+
+}  // namespace sample
@@ -0,0 +1,101 @@
+#ifndef SAMPLE_NET_SEGMENT_CACHE_H_
+#define SAMPLE_NET_SEGMENT_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace sample {
+
+/** A response held by the SegmentCache. */
+struct CachedResponse {
+  int status = 200;
+  std::string content_type;
+  /** Headers to replay, e.g. Content-Range. */
+  std::map<std::string, std::string> headers;
+  std::shared_ptr<const std::string> body;
+};
+
+/** Why an entry was put in a SegmentCache. */
+enum class CacheInsertKind {
+  /** A client asked for it. */
+  kRequested,
+  /** Fetched in the background, ahead of a predicted request. */
+  kPrefetched,
+  /** Fetched ahead of a known request, e.g. by fast start. */
+  kPreloaded,
+};
+
+/** Counters kept by a SegmentCache. */
+struct SegmentCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  /** Body bytes served from memory instead of the origin. */
+  uint64_t bytes_saved = 0;
+  /** Entries inserted by a prefetch, and how many were later hit. */
+  uint64_t prefetched = 0;
+  uint64_t prefetch_hits = 0;
+  /** Likewise for preloads. */
+  uint64_t preloaded = 0;
+  uint64_t preload_hits = 0;
+  uint64_t evictions = 0;
+  /** Bytes currently held, and the budget they must stay under. */
+  uint64_t bytes_cached = 0;
+  uint64_t byte_budget = 0;
+};
+
+/**
+ * An in-memory response cache bounded by total body bytes.  When an insert
+ * would exceed the budget, least recently used entries are evicted until it
+ * fits; an entry larger than the whole budget is not cached.
+ */
+class SegmentCache {
+ public:
+  explicit SegmentCache(uint64_t byte_budget);
+
+  SegmentCache(const SegmentCache&) = delete;
+  SegmentCache& operator=(const SegmentCache&) = delete;
+
+  /** Returns the entry for |key| and marks it recently used, or null. */
+  std::shared_ptr<const CachedResponse> Lookup(const std::string& key);
+
+  /** Returns the entry for |key| or null, without counting or reordering. */
+  std::shared_ptr<const CachedResponse> Peek(const std::string& key) const;
+
+  /** Returns whether |key| is cached, without counting a hit or miss. */
+  bool Contains(const std::string& key) const;
+
+  /** Adds or replaces the entry for |key|. */
+  void Insert(const std::string& key,
+              std::shared_ptr<const CachedResponse> response,
+              CacheInsertKind kind);
+
+  SegmentCacheStats stats() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const CachedResponse> response;
+    uint64_t size;
+    CacheInsertKind kind;
+    /** Inserted ahead of a request that has not come yet. */
+    bool unused;
+  };
+
+  void EraseLocked(std::list<Entry>::iterator it);
+
+  const uint64_t byte_budget_;
+  mutable std::mutex mutex_;
+  /** Most recently used first. */
+  std::list<Entry> lru_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+  SegmentCacheStats stats_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_SEGMENT_CACHE_H_
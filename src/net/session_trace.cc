@@ -0,0 +1,238 @@
+#include "net/session_trace.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+namespace sample {
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'P', 'T', 'R'};
+constexpr uint64_t kVersion = 1;
+
+void PutVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void PutString(const std::string& value, std::string* out) {
+  PutVarint(value.size(), out);
+  out->append(value);
+}
+
+void PutDouble(double value, std::string* out) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; i++)
+    out->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+}
+
+/** Reads the encoding above, failing once on the first malformed field. */
+class TraceReader {
+ public:
+  TraceReader(const std::string& data, size_t pos) : data_(data), pos_(pos) {}
+
+  bool ok() const {
+    return ok_;
+  }
+  bool done() const {
+    return pos_ == data_.size();
+  }
+
+  uint64_t Varint() {
+    uint64_t ret = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (!Require(1))
+        return 0;
+      const uint8_t byte = static_cast<uint8_t>(data_[pos_++]);
+      ret |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return ret;
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  std::string String() {
+    const uint64_t size = Varint();
+    if (!Require(size))
+      return "";
+    std::string ret = data_.substr(pos_, size);
+    pos_ += size;
+    return ret;
+  }
+
+  double Double() {
+    if (!Require(8))
+      return 0;
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++)
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(data_[pos_ + i]))
+              << (8 * i);
+    pos_ += 8;
+    double ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+  }
+
+  /** Reads a count of items, each at least one byte, that must fit. */
+  uint64_t Count() {
+    const uint64_t count = Varint();
+    return Require(count) ? count : 0;
+  }
+
+ private:
+  bool Require(uint64_t bytes) {
+    if (ok_ && data_.size() - pos_ < bytes)
+      ok_ = false;
+    return ok_;
+  }
+
+  const std::string& data_;
+  size_t pos_;
+  bool ok_ = true;
+};
+
+}  // namespace
+
+bool WriteTrace(const SessionTrace& trace, const std::string& path,
+                std::string* error) {
+  std::string out(kMagic, sizeof(kMagic));
+  PutVarint(kVersion, &out);
+  PutString(trace.manifest_target, &out);
+  PutDouble(trace.playback_rate, &out);
+  PutDouble(trace.bandwidth_estimate, &out);
+  PutVarint(trace.duration_us, &out);
+
+  // Body 0 stands for no body.
+  std::unordered_map<std::string_view, uint64_t> body_ids;
+  std::vector<const std::string*> bodies;
+  std::vector<uint64_t> response_bodies;
+  for (auto& response : trace.responses) {
+    if (!response.body) {
+      response_bodies.push_back(0);
+      continue;
+    }
+    auto it = body_ids.emplace(*response.body, bodies.size() + 1).first;
+    if (it->second == bodies.size() + 1)
+      bodies.push_back(response.body.get());
+    response_bodies.push_back(it->second);
+  }
+  PutVarint(bodies.size(), &out);
+  for (const std::string* body : bodies)
+    PutString(*body, &out);
+
+  PutVarint(trace.responses.size(), &out);
+  for (size_t i = 0; i < trace.responses.size(); i++) {
+    const TraceResponse& response = trace.responses[i];
+    PutVarint(response.request_us, &out);
+    PutVarint(response.latency_us, &out);
+    PutString(response.target, &out);
+    PutString(response.range, &out);
+    PutVarint(static_cast<uint64_t>(response.status), &out);
+    PutString(response.content_type, &out);
+    PutVarint(response.headers.size(), &out);
+    for (auto& header : response.headers) {
+      PutString(header.first, &out);
+      PutString(header.second, &out);
+    }
+    PutVarint(response_bodies[i], &out);
+  }
+
+  PutVarint(trace.events.size(), &out);
+  for (auto& event : trace.events) {
+    PutVarint(event.time_us, &out);
+    PutVarint(static_cast<uint64_t>(event.type), &out);
+    PutDouble(event.value, &out);
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  file.write(out.data(), static_cast<std::streamsize>(out.size()));
+  file.close();
+  if (!file) {
+    *error = "Unable to write " + path;
+    return false;
+  }
+  return true;
+}
+
+bool ReadTrace(const std::string& path, SessionTrace* trace,
+               std::string* error) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    *error = "Unable to open " + path;
+    return false;
+  }
+  const std::string data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  if (data.size() < sizeof(kMagic) ||
+      data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+    *error = path + " is not a session trace";
+    return false;
+  }
+
+  TraceReader reader(data, sizeof(kMagic));
+  const uint64_t version = reader.Varint();
+  if (reader.ok() && version != kVersion) {
+    *error = path + " has unsupported trace version " + std::to_string(version);
+    return false;
+  }
+
+  *trace = SessionTrace();
+  trace->manifest_target = reader.String();
+  trace->playback_rate = reader.Double();
+  trace->bandwidth_estimate = reader.Double();
+  trace->duration_us = reader.Varint();
+
+  std::vector<std::shared_ptr<const std::string>> bodies(reader.Count() + 1);
+  for (size_t i = 1; i < bodies.size() && reader.ok(); i++)
+    bodies[i] = std::make_shared<const std::string>(reader.String());
+
+  const uint64_t responses = reader.Count();
+  for (uint64_t i = 0; i < responses && reader.ok(); i++) {
+    TraceResponse response;
+    response.request_us = reader.Varint();
+    response.latency_us = reader.Varint();
+    response.target = reader.String();
+    response.range = reader.String();
+    response.status = static_cast<int>(reader.Varint());
+    response.content_type = reader.String();
+    const uint64_t headers = reader.Count();
+    for (uint64_t j = 0; j < headers && reader.ok(); j++) {
+      std::string name = reader.String();
+      response.headers[name] = reader.String();
+    }
+    const uint64_t body = reader.Varint();
+    if (body >= bodies.size())
+      break;
+    response.body = bodies[body];
+    trace->responses.push_back(std::move(response));
+  }
+
+  const uint64_t events = reader.Count();
+  for (uint64_t i = 0; i < events && reader.ok(); i++) {
+    TraceEvent event;
+    event.time_us = reader.Varint();
+    const uint64_t type = reader.Varint();
+    event.value = reader.Double();
+    if (type > static_cast<uint64_t>(TraceEvent::Type::kVariant))
+      break;
+    event.type = static_cast<TraceEvent::Type>(type);
+    trace->events.push_back(event);
+  }
+
+  if (!reader.ok() || !reader.done() ||
+      trace->responses.size() != responses || trace->events.size() != events) {
+    *error = path + " is truncated or corrupt";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sample
@@ -0,0 +1,79 @@
+#ifndef SAMPLE_NET_SESSION_TRACE_H_
+#define SAMPLE_NET_SESSION_TRACE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/**
+ * One network response as the player received it.
+ *
+ * The recorder fetches each response whole before passing it on, so
+ * |latency_us| covers the time to the first byte and the transfer alike.  A
+ * replay holds the whole response back for it and then sends it at once, so
+ * all of it is replayed as time to first byte.
+ */
+struct TraceResponse {
+  /** When the request arrived, in microseconds from the session start. */
+  uint64_t request_us = 0;
+  /** How long the origin took to deliver the whole response. */
+  uint64_t latency_us = 0;
+  /** The request target, path and query, and Range header if any. */
+  std::string target;
+  std::string range;
+  int status = 200;
+  std::string content_type;
+  std::map<std::string, std::string> headers;
+  std::shared_ptr<const std::string> body;
+};
+
+/** Something the application or the player did during the session. */
+struct TraceEvent {
+  enum class Type : uint8_t {
+    kPlay = 0,
+    kPause = 1,
+    /** |value| is the time seeked to. */
+    kSeek = 2,
+    /** |value| is the id of the variant track switched to. */
+    kVariant = 3,
+  };
+
+  uint64_t time_us = 0;
+  Type type = Type::kPlay;
+  double value = 0;
+};
+
+/** A recorded playback session; see WriteTrace() for the file format. */
+struct SessionTrace {
+  /** The manifest's request target on the origin. */
+  std::string manifest_target;
+  double playback_rate = 1;
+  /** The player's initial bandwidth estimate, which picks the first variant. */
+  double bandwidth_estimate = 0;
+  /** From the session start until recording stopped. */
+  uint64_t duration_us = 0;
+  /** In request order. */
+  std::vector<TraceResponse> responses;
+  /** In time order. */
+  std::vector<TraceEvent> events;
+};
+
+/**
+ * Writes |trace| to |path| in a compact binary form: integers are
+ * variable-length, doubles are 8 little-endian bytes, and each distinct body
+ * is stored once however many responses carry it.
+ */
+bool WriteTrace(const SessionTrace& trace, const std::string& path,
+                std::string* error);
+
+/** Reads a trace written by WriteTrace(). */
+bool ReadTrace(const std::string& path, SessionTrace* trace,
+               std::string* error);
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_SESSION_TRACE_H_
@@ -0,0 +1,131 @@
+#include "net/static_file_handler.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace sample {
+
+namespace {
+
+/** Parses a run of decimal digits; anything else, or nothing, fails. */
+bool ParseRangeNumber(const std::string& str, size_t* value) {
+  if (str.empty() || str[0] < '0' || str[0] > '9')
+    return false;
+  char* end = nullptr;
+  *value = std::strtoull(str.c_str(), &end, 10);
+  return *end == '\0';
+}
+
+/**
+ * Parses a "bytes=start-end" Range header against a body of |size| bytes.
+ * Suffix ranges ("bytes=-N") and open ranges ("bytes=N-") are supported.
+ * Returns false if the range is malformed or unsatisfiable.
+ */
+bool ParseRange(const std::string& header, size_t size, size_t* start,
+                size_t* end) {
+  if (header.compare(0, 6, "bytes=") != 0 ||
+      header.find(',') != std::string::npos) {
+    return false;
+  }
+  const std::string spec = header.substr(6);
+  const size_t dash = spec.find('-');
+  if (dash == std::string::npos || size == 0)
+    return false;
+
+  const std::string first = spec.substr(0, dash);
+  const std::string last = spec.substr(dash + 1);
+  if (first.empty()) {
+    size_t suffix;
+    if (!ParseRangeNumber(last, &suffix) || suffix == 0)
+      return false;
+    *start = suffix >= size ? 0 : size - suffix;
+    *end = size - 1;
+    return true;
+  }
+
+  if (!ParseRangeNumber(first, start))
+    return false;
+  if (last.empty())
+    *end = size - 1;
+  else if (!ParseRangeNumber(last, end))
+    return false;
+  if (*end >= size)
+    *end = size - 1;
+  return *start <= *end;
+}
+
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+}  // namespace
+
+std::string ContentTypeForPath(const std::string& path) {
+  static const struct {
+    const char* extension;
+    const char* type;
+  } kTypes[] = {
+      {".mpd", "application/dash+xml"},
+      {".m3u8", "application/vnd.apple.mpegurl"},
+      {".mp4", "video/mp4"},
+      {".m4s", "video/mp4"},
+      {".m4v", "video/mp4"},
+      {".m4a", "audio/mp4"},
+      {".ts", "video/mp2t"},
+      {".aac", "audio/aac"},
+      {".vtt", "text/vtt"},
+      {".webm", "video/webm"},
+  };
+  for (auto& entry : kTypes) {
+    if (EndsWith(path, entry.extension))
+      return entry.type;
+  }
+  return "application/octet-stream";
+}
+
+StaticFileHandler::StaticFileHandler(const std::string& root) : root_(root) {}
+
+void StaticFileHandler::Handle(const HttpRequest& request,
+                               HttpResponse* response) {
+  if (request.method != "GET" && request.method != "HEAD") {
+    response->status = 405;
+    return;
+  }
+  if (request.path.empty() || request.path[0] != '/' ||
+      request.path.find("..") != std::string::npos) {
+    response->status = 403;
+    return;
+  }
+
+  std::ifstream file(root_ + request.path, std::ios::binary);
+  if (!file) {
+    response->status = 404;
+    return;
+  }
+  std::string data((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+
+  response->content_type = ContentTypeForPath(request.path);
+  response->headers["Accept-Ranges"] = "bytes";
+  const std::string range = request.Header("range");
+  if (!range.empty()) {
+    size_t start = 0;
+    size_t end = 0;
+    if (!ParseRange(range, data.size(), &start, &end)) {
+      response->status = 416;
+      response->headers["Content-Range"] =
+          "bytes */" + std::to_string(data.size());
+      return;
+    }
+    response->status = 206;
+    response->headers["Content-Range"] = "bytes " + std::to_string(start) +
+                                         "-" + std::to_string(end) + "/" +
+                                         std::to_string(data.size());
+    data = data.substr(start, end - start + 1);
+  }
+  response->SetBody(std::move(data));
+}
+
+}  // namespace sample
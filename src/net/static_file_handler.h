@@ -0,0 +1,29 @@
+#ifndef SAMPLE_NET_STATIC_FILE_HANDLER_H_
+#define SAMPLE_NET_STATIC_FILE_HANDLER_H_
+
+#include <string>
+
+#include "net/http_server.h"
+
+namespace sample {
+
+/**
+ * Serves files below a root directory.  Supports single byte-range requests,
+ * which DASH SegmentBase content needs for its index and media ranges.
+ */
+class StaticFileHandler : public HttpHandler {
+ public:
+  explicit StaticFileHandler(const std::string& root);
+
+  void Handle(const HttpRequest& request, HttpResponse* response) override;
+
+ private:
+  const std::string root_;
+};
+
+/** Returns the MIME type the sample serves for |path|, based on extension. */
+std::string ContentTypeForPath(const std::string& path);
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_STATIC_FILE_HANDLER_H_
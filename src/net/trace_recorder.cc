@@ -0,0 +1,101 @@
+#include "net/trace_recorder.h"
+
+#include <algorithm>
+
+#include "net/http_client.h"
+
+namespace sample {
+
+TraceRecorder::TraceRecorder(const std::string& upstream)
+    : upstream_(upstream),
+      start_(Clock::now()),
+      start_system_(std::chrono::system_clock::now()) {}
+
+void TraceRecorder::Handle(const HttpRequest& request,
+                           HttpResponse* response) {
+  const std::string target =
+      request.path + (request.query.empty() ? "" : "?" + request.query);
+  const std::string range = request.Header("range");
+  const Clock::time_point start = Clock::now();
+  HttpResult result;
+  std::string error;
+  if (HttpGet(upstream_ + target, range, &result, &error)) {
+    response->status = result.status;
+    response->content_type = result.headers["content-type"];
+    auto content_range = result.headers.find("content-range");
+    if (content_range != result.headers.end())
+      response->headers["Content-Range"] = content_range->second;
+    response->body = result.body;
+  } else {
+    // Failures are recorded too, so replay reproduces them.
+    response->status = 502;
+    response->SetBody(error);
+  }
+  const Clock::time_point end = Clock::now();
+
+  TraceResponse recorded;
+  recorded.latency_us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count());
+  recorded.target = target;
+  recorded.range = range;
+  recorded.status = response->status;
+  recorded.content_type = response->content_type;
+  recorded.headers = response->headers;
+  recorded.body = response->body;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  recorded.request_us = MicrosecondsSinceStartLocked(start);
+  trace_.responses.push_back(std::move(recorded));
+}
+
+void TraceRecorder::Start() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  start_ = Clock::now();
+  start_system_ = std::chrono::system_clock::now();
+}
+
+void TraceRecorder::RecordEvent(TraceEvent::Type type, double value) {
+  const Clock::time_point now = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  TraceEvent event;
+  event.time_us = MicrosecondsSinceStartLocked(now);
+  event.type = type;
+  event.value = value;
+  trace_.events.push_back(event);
+}
+
+void TraceRecorder::RecordEventAt(double epoch_seconds, TraceEvent::Type type,
+                                  double value) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const double start_seconds =
+      std::chrono::duration<double>(start_system_.time_since_epoch()).count();
+  TraceEvent event;
+  event.time_us = static_cast<uint64_t>(
+      std::max(0.0, (epoch_seconds - start_seconds) * 1e6));
+  event.type = type;
+  event.value = value;
+  trace_.events.push_back(event);
+}
+
+SessionTrace TraceRecorder::Finish() {
+  const Clock::time_point now = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  trace_.duration_us = MicrosecondsSinceStartLocked(now);
+  std::stable_sort(trace_.events.begin(), trace_.events.end(),
+                   [](const TraceEvent& a, const TraceEvent& b) {
+                     return a.time_us < b.time_us;
+                   });
+  return trace_;
+}
+
+uint64_t TraceRecorder::MicrosecondsSinceStartLocked(
+    Clock::time_point time) const {
+  if (time <= start_)
+    return 0;
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(time - start_)
+          .count());
+}
+
+}  // namespace sample
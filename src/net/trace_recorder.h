@@ -0,0 +1,63 @@
+#ifndef SAMPLE_NET_TRACE_RECORDER_H_
+#define SAMPLE_NET_TRACE_RECORDER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "base/clock.h"
+#include "net/http_server.h"
+#include "net/session_trace.h"
+
+namespace sample {
+
+/**
+ * An HTTP handler that forwards every request to an origin and records the
+ * response and how long it took, plus the events the application reports,
+ * into a SessionTrace.
+ */
+class TraceRecorder : public HttpHandler {
+ public:
+  /** |upstream| is the origin, e.g. "http://127.0.0.1:8000". */
+  explicit TraceRecorder(const std::string& upstream);
+
+  TraceRecorder(const TraceRecorder&) = delete;
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  void Handle(const HttpRequest& request, HttpResponse* response) override;
+
+  /**
+   * Marks the start of the session, which times are measured from.  Anything
+   * recorded earlier is placed at the start.
+   */
+  void Start();
+
+  /** Records |type| as happening now. */
+  void RecordEvent(TraceEvent::Type type, double value);
+  /**
+   * Records |type| as happening at |epoch_seconds| on the system clock, the
+   * form the player reports its own history in.
+   */
+  void RecordEventAt(double epoch_seconds, TraceEvent::Type type,
+                     double value);
+
+  /**
+   * Returns everything recorded so far, with events in time order.  The
+   * caller fills in the session settings.
+   */
+  SessionTrace Finish();
+
+ private:
+  uint64_t MicrosecondsSinceStartLocked(Clock::time_point time) const;
+
+  const std::string upstream_;
+
+  std::mutex mutex_;
+  Clock::time_point start_;
+  std::chrono::system_clock::time_point start_system_;
+  SessionTrace trace_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_TRACE_RECORDER_H_
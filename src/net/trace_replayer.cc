@@ -0,0 +1,71 @@
+#include "net/trace_replayer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace sample {
+
+namespace {
+
+std::string ResponseKey(const std::string& target, const std::string& range) {
+  return range.empty() ? target : target + "#" + range;
+}
+
+}  // namespace
+
+TraceReplayer::TraceReplayer(const SessionTrace* trace, double speed)
+    : speed_(speed), start_(Clock::now()) {
+  for (auto& response : trace->responses)
+    responses_[ResponseKey(response.target, response.range)].recorded.push_back(
+        &response);
+}
+
+void TraceReplayer::Start() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  start_ = Clock::now();
+  for (auto& pair : responses_)
+    pair.second.next = 0;
+}
+
+void TraceReplayer::Handle(const HttpRequest& request,
+                           HttpResponse* response) {
+  const Clock::time_point arrival = Clock::now();
+  const std::string target =
+      request.path + (request.query.empty() ? "" : "?" + request.query);
+  const TraceResponse* recorded = nullptr;
+  Clock::time_point start;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stats_.requests++;
+    start = start_;
+    auto it = responses_.find(ResponseKey(target, request.Header("range")));
+    if (it == responses_.end()) {
+      stats_.misses++;
+      response->status = 404;
+      return;
+    }
+    Responses& responses = it->second;
+    if (responses.next < responses.recorded.size()) {
+      recorded = responses.recorded[responses.next++];
+    } else {
+      stats_.repeats++;
+      recorded = responses.recorded.back();
+    }
+  }
+
+  const Clock::time_point requested = std::max(
+      arrival, start + SecondsToDuration(recorded->request_us / 1e6 / speed_));
+  std::this_thread::sleep_until(
+      requested + SecondsToDuration(recorded->latency_us / 1e6 / speed_));
+  response->status = recorded->status;
+  response->content_type = recorded->content_type;
+  response->headers = recorded->headers;
+  response->body = recorded->body;
+}
+
+TraceReplayStats TraceReplayer::stats() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace sample
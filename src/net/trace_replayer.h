@@ -0,0 +1,73 @@
+#ifndef SAMPLE_NET_TRACE_REPLAYER_H_
+#define SAMPLE_NET_TRACE_REPLAYER_H_
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "base/clock.h"
+#include "net/http_server.h"
+#include "net/session_trace.h"
+
+namespace sample {
+
+/** Counters kept by a TraceReplayer. */
+struct TraceReplayStats {
+  uint64_t requests = 0;
+  /** Requests for something the trace does not hold; answered with 404. */
+  uint64_t misses = 0;
+  /**
+   * Requests made more often than recorded; answered with the last recorded
+   * response.
+   */
+  uint64_t repeats = 0;
+};
+
+/**
+ * An HTTP handler that answers from a SessionTrace instead of an origin.
+ *
+ * Each request is answered with the next recorded response for the same
+ * target and range, so a manifest that changed between reloads changes the
+ * same way again.  A request made earlier in the session than recorded
+ * waits until its recorded time, and the answer is then held back for the
+ * recorded latency; both are divided by |speed|, so the player sees the
+ * recorded network, sped up.
+ */
+class TraceReplayer : public HttpHandler {
+ public:
+  /** |trace| must outlive this. */
+  TraceReplayer(const SessionTrace* trace, double speed);
+
+  TraceReplayer(const TraceReplayer&) = delete;
+  TraceReplayer& operator=(const TraceReplayer&) = delete;
+
+  /**
+   * Starts a new session: recorded request times count from now, and each
+   * target is answered from its first recorded response again.
+   */
+  void Start();
+
+  void Handle(const HttpRequest& request, HttpResponse* response) override;
+
+  TraceReplayStats stats() const;
+
+ private:
+  struct Responses {
+    std::vector<const TraceResponse*> recorded;
+    size_t next = 0;
+  };
+
+  const double speed_;
+
+  mutable std::mutex mutex_;
+  Clock::time_point start_;
+  /** Keyed by target and range. */
+  std::map<std::string, Responses> responses_;
+  TraceReplayStats stats_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_NET_TRACE_REPLAYER_H_
@@ -0,0 +1,248 @@
+#include "player/fast_start.h"
+
+#include <shaka/media/decoder.h>
+#include <shaka/media/demuxer.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/json_writer.h"
+#include "media/hls_parser.h"
+#include "net/http_client.h"
+
+namespace sample {
+
+namespace {
+
+/** Encoded frames decoded at most while waiting for the first output. */
+constexpr size_t kMaxWarmUpFrames = 8;
+
+class NullDemuxerClient final : public shaka::media::Demuxer::Client {
+ public:
+  void OnLoadedMetaData(double /* duration */) override {}
+  void OnEncrypted(shaka::eme::MediaKeyInitDataType /* type */,
+                   const uint8_t* /* data */, size_t /* size */) override {}
+};
+
+const uint8_t* BodyData(const CachedResponse& response) {
+  return reinterpret_cast<const uint8_t*>(response.body->data());
+}
+
+/**
+ * Demuxes |init| and |segment| and decodes frames with a throwaway decoder
+ * until one comes out.  The player's decoders are separate instances, but the
+ * codec's lazily built tables and code are then already warm for them.
+ */
+bool WarmUpDecoder(const shaka::media::DemuxerFactory* factory,
+                   const Representation& representation,
+                   const CachedResponse& init, const CachedResponse& segment,
+                   std::string* error) {
+  using shaka::media::Decoder;
+
+  const std::string mime_type = representation.FullMimeType();
+  if (!factory || !factory->IsTypeSupported(mime_type)) {
+    *error = "No demuxer for " + mime_type;
+    return false;
+  }
+
+  NullDemuxerClient client;
+  std::unique_ptr<shaka::media::Demuxer> demuxer =
+      factory->Create(mime_type, &client);
+  std::vector<std::shared_ptr<shaka::media::EncodedFrame>> frames;
+  if (!demuxer ||
+      !demuxer->Demux(0, BodyData(init), init.body->size(), &frames) ||
+      !demuxer->Demux(0, BodyData(segment), segment.body->size(), &frames)) {
+    *error = "Unable to demux the first segment of " + representation.id;
+    return false;
+  }
+
+  std::unique_ptr<Decoder> decoder = Decoder::CreateDefaultDecoder();
+  std::vector<std::shared_ptr<shaka::media::DecodedFrame>> decoded;
+  std::string extra_info;
+  for (size_t i = 0; i < frames.size() && i < kMaxWarmUpFrames; i++) {
+    if (decoder->Decode(frames[i], nullptr, &decoded, &extra_info) !=
+        shaka::media::MediaStatus::Success) {
+      *error = "Warm-up decode failed: " + extra_info;
+      return false;
+    }
+    if (!decoded.empty())
+      break;
+  }
+  return true;
+}
+
+}  // namespace
+
+struct FastStart::StreamResult {
+  std::string error;
+  uint64_t bytes = 0;
+  /** When the first segment was in the proxy, from Start(). */
+  double segments_ms = 0;
+  double warm_up_ms = 0;
+};
+
+void WriteFastStartReport(const FastStartReport& report, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("ok");
+  writer->Bool(report.ok);
+  if (!report.ok) {
+    writer->Key("error");
+    writer->String(report.error);
+  }
+  writer->Key("manifest_ms");
+  writer->Number(report.manifest_ms);
+  writer->Key("segments_ms");
+  writer->Number(report.segments_ms);
+  writer->Key("warm_up_ms");
+  writer->Number(report.warm_up_ms);
+  writer->Key("total_ms");
+  writer->Number(report.total_ms);
+  writer->Key("bytes_preloaded");
+  writer->Uint(report.bytes_preloaded);
+  writer->EndObject();
+}
+
+FastStart::FastStart(CachingProxy* proxy, const std::string& manifest_uri,
+                     double bandwidth_estimate,
+                     const shaka::media::DemuxerFactory* demuxers)
+    : proxy_(proxy),
+      manifest_uri_(manifest_uri),
+      bandwidth_estimate_(bandwidth_estimate),
+      demuxers_(demuxers) {
+  ParsedUrl parsed;
+  if (ParseHttpUrl(manifest_uri, &parsed))
+    origin_ = "http://" + parsed.host + ":" + std::to_string(parsed.port);
+}
+
+FastStart::~FastStart() {
+  if (thread_.joinable())
+    thread_.join();
+}
+
+void FastStart::Start() {
+  start_ = Clock::now();
+  thread_ = std::thread(&FastStart::Run, this);
+}
+
+FastStartReport FastStart::Wait() {
+  if (thread_.joinable())
+    thread_.join();
+  return report_;
+}
+
+void FastStart::Run() {
+  std::shared_ptr<const CachedResponse> response;
+  if (!Preload(manifest_uri_, "", &response, &report_.error) ||
+      !ParseManifest(manifest_uri_, *response->body, &manifest_,
+                     &report_.error)) {
+    report_.total_ms = MillisecondsSince(start_);
+    return;
+  }
+  report_.bytes_preloaded += response->body->size();
+  report_.variant = ChooseVariant(manifest_.variants, bandwidth_estimate_);
+  if (report_.variant == Variant::kNone) {
+    report_.error = "The manifest has no playable variants";
+    report_.total_ms = MillisecondsSince(start_);
+    return;
+  }
+  const Variant& variant = manifest_.variants[report_.variant];
+  std::vector<size_t> streams;
+  if (variant.video != Variant::kNone)
+    streams.push_back(variant.video);
+  if (variant.audio != Variant::kNone)
+    streams.push_back(variant.audio);
+
+  // Each stream is fetched and warmed on its own thread, as the player
+  // fetches them in parallel too.
+  report_.manifest_ms = MillisecondsSince(start_);
+  std::vector<StreamResult> results(streams.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < streams.size(); i++) {
+    threads.emplace_back([this, &streams, &results, i]() {
+      Representation& representation = manifest_.representations[streams[i]];
+      if (representation.segments.empty() &&
+          !representation.playlist_url.empty() &&
+          !LoadHlsPlaylist(&representation, &results[i])) {
+        return;
+      }
+      PrepareStream(representation, &results[i]);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  for (auto& result : results) {
+    report_.bytes_preloaded += result.bytes;
+    report_.warm_up_ms += result.warm_up_ms;
+    report_.segments_ms = std::max(report_.segments_ms, result.segments_ms);
+    if (report_.error.empty())
+      report_.error = result.error;
+  }
+  report_.ok = report_.error.empty();
+  report_.total_ms = MillisecondsSince(start_);
+}
+
+void FastStart::PrepareStream(const Representation& representation,
+                              StreamResult* result) {
+  std::shared_ptr<const CachedResponse> init;
+  if (!representation.init.url.empty() &&
+      !Preload(representation.init.url, representation.init.RangeHeader(),
+               &init, &result->error)) {
+    return;
+  }
+  if (init)
+    result->bytes += init->body->size();
+  if (representation.index.has_range) {
+    // The player reads the index before any segment; the segments it lists
+    // are not known here.
+    std::shared_ptr<const CachedResponse> index;
+    if (Preload(representation.index.url, representation.index.RangeHeader(),
+                &index, &result->error)) {
+      result->bytes += index->body->size();
+    }
+    return;
+  }
+  if (representation.segments.empty())
+    return;
+
+  std::shared_ptr<const CachedResponse> first;
+  const SegmentReference& segment = representation.segments[0];
+  if (!Preload(segment.url, segment.RangeHeader(), &first, &result->error))
+    return;
+  result->bytes += first->body->size();
+  result->segments_ms = MillisecondsSince(start_);
+
+  if (init && representation.type != StreamType::kText) {
+    const Clock::time_point warm_up_start = Clock::now();
+    WarmUpDecoder(demuxers_, representation, *init, *first, &result->error);
+    result->warm_up_ms = MillisecondsSince(warm_up_start);
+  }
+}
+
+bool FastStart::Preload(const std::string& url, const std::string& range,
+                        std::shared_ptr<const CachedResponse>* response,
+                        std::string* error) {
+  if (origin_.empty() || url.compare(0, origin_.size(), origin_) != 0 ||
+      url.size() == origin_.size() || url[origin_.size()] != '/') {
+    *error = url + " is not served by the caching proxy";
+    return false;
+  }
+  return proxy_->Preload(url.substr(origin_.size()), range, response, error);
+}
+
+bool FastStart::LoadHlsPlaylist(Representation* representation,
+                                StreamResult* result) {
+  // Streams load in parallel, so the manifest-wide fields they would update
+  // go to a scratch copy.
+  Manifest scratch;
+  std::shared_ptr<const CachedResponse> playlist;
+  if (!Preload(representation->playlist_url, "", &playlist, &result->error) ||
+      !ParseHlsMediaPlaylist(representation->playlist_url, *playlist->body,
+                             representation, &scratch, &result->error)) {
+    return false;
+  }
+  result->bytes += playlist->body->size();
+  return true;
+}
+
+}  // namespace sample
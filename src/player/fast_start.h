@@ -0,0 +1,94 @@
+#ifndef SAMPLE_PLAYER_FAST_START_H_
+#define SAMPLE_PLAYER_FAST_START_H_
+
+#include <shaka/media/demuxer.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "base/clock.h"
+#include "media/manifest.h"
+#include "net/caching_proxy.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** What the fast-start work did for one session. */
+struct FastStartReport {
+  bool ok = false;
+  std::string error;
+  /** Index into the manifest's variants of the variant prepared. */
+  size_t variant = Variant::kNone;
+  /** Times from Start(), in milliseconds. */
+  double manifest_ms = 0;
+  double segments_ms = 0;
+  double total_ms = 0;
+  /** Time spent decoding the first frames of each stream. */
+  double warm_up_ms = 0;
+  /** Body bytes fetched into the proxy ahead of the player. */
+  uint64_t bytes_preloaded = 0;
+};
+
+void WriteFastStartReport(const FastStartReport& report, JsonWriter* writer);
+
+/**
+ * Runs the startup work of one session beside Player::Load() instead of
+ * after it.
+ *
+ * On a background thread the manifest is fetched and parsed natively, the
+ * variant the player will start with is chosen the way its ABR manager does,
+ * and the init segments and first segments of that variant are fetched in
+ * parallel into |proxy|, where the player's own requests find them or join
+ * them in flight.  Meanwhile the first frames of each stream are demuxed and
+ * decoded once, so the codec's one-time setup is done before the player's
+ * decoder needs it.
+ *
+ * |manifest_uri| must be served by |proxy|.  Warm-up demuxing uses
+ * |demuxers|, which should be the SDK's own factory rather than a wrapper
+ * that times or pools samples, so the warm-up does not show up in what the
+ * session measures.
+ */
+class FastStart {
+ public:
+  FastStart(CachingProxy* proxy, const std::string& manifest_uri,
+            double bandwidth_estimate,
+            const shaka::media::DemuxerFactory* demuxers);
+  ~FastStart();
+
+  FastStart(const FastStart&) = delete;
+  FastStart& operator=(const FastStart&) = delete;
+
+  void Start();
+
+  /** Waits for the background work and returns what it did. */
+  FastStartReport Wait();
+
+ private:
+  struct StreamResult;
+
+  void Run();
+  void PrepareStream(const Representation& representation,
+                     StreamResult* result);
+  bool Preload(const std::string& url, const std::string& range,
+               std::shared_ptr<const CachedResponse>* response,
+               std::string* error);
+  bool LoadHlsPlaylist(Representation* representation, StreamResult* result);
+
+  CachingProxy* const proxy_;
+  const std::string manifest_uri_;
+  const double bandwidth_estimate_;
+  const shaka::media::DemuxerFactory* const demuxers_;
+  /** "http://host:port" of the proxy; URLs outside it are not preloaded. */
+  std::string origin_;
+  Manifest manifest_;
+  Clock::time_point start_;
+  FastStartReport report_;
+  std::thread thread_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_FAST_START_H_
@@ -0,0 +1,552 @@
+#include "player/headless_player.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+#include "base/json_writer.h"
+#include "base/process_stats.h"
+#include "base/stage_timings.h"
+#include "media/keyframe_index.h"
+#include "net/http_client.h"
+
+namespace sample {
+
+namespace {
+
+/** How often PlayFor() checks whether playback stopped on its own. */
+constexpr std::chrono::milliseconds kStateCheckInterval{50};
+
+/**
+ * Buffers in the frame pool.  The renderer holds one as its front buffer, so
+ * this leaves room for frames in flight.
+ */
+constexpr size_t kFramePoolSize = 4;
+
+/** Assumed when the active track does not give its frame rate. */
+constexpr double kDefaultFrameRate = 30;
+
+/** When the |index|th event of the replayed trace is due, from Load(). */
+Clock::duration ReplayTime(const PlaybackOptions& options, size_t index) {
+  return SecondsToDuration(options.replay->events[index].time_us / 1e6 /
+                           options.replay_speed);
+}
+
+/** Fetches and parses the manifest at |url|. */
+bool FetchManifest(const std::string& url, Manifest* manifest,
+                   std::string* error) {
+  HttpResult response;
+  if (!HttpGet(url, "", &response, error))
+    return false;
+  if (response.status != 200) {
+    *error = "HTTP " + std::to_string(response.status) +
+             " fetching the manifest";
+    return false;
+  }
+  return ParseManifest(url, *response.body, manifest, error);
+}
+
+/** Fetches |url| for a KeyframeIndexSet. */
+bool FetchForIndex(const std::string& url, const std::string& range,
+                   std::string* body, std::string* error) {
+  HttpResult result;
+  if (!HttpGet(url, range, &result, error))
+    return false;
+  if (result.status != 200 && result.status != 206) {
+    *error = "HTTP " + std::to_string(result.status) + " for " + url;
+    return false;
+  }
+  *body = *result.body;
+  return true;
+}
+
+}  // namespace
+
+void WriteReport(const PlaybackReport& report, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("ok");
+  writer->Bool(report.ok);
+  if (!report.ok) {
+    writer->Key("error");
+    writer->String(report.error);
+  }
+  writer->Key("load_ms");
+  writer->Number(report.load_ms);
+  writer->Key("startup_ms");
+  writer->Number(report.startup_ms);
+  writer->Key("fast_start");
+  writer->Bool(report.fast_start);
+  if (report.fast_start) {
+    writer->Key("fast_start_work");
+    WriteFastStartReport(report.fast_start_report, writer);
+  }
+  if (report.buffer_limited) {
+    writer->Key("buffer_policy");
+    WriteBufferPolicy(report.buffer_policy, writer);
+  }
+  writer->Key("frames_presented");
+  writer->Uint(report.frames_presented);
+  writer->Key("play_seconds");
+  writer->Number(report.play_seconds);
+  writer->Key("frames_per_second");
+  writer->Number(report.frames_per_second);
+  writer->Key("dropped_frames");
+  writer->Uint(report.dropped_frames);
+  writer->Key("rebuffers");
+  writer->Uint(report.rebuffers);
+  writer->Key("rebuffer_ms");
+  writer->Number(report.rebuffer_ms);
+  writer->Key("estimated_bandwidth");
+  writer->Number(report.estimated_bandwidth);
+  writer->Key("frame_handoff");
+  writer->String(FrameHandoffName(report.frame_handoff));
+  writer->Key("bytes_copied");
+  writer->Uint(report.bytes_copied);
+  writer->Key("pool_exhausted");
+  writer->Uint(report.pool_exhausted);
+  if (report.replayed_events > 0) {
+    writer->Key("replayed_events");
+    writer->Uint(report.replayed_events);
+  }
+  writer->Key("render_cpu_ms");
+  writer->Number(report.render_cpu_ms);
+  writer->Key("process_cpu_ms");
+  writer->Number(report.process_cpu_ms);
+  writer->Key("rss_bytes");
+  writer->Uint(report.rss_bytes);
+  writer->Key("peak_rss_bytes");
+  writer->Uint(report.peak_rss_bytes);
+  writer->EndObject();
+}
+
+HeadlessPlayer::HeadlessPlayer(shaka::JsManager* engine,
+                               RenderLoop* render_loop)
+    : video_renderer_(render_loop),
+      media_player_(&video_renderer_, &audio_renderer_),
+      player_(engine),
+      counting_rebuffers_(false),
+      buffering_(false),
+      rebuffers_(0),
+      rebuffer_ms_(0) {
+  // Nothing is wrapped unless timings are on, so they cost nothing when off.
+  if (StageTimingsEnabled()) {
+    InstallDecoders();
+    player_.AddNetworkFilters(&timing_filters_);
+  }
+}
+
+HeadlessPlayer::~HeadlessPlayer() {}
+
+PlaybackReport HeadlessPlayer::Run(const PlaybackOptions& options) {
+  PlaybackReport report;
+  report.frame_handoff = options.frame_handoff;
+  report.fast_start = options.fast_start;
+  report.buffer_limited = options.buffer_budget_bytes > 0;
+  ResetFramePool(options.frame_handoff);
+
+  if (Initialize(options, &report.error) &&
+      (!report.buffer_limited ||
+       ApplyBufferBudget(options, &report.buffer_policy, &report.error)) &&
+      StartPlayback(options, &report)) {
+    PlayFor(options, &report);
+  }
+
+  EndSession(&report.ok, &report.error);
+  report.peak_rss_bytes = PeakRssBytes();
+  return report;
+}
+
+SeekReport HeadlessPlayer::RunSeeks(const PlaybackOptions& options,
+                                    const SeekOptions& seek_options) {
+  SeekReport report;
+  report.pattern = seek_options.pattern;
+  report.mode = seek_options.mode;
+  InstallDecoders();
+  ResetFramePool(options.frame_handoff);
+
+  PlaybackReport playback;
+  if (Initialize(options, &report.error) &&
+      (options.buffer_budget_bytes == 0 ||
+       ApplyBufferBudget(options, &playback.buffer_policy, &report.error)) &&
+      StartPlayback(options, &playback)) {
+    media_player_.Pause();
+    if (options.recorder)
+      options.recorder->RecordEvent(TraceEvent::Type::kPause, 0);
+    SeekAll(options, seek_options, &report);
+    if (options.recorder)
+      RecordVariantHistory(options.recorder);
+  } else if (report.error.empty()) {
+    report.error = playback.error;
+  }
+
+  EndSession(&report.ok, &report.error);
+  return report;
+}
+
+void HeadlessPlayer::ResetFramePool(FrameHandoff handoff) {
+  // The renderer drops its front buffer under its lock, so no frame is being
+  // wrapped or held when the old pool is freed.
+  video_renderer_.SetFramePool(nullptr);
+  frame_pool_.reset(new FramePool(handoff, kFramePoolSize));
+  video_renderer_.SetFramePool(frame_pool_.get());
+}
+
+void HeadlessPlayer::EndSession(bool* ok, std::string* error) {
+  auto unload = player_.Unload();
+  video_renderer_.SetFramePool(nullptr);
+  timing_filters_.Reset();
+  if (unload.has_error() && *ok) {
+    *ok = false;
+    *error = unload.error().message;
+  }
+}
+
+void HeadlessPlayer::InstallDecoders() {
+  if (video_decoder_)
+    return;
+  video_decoder_.reset(
+      new TimingDecoder(shaka::media::Decoder::CreateDefaultDecoder()));
+  audio_decoder_.reset(
+      new TimingDecoder(shaka::media::Decoder::CreateDefaultDecoder()));
+  media_player_.SetDecoders(video_decoder_.get(), audio_decoder_.get());
+}
+
+bool HeadlessPlayer::Initialize(const PlaybackOptions& options,
+                                std::string* error) {
+  auto results = player_.Initialize(this, &media_player_);
+  if (results.has_error()) {
+    *error = "Initialize failed: " + results.error().message;
+    return false;
+  }
+  auto configure = player_.Configure("abr.defaultBandwidthEstimate",
+                                     options.bandwidth_estimate);
+  // A replay switches variants only where the recording did.
+  if (!configure.has_error() && options.replay)
+    configure = player_.Configure("abr.enabled", false);
+  if (configure.has_error()) {
+    *error = "Configure failed: " + configure.error().message;
+    return false;
+  }
+  return true;
+}
+
+bool HeadlessPlayer::ApplyBufferBudget(const PlaybackOptions& options,
+                                       BufferPolicy* policy,
+                                       std::string* error) {
+  Manifest manifest;
+  if (!FetchManifest(options.manifest_uri, &manifest, error) ||
+      !ChooseBufferPolicy(manifest, options.buffer_budget_bytes, policy,
+                          error)) {
+    return false;
+  }
+
+  const std::pair<const char*, double> settings[] = {
+      {"streaming.bufferingGoal", policy->buffering_goal},
+      {"streaming.rebufferingGoal", policy->rebuffering_goal},
+      {"streaming.bufferBehind", policy->buffer_behind},
+  };
+  for (auto& setting : settings) {
+    auto configure = player_.Configure(setting.first, setting.second);
+    if (configure.has_error()) {
+      *error = "Configure failed: " + configure.error().message;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HeadlessPlayer::StartPlayback(const PlaybackOptions& options,
+                                   PlaybackReport* report) {
+  media_player_.SetPlaybackRate(options.playback_rate);
+
+  // The fast-start work begins with Load() rather than earlier, so startup
+  // times with and without it are measured from the same point.
+  std::unique_ptr<FastStart> fast_start;
+  if (options.fast_start) {
+    const shaka::media::DemuxerFactory* demuxers =
+        options.warm_up_demuxers ? options.warm_up_demuxers
+                                 : shaka::media::DemuxerFactory::GetFactory();
+    fast_start.reset(new FastStart(options.startup_proxy, options.manifest_uri,
+                                   options.bandwidth_estimate, demuxers));
+  }
+  if (options.recorder)
+    options.recorder->Start();
+  if (options.replayer)
+    options.replayer->Start();
+  const Clock::time_point start = Clock::now();
+  session_start_ = start;
+  if (fast_start)
+    fast_start->Start();
+  auto load = player_.Load(options.manifest_uri);
+  if (load.has_error()) {
+    report->error = "Load failed: " + load.error().message;
+    return false;
+  }
+  report->load_ms = MillisecondsSince(start);
+
+  media_player_.Play();
+  if (options.recorder)
+    options.recorder->RecordEvent(TraceEvent::Type::kPlay, 0);
+  const bool presented = video_renderer_.WaitForFirstFrame(
+      SecondsToDuration(options.startup_timeout_seconds));
+  if (fast_start)
+    report->fast_start_report = fast_start->Wait();
+  if (!presented) {
+    const std::string error = TakeError();
+    report->error = error.empty() ? "Timed out waiting for the first frame"
+                                  : error;
+    return false;
+  }
+  report->startup_ms =
+      MillisecondsBetween(start, video_renderer_.first_frame_time());
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  counting_rebuffers_ = true;
+  return true;
+}
+
+void HeadlessPlayer::PlayFor(const PlaybackOptions& options,
+                             PlaybackReport* report) {
+  using shaka::media::VideoPlaybackState;
+
+  const uint64_t frames_at_start = video_renderer_.frames_presented();
+  const FramePoolStats pool_at_start = frame_pool_->stats();
+  const double render_cpu_at_start = video_renderer_.render_cpu_seconds();
+  const double process_cpu_at_start = ProcessCpuSeconds();
+  const Clock::time_point start = Clock::now();
+  Clock::time_point end = start + SecondsToDuration(options.play_seconds);
+  size_t next_event = 0;
+  if (options.replay) {
+    end = session_start_ + SecondsToDuration(options.replay->duration_us /
+                                             1e6 / options.replay_speed);
+  }
+  while (Clock::now() < end) {
+    const VideoPlaybackState state = media_player_.PlaybackState();
+    if (state == VideoPlaybackState::Ended ||
+        state == VideoPlaybackState::Errored) {
+      break;
+    }
+    Clock::time_point wake = std::min(end, Clock::now() + kStateCheckInterval);
+    if (options.replay) {
+      report->replayed_events += ApplyDueEvents(options, &next_event);
+      if (next_event < options.replay->events.size())
+        wake = std::min(wake, session_start_ + ReplayTime(options, next_event));
+    }
+    std::this_thread::sleep_until(wake);
+  }
+
+  report->play_seconds = MillisecondsSince(start) / 1000;
+  report->frames_presented =
+      video_renderer_.frames_presented() - frames_at_start;
+  const FramePoolStats pool = frame_pool_->stats();
+  report->bytes_copied = pool.bytes_copied - pool_at_start.bytes_copied;
+  report->pool_exhausted = pool.exhausted - pool_at_start.exhausted;
+  report->render_cpu_ms =
+      (video_renderer_.render_cpu_seconds() - render_cpu_at_start) * 1000;
+  report->process_cpu_ms = (ProcessCpuSeconds() - process_cpu_at_start) * 1000;
+  report->rss_bytes = CurrentRssBytes();
+  if (report->play_seconds > 0) {
+    report->frames_per_second =
+        report->frames_presented / report->play_seconds;
+  }
+
+  if (options.recorder)
+    RecordVariantHistory(options.recorder);
+
+  auto stats = player_.GetStats();
+  if (!stats.has_error()) {
+    report->dropped_frames =
+        static_cast<uint64_t>(stats.results().droppedFrames);
+    report->estimated_bandwidth = stats.results().estimatedBandwidth;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    counting_rebuffers_ = false;
+    if (buffering_) {
+      buffering_ = false;
+      rebuffer_ms_ += MillisecondsSince(buffering_start_);
+    }
+    report->rebuffers = rebuffers_;
+    report->rebuffer_ms = rebuffer_ms_;
+  }
+
+  report->error = TakeError();
+  report->ok = report->error.empty();
+}
+
+void HeadlessPlayer::SeekAll(const PlaybackOptions& options,
+                             const SeekOptions& seek_options,
+                             SeekReport* report) {
+  // The keyframe index comes from the same manifest the player loaded.
+  Manifest manifest;
+  if (!FetchManifest(options.manifest_uri, &manifest, &report->error))
+    return;
+
+  int height = 0;
+  std::string codecs;
+  double frame_rate = kDefaultFrameRate;
+  auto tracks = player_.GetVariantTracks();
+  if (!tracks.has_error()) {
+    for (auto& track : tracks.results()) {
+      if (!track.active)
+        continue;
+      if (track.height)
+        height = *track.height;
+      if (track.frameRate && *track.frameRate > 0)
+        frame_rate = *track.frameRate;
+      codecs = track.codecs;
+    }
+  }
+  size_t representation = 0;
+  if (!FindVideoRepresentation(manifest, height, codecs, &representation)) {
+    report->error = "The manifest has no video representation";
+    return;
+  }
+
+  // Only keyframe seeks need the index, so exact seeks never pay for it.
+  // It bounds the frames the decoder may skip to the target's own GOP.
+  KeyframeIndexSet indexes(manifest, &FetchForIndex);
+  const KeyframeIndex* index = nullptr;
+  if (seek_options.mode == SeekMode::kKeyframe) {
+    const Clock::time_point start = Clock::now();
+    index = indexes.Get(representation, &report->error);
+    if (!index)
+      return;
+    report->index_build_ms = MillisecondsSince(start);
+    report->index_keyframes = index->size();
+  }
+
+  double duration = media_player_.Duration();
+  if (!std::isfinite(duration) || duration <= 0)
+    duration = manifest.duration;
+  const bool scrub = seek_options.pattern == SeekPattern::kScrub;
+  const Clock::duration wait = scrub
+      ? SecondsToDuration(seek_options.scrub_interval_ms / 1000)
+      : SecondsToDuration(seek_options.timeout_seconds);
+  // The decoded frame nearest an exact target is at most half a frame away.
+  const double tolerance = 0.5 / frame_rate;
+
+  std::vector<double> latency_ms;
+  std::vector<double> frames_decoded;
+  std::vector<double> landing_error_ms;
+  for (double position : PlanSeekTargets(seek_options, duration)) {
+    // Both modes seek to |position| itself; keyframe seeks only decode less
+    // on the way there.
+    if (index) {
+      video_decoder_->SetSkipWindow(index->AtOrBefore(position),
+                                    position - tolerance);
+    }
+    const uint64_t decodes_before = video_decoder_->decode_calls();
+    video_renderer_.ExpectFrameNear(position, tolerance);
+    const Clock::time_point start = Clock::now();
+    media_player_.SetCurrentTime(position);
+    if (options.recorder)
+      options.recorder->RecordEvent(TraceEvent::Type::kSeek, position);
+    report->seeks++;
+
+    Clock::time_point ready;
+    double landed;
+    const bool done =
+        video_renderer_.WaitForExpectedFrame(start + wait, &ready, &landed);
+    video_decoder_->ClearSkipWindow();
+    if (done) {
+      report->completed++;
+      latency_ms.push_back(MillisecondsBetween(start, ready));
+      frames_decoded.push_back(
+          static_cast<double>(video_decoder_->decode_calls() - decodes_before));
+      landing_error_ms.push_back(std::abs(landed - position) * 1000);
+      if (scrub)
+        std::this_thread::sleep_until(start + wait);
+    } else if (scrub) {
+      report->superseded++;
+    } else {
+      report->timeouts++;
+    }
+    if (media_player_.PlaybackState() ==
+        shaka::media::VideoPlaybackState::Errored) {
+      break;
+    }
+  }
+
+  report->latency_ms = Summarize(latency_ms);
+  report->frames_decoded = Summarize(frames_decoded);
+  report->landing_error_ms = Summarize(landing_error_ms);
+  report->error = TakeError();
+  report->ok = report->error.empty();
+}
+
+void HeadlessPlayer::RecordVariantHistory(TraceRecorder* recorder) {
+  auto stats = player_.GetStats();
+  if (stats.has_error())
+    return;
+  for (auto& choice : stats.results().switchHistory) {
+    if (choice.type == "variant") {
+      recorder->RecordEventAt(choice.timestamp, TraceEvent::Type::kVariant,
+                              choice.id);
+    }
+  }
+}
+
+uint64_t HeadlessPlayer::ApplyDueEvents(const PlaybackOptions& options,
+                                        size_t* next_event) {
+  const std::vector<TraceEvent>& events = options.replay->events;
+  uint64_t applied = 0;
+  while (*next_event < events.size() &&
+         session_start_ + ReplayTime(options, *next_event) <= Clock::now()) {
+    const TraceEvent& event = events[(*next_event)++];
+    applied++;
+    switch (event.type) {
+      case TraceEvent::Type::kPlay:
+        media_player_.Play();
+        break;
+      case TraceEvent::Type::kPause:
+        media_player_.Pause();
+        break;
+      case TraceEvent::Type::kSeek:
+        media_player_.SetCurrentTime(event.value);
+        break;
+      case TraceEvent::Type::kVariant: {
+        auto tracks = player_.GetVariantTracks();
+        if (tracks.has_error())
+          break;
+        for (auto& track : tracks.results()) {
+          if (track.id == static_cast<int64_t>(event.value) && !track.active)
+            player_.SelectVariantTrack(track, /* clear_buffer= */ false);
+        }
+        break;
+      }
+    }
+  }
+  return applied;
+}
+
+std::string HeadlessPlayer::TakeError() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  std::string ret;
+  ret.swap(error_);
+  return ret;
+}
+
+void HeadlessPlayer::OnError(const shaka::Error& error) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (error_.empty())
+    error_ = error.message;
+}
+
+void HeadlessPlayer::OnBuffering(bool is_buffering) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!counting_rebuffers_ || is_buffering == buffering_)
+    return;
+
+  buffering_ = is_buffering;
+  if (is_buffering) {
+    rebuffers_++;
+    buffering_start_ = Clock::now();
+  } else {
+    rebuffer_ms_ += MillisecondsSince(buffering_start_);
+  }
+}
+
+}  // namespace sample
@@ -0,0 +1,208 @@
+#ifndef SAMPLE_PLAYER_HEADLESS_PLAYER_H_
+#define SAMPLE_PLAYER_HEADLESS_PLAYER_H_
+
+#include <shaka/js_manager.h>
+#include <shaka/media/default_media_player.h>
+#include <shaka/player.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "base/clock.h"
+#include "media/buffer_policy.h"
+#include "media/frame_pool.h"
+#include "media/manifest.h"
+#include "net/caching_proxy.h"
+#include "net/session_trace.h"
+#include "net/trace_recorder.h"
+#include "net/trace_replayer.h"
+#include "player/fast_start.h"
+#include "player/null_audio_renderer.h"
+#include "player/null_video_renderer.h"
+#include "player/render_loop.h"
+#include "player/seek_benchmark.h"
+#include "player/stage_timing_filters.h"
+#include "player/timing_decoder.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** Describes one playback session. */
+struct PlaybackOptions {
+  std::string manifest_uri;
+  /** Wall-clock seconds to keep playing once the first frame is shown. */
+  double play_seconds = 10;
+  /** The media playback rate; above 1 measures decode throughput. */
+  double playback_rate = 1;
+  /** How long to wait for the first frame before giving up. */
+  double startup_timeout_seconds = 30;
+  /** How decoded frames are handed to the renderer. */
+  FrameHandoff frame_handoff = FrameHandoff::kZeroCopy;
+  /**
+   * The player's initial abr.defaultBandwidthEstimate, in bit/s, which picks
+   * the first variant.
+   */
+  double bandwidth_estimate = kDefaultBandwidthEstimate;
+  /** Overlap the startup work with Player::Load(); see FastStart. */
+  bool fast_start = false;
+  /** The proxy serving |manifest_uri|; required for fast start. */
+  CachingProxy* startup_proxy = nullptr;
+  /**
+   * The SDK's demuxer factory, from before the timing or pooling wrappers
+   * were installed, for fast start's warm-up.  Null means the factory
+   * installed at the time.
+   */
+  const shaka::media::DemuxerFactory* warm_up_demuxers = nullptr;
+  /**
+   * If not zero, the player's buffer lengths are chosen so buffered audio,
+   * video and text stay under this many bytes; see ChooseBufferPolicy().
+   */
+  uint64_t buffer_budget_bytes = 0;
+  /**
+   * If set, the session's events are recorded here.  It should also be
+   * serving |manifest_uri| so the network is recorded with them.
+   */
+  TraceRecorder* recorder = nullptr;
+  /**
+   * If set, the session replays this trace's events with ABR off, sped up by
+   * |replay_speed|, and lasts as long as the recording did at that speed
+   * instead of |play_seconds|.  |manifest_uri| should be served from the
+   * trace by |replayer|, made with the same speed.
+   */
+  const SessionTrace* replay = nullptr;
+  double replay_speed = 1;
+  /** Restarted at Load(), so recorded request times count from there. */
+  TraceReplayer* replayer = nullptr;
+};
+
+/** The measurements taken during one playback session. */
+struct PlaybackReport {
+  bool ok = false;
+  std::string error;
+
+  /** Time from calling Player::Load() until it resolved. */
+  double load_ms = 0;
+  /** Time from calling Player::Load() until the first frame was presented. */
+  double startup_ms = 0;
+  bool fast_start = false;
+  /** Set when |fast_start| is. */
+  FastStartReport fast_start_report;
+  /** The buffer lengths used, when a buffer budget was given. */
+  bool buffer_limited = false;
+  BufferPolicy buffer_policy;
+
+  /** Frames presented during the play window, after the first frame. */
+  uint64_t frames_presented = 0;
+  /** Wall-clock length of the play window. */
+  double play_seconds = 0;
+  double frames_per_second = 0;
+  uint64_t dropped_frames = 0;
+  /** Times playback stalled to buffer after the first frame was shown. */
+  uint64_t rebuffers = 0;
+  /** Total time spent stalled after the first frame was shown. */
+  double rebuffer_ms = 0;
+  /** The player's bandwidth estimate at the end of the session, in bit/s. */
+  double estimated_bandwidth = 0;
+
+  FrameHandoff frame_handoff = FrameHandoff::kZeroCopy;
+  /** Plane bytes copied into app buffers during the play window. */
+  uint64_t bytes_copied = 0;
+  /** Frames skipped because the renderer still held every pooled buffer. */
+  uint64_t pool_exhausted = 0;
+  /** Recorded events applied while replaying a trace. */
+  uint64_t replayed_events = 0;
+  /** CPU time of the render thread during the play window. */
+  double render_cpu_ms = 0;
+  /** CPU time of the whole process during the play window. */
+  double process_cpu_ms = 0;
+
+  /** Resident set size at the end of the play window, before unloading. */
+  uint64_t rss_bytes = 0;
+  uint64_t peak_rss_bytes = 0;
+};
+
+/** Writes |report| as a JSON object. */
+void WriteReport(const PlaybackReport& report, JsonWriter* writer);
+
+/**
+ * Drives one shaka::Player with null renderers.  Many instances may share a
+ * single JsManager, and with it the JavaScript and networking threads, and a
+ * single RenderLoop.
+ */
+class HeadlessPlayer : shaka::Player::Client {
+ public:
+  HeadlessPlayer(shaka::JsManager* engine, RenderLoop* render_loop);
+  ~HeadlessPlayer() override;
+
+  HeadlessPlayer(const HeadlessPlayer&) = delete;
+  HeadlessPlayer& operator=(const HeadlessPlayer&) = delete;
+
+  /** Loads, plays and unloads the given content, blocking throughout. */
+  PlaybackReport Run(const PlaybackOptions& options);
+
+  /**
+   * Loads the given content, pauses once the first frame is shown, seeks as
+   * |seek_options| describes, and unloads.
+   */
+  SeekReport RunSeeks(const PlaybackOptions& options,
+                      const SeekOptions& seek_options);
+
+ private:
+  /** Gives the renderer a new, empty frame pool. */
+  void ResetFramePool(FrameHandoff handoff);
+  /**
+   * Unloads the player and takes the frame pool back from the renderer.  Run
+   * after every session, however far it got.  An unload failure is reported
+   * only if the session was |*ok|.
+   */
+  void EndSession(bool* ok, std::string* error);
+  /** Routes decoding through counting decoders; call before Initialize(). */
+  void InstallDecoders();
+  bool Initialize(const PlaybackOptions& options, std::string* error);
+  bool ApplyBufferBudget(const PlaybackOptions& options, BufferPolicy* policy,
+                         std::string* error);
+  bool StartPlayback(const PlaybackOptions& options, PlaybackReport* report);
+  void PlayFor(const PlaybackOptions& options, PlaybackReport* report);
+  void SeekAll(const PlaybackOptions& options, const SeekOptions& seek_options,
+               SeekReport* report);
+  /** Records the player's variant switches since Load() as trace events. */
+  void RecordVariantHistory(TraceRecorder* recorder);
+  /** Applies the events of |trace| that are due; returns how many. */
+  uint64_t ApplyDueEvents(const PlaybackOptions& options, size_t* next_event);
+  std::string TakeError();
+
+  // Player::Client overrides.
+  void OnError(const shaka::Error& error) override;
+  void OnBuffering(bool is_buffering) override;
+
+  // Declared first so it outlives the renderer that holds its buffers.
+  std::unique_ptr<FramePool> frame_pool_;
+  NullVideoRenderer video_renderer_;
+  NullAudioRenderer audio_renderer_;
+  // Only used when stage timings are enabled or seeks are measured; these
+  // outlive the player.
+  StageTimingFilters timing_filters_;
+  std::unique_ptr<TimingDecoder> video_decoder_;
+  std::unique_ptr<TimingDecoder> audio_decoder_;
+  shaka::media::DefaultMediaPlayer media_player_;
+  shaka::Player player_;
+
+  // When Load() was called, which replayed events are timed from.
+  Clock::time_point session_start_;
+
+  std::mutex mutex_;
+  std::string error_;
+  // Stalls are only counted once the first frame has been presented.
+  bool counting_rebuffers_;
+  bool buffering_;
+  Clock::time_point buffering_start_;
+  uint64_t rebuffers_;
+  double rebuffer_ms_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_HEADLESS_PLAYER_H_
@@ -0,0 +1,37 @@
+#include "player/null_audio_renderer.h"
+
+namespace sample {
+
+NullAudioRenderer::NullAudioRenderer() : volume_(1), muted_(false) {}
+
+NullAudioRenderer::~NullAudioRenderer() {}
+
+void NullAudioRenderer::SetPlayer(
+    const shaka::media::MediaPlayer* /* player */) {}
+
+void NullAudioRenderer::Attach(
+    const shaka::media::DecodedStream* /* stream */) {}
+
+void NullAudioRenderer::Detach() {}
+
+double NullAudioRenderer::Volume() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return volume_;
+}
+
+void NullAudioRenderer::SetVolume(double volume) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  volume_ = volume;
+}
+
+bool NullAudioRenderer::Muted() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return muted_;
+}
+
+void NullAudioRenderer::SetMuted(bool muted) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  muted_ = muted;
+}
+
+}  // namespace sample
@@ -0,0 +1,41 @@
+#ifndef SAMPLE_PLAYER_NULL_AUDIO_RENDERER_H_
+#define SAMPLE_PLAYER_NULL_AUDIO_RENDERER_H_
+
+#include <shaka/media/media_player.h>
+#include <shaka/media/renderer.h>
+#include <shaka/media/streams.h>
+
+#include <mutex>
+
+namespace sample {
+
+/**
+ * An AudioRenderer that discards all audio.  It only tracks the volume state
+ * the player expects to be able to read back.
+ */
+class NullAudioRenderer final : public shaka::media::AudioRenderer {
+ public:
+  NullAudioRenderer();
+  ~NullAudioRenderer() override;
+
+  NullAudioRenderer(const NullAudioRenderer&) = delete;
+  NullAudioRenderer& operator=(const NullAudioRenderer&) = delete;
+
+  // AudioRenderer overrides.
+  void SetPlayer(const shaka::media::MediaPlayer* player) override;
+  void Attach(const shaka::media::DecodedStream* stream) override;
+  void Detach() override;
+  double Volume() const override;
+  void SetVolume(double volume) override;
+  bool Muted() const override;
+  void SetMuted(bool muted) override;
+
+ private:
+  mutable std::mutex mutex_;
+  double volume_;
+  bool muted_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_NULL_AUDIO_RENDERER_H_
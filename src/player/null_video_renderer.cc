@@ -0,0 +1,205 @@
+#include "player/null_video_renderer.h"
+
+#include <shaka/media/frames.h>
+#include <shaka/variant.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/process_stats.h"
+#include "base/stage_timings.h"
+
+namespace sample {
+
+namespace {
+
+/** Describes the plane layout of a decoded frame for the FramePool. */
+FramePlanes PlanesForFrame(const shaka::media::DecodedFrame& frame) {
+  using shaka::media::PixelFormat;
+
+  const PixelFormat format =
+      shaka::holds_alternative<PixelFormat>(frame.format)
+          ? shaka::get<PixelFormat>(frame.format)
+          : PixelFormat::Unknown;
+  const uint32_t height = frame.stream_info->height;
+
+  FramePlanes ret;
+  ret.count = std::min(frame.data.size(), FramePlanes::kMaxPlanes);
+  for (size_t i = 0; i < ret.count; i++) {
+    ret.data[i] = frame.data[i];
+    ret.linesize[i] = frame.linesize[i];
+    switch (format) {
+      case PixelFormat::YUV420P:
+      case PixelFormat::NV12:
+        ret.rows[i] = i == 0 ? height : (height + 1) / 2;
+        break;
+      case PixelFormat::RGB24:
+        ret.rows[i] = height;
+        break;
+      default:
+        // Hardware and unknown formats have no CPU-readable layout; they are
+        // passed through without copying.
+        ret.rows[i] = 0;
+        break;
+    }
+  }
+  return ret;
+}
+
+}  // namespace
+
+NullVideoRenderer::NullVideoRenderer(RenderLoop* loop)
+    : loop_(loop),
+      player_(nullptr),
+      stream_(nullptr),
+      last_pts_(NAN),
+      has_first_frame_(false),
+      expected_time_(NAN),
+      expected_tolerance_(0),
+      expected_ready_(false),
+      expected_frame_time_(NAN),
+      frames_presented_(0),
+      render_cpu_seconds_(0),
+      frame_pool_(nullptr) {
+  loop_->AddClient(this);
+}
+
+NullVideoRenderer::~NullVideoRenderer() {
+  loop_->RemoveClient(this);
+}
+
+bool NullVideoRenderer::WaitForFirstFrame(Clock::duration timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return cond_.wait_for(lock, timeout, [this]() { return has_first_frame_; });
+}
+
+Clock::time_point NullVideoRenderer::first_frame_time() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return first_frame_time_;
+}
+
+void NullVideoRenderer::ExpectFrameNear(double time, double tolerance) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  expected_time_ = time;
+  expected_tolerance_ = tolerance;
+  expected_ready_ = false;
+}
+
+bool NullVideoRenderer::WaitForExpectedFrame(Clock::time_point deadline,
+                                             Clock::time_point* ready_time,
+                                             double* frame_time) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!cond_.wait_until(lock, deadline, [this]() { return expected_ready_; }))
+    return false;
+  *ready_time = expected_ready_time_;
+  *frame_time = expected_frame_time_;
+  return true;
+}
+
+void NullVideoRenderer::SetFramePool(FramePool* pool) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  front_buffer_.Reset();
+  frame_pool_ = pool;
+}
+
+void NullVideoRenderer::OnSeeking() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  last_pts_ = NAN;
+}
+
+void NullVideoRenderer::SetPlayer(const shaka::media::MediaPlayer* player) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  player_ = player;
+}
+
+void NullVideoRenderer::Attach(const shaka::media::DecodedStream* stream) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stream_ = stream;
+  last_pts_ = NAN;
+}
+
+void NullVideoRenderer::Detach() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  stream_ = nullptr;
+  front_buffer_.Reset();
+}
+
+struct shaka::media::VideoPlaybackQuality
+NullVideoRenderer::VideoPlaybackQuality() const {
+  struct shaka::media::VideoPlaybackQuality ret;
+  ret.total_video_frames = static_cast<uint32_t>(frames_presented());
+  return ret;
+}
+
+bool NullVideoRenderer::SetVideoFillMode(
+    shaka::media::VideoFillMode /* mode */) {
+  // Nothing is drawn, so every fill mode is trivially supported.
+  return true;
+}
+
+void NullVideoRenderer::OnTick() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!player_ || !stream_)
+    return;
+
+  // The worker thread is shared, so only the time spent on this renderer is
+  // attributed to it.
+  const double cpu_start = ThreadCpuSeconds();
+  PresentUpTo(player_->CurrentTime());
+  CheckExpectedFrame();
+  render_cpu_seconds_.store(
+      render_cpu_seconds_.load(std::memory_order_relaxed) + ThreadCpuSeconds() -
+          cpu_start,
+      std::memory_order_relaxed);
+}
+
+void NullVideoRenderer::PresentUpTo(double time) {
+  using shaka::media::FrameLocation;
+
+  // A large backwards jump without a seek event (e.g. a loop) restarts the
+  // walk from the playhead.
+  if (!std::isnan(last_pts_) && time + 1 < last_pts_)
+    last_pts_ = NAN;
+
+  while (true) {
+    std::shared_ptr<shaka::media::DecodedFrame> frame =
+        std::isnan(last_pts_) ? stream_->GetFrame(time, FrameLocation::Near)
+                              : stream_->GetFrame(last_pts_,
+                                                  FrameLocation::After);
+    if (!frame || frame->pts > time)
+      break;
+    if (!std::isnan(last_pts_) && frame->pts <= last_pts_)
+      break;
+
+    ScopedStageTimer timer(Stage::kRender);
+    last_pts_ = frame->pts;
+    frames_presented_.fetch_add(1, std::memory_order_relaxed);
+    if (frame_pool_) {
+      // Assigning releases the previous front buffer back to the pool.
+      front_buffer_ =
+          frame_pool_->Wrap(PlanesForFrame(*frame), frame->pts, frame);
+    }
+    if (!has_first_frame_) {
+      has_first_frame_ = true;
+      first_frame_time_ = Clock::now();
+      cond_.notify_all();
+    }
+  }
+}
+
+void NullVideoRenderer::CheckExpectedFrame() {
+  using shaka::media::FrameLocation;
+
+  if (std::isnan(expected_time_) || expected_ready_)
+    return;
+  std::shared_ptr<shaka::media::DecodedFrame> frame =
+      stream_->GetFrame(expected_time_, FrameLocation::Near);
+  if (frame && std::abs(frame->pts - expected_time_) <= expected_tolerance_) {
+    expected_ready_ = true;
+    expected_ready_time_ = Clock::now();
+    expected_frame_time_ = frame->pts;
+    cond_.notify_all();
+  }
+}
+
+}  // namespace sample
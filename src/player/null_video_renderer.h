@@ -0,0 +1,120 @@
+#ifndef SAMPLE_PLAYER_NULL_VIDEO_RENDERER_H_
+#define SAMPLE_PLAYER_NULL_VIDEO_RENDERER_H_
+
+#include <shaka/media/media_player.h>
+#include <shaka/media/renderer.h>
+#include <shaka/media/streams.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "base/clock.h"
+#include "media/frame_pool.h"
+#include "player/render_loop.h"
+
+namespace sample {
+
+/**
+ * A VideoRenderer that consumes decoded frames without drawing them.  On each
+ * RenderLoop tick it follows the playhead and counts every frame it passed, so
+ * the count reflects decoder output even when playing faster than real time.
+ *
+ * When a FramePool is set, each presented frame is handed to the pool and held
+ * as the "front buffer" until the next one replaces it, the way a real
+ * renderer holds the frame on screen.
+ */
+class NullVideoRenderer final : public shaka::media::VideoRenderer,
+                                RenderLoop::Client {
+ public:
+  /** |loop| drives this renderer and must outlive it. */
+  explicit NullVideoRenderer(RenderLoop* loop);
+  ~NullVideoRenderer() override;
+
+  NullVideoRenderer(const NullVideoRenderer&) = delete;
+  NullVideoRenderer& operator=(const NullVideoRenderer&) = delete;
+
+  /**
+   * Blocks until a frame has been presented or |timeout| passes.  Returns
+   * whether a frame was presented.
+   */
+  bool WaitForFirstFrame(Clock::duration timeout);
+
+  /** The time the first frame was presented; only valid once presented. */
+  Clock::time_point first_frame_time() const;
+
+  /**
+   * Starts watching for a decoded frame within |tolerance| seconds of |time|,
+   * e.g. the target of a seek that is about to start.  Frames are looked up
+   * in the decoded stream, so this works while paused.
+   */
+  void ExpectFrameNear(double time, double tolerance);
+
+  /**
+   * Blocks until the frame given to ExpectFrameNear() has been decoded or
+   * |deadline| passes.  On success sets |ready_time| to when it was seen and
+   * |frame_time| to its presentation time.
+   */
+  bool WaitForExpectedFrame(Clock::time_point deadline,
+                            Clock::time_point* ready_time,
+                            double* frame_time);
+
+  /** The number of distinct frames presented so far. */
+  uint64_t frames_presented() const {
+    return frames_presented_.load(std::memory_order_relaxed);
+  }
+
+  /** CPU time spent presenting frames for this renderer, in seconds. */
+  double render_cpu_seconds() const {
+    return render_cpu_seconds_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Sets the pool presented frames are handed off through, or null to only
+   * count frames.  The pool must outlive its use by this renderer.
+   */
+  void SetFramePool(FramePool* pool);
+
+  // MediaPlayer::Client overrides.
+  void OnSeeking() override;
+
+  // VideoRenderer overrides.
+  void SetPlayer(const shaka::media::MediaPlayer* player) override;
+  void Attach(const shaka::media::DecodedStream* stream) override;
+  void Detach() override;
+  struct shaka::media::VideoPlaybackQuality VideoPlaybackQuality()
+      const override;
+  bool SetVideoFillMode(shaka::media::VideoFillMode mode) override;
+
+ private:
+  // RenderLoop::Client overrides.
+  void OnTick() override;
+
+  void PresentUpTo(double time);
+  void CheckExpectedFrame();
+
+  RenderLoop* const loop_;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  const shaka::media::MediaPlayer* player_;
+  const shaka::media::DecodedStream* stream_;
+  // The pts of the last frame presented, or NAN to start from the playhead.
+  double last_pts_;
+  bool has_first_frame_;
+  Clock::time_point first_frame_time_;
+  // The frame ExpectFrameNear() waits for, or NAN.
+  double expected_time_;
+  double expected_tolerance_;
+  bool expected_ready_;
+  Clock::time_point expected_ready_time_;
+  double expected_frame_time_;
+  std::atomic<uint64_t> frames_presented_;
+  std::atomic<double> render_cpu_seconds_;
+  FramePool* frame_pool_;
+  FrameRef front_buffer_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_NULL_VIDEO_RENDERER_H_
@@ -0,0 +1,109 @@
+#include "player/pooled_demuxer.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace sample {
+
+namespace {
+
+/** An EncodedFrame whose bytes live in a SampleArena. */
+class PooledEncodedFrame final : public shaka::media::EncodedFrame {
+ public:
+  /** Copies |source| into |buffer|, which must be at least as large. */
+  PooledEncodedFrame(const shaka::media::EncodedFrame& source,
+                     SampleBuffer buffer)
+      : shaka::media::EncodedFrame(
+            source.stream_info, source.encryption_info, source.pts,
+            source.dts, source.duration, source.is_key_frame, buffer.data(),
+            source.data_size, source.timestamp_offset),
+        buffer_(std::move(buffer)) {
+    std::memcpy(buffer_.data(), source.data, source.data_size);
+  }
+
+ private:
+  const SampleBuffer buffer_;
+};
+
+StreamType StreamTypeForMime(const std::string& mime_type) {
+  if (mime_type.compare(0, 6, "video/") == 0)
+    return StreamType::kVideo;
+  if (mime_type.compare(0, 6, "audio/") == 0)
+    return StreamType::kAudio;
+  return StreamType::kText;
+}
+
+class PooledDemuxer final : public shaka::media::Demuxer {
+ public:
+  PooledDemuxer(std::unique_ptr<shaka::media::Demuxer> inner,
+                SampleArena* arena, StreamType type)
+      : inner_(std::move(inner)), arena_(arena), type_(type) {}
+
+  bool Demux(double timestamp_offset, const uint8_t* data, size_t size,
+             std::vector<std::shared_ptr<shaka::media::EncodedFrame>>* frames)
+      override {
+    const size_t first = frames->size();
+    if (!inner_->Demux(timestamp_offset, data, size, frames))
+      return false;
+    for (size_t i = first; i < frames->size(); i++) {
+      const shaka::media::EncodedFrame& frame = *(*frames)[i];
+      if (frame.data_size == 0)
+        continue;
+      // Replacing the pointer frees the demuxer's copy.
+      (*frames)[i] = std::make_shared<PooledEncodedFrame>(
+          frame, arena_->Allocate(frame.data_size, type_));
+    }
+    return true;
+  }
+
+  void Reset() override {
+    inner_->Reset();
+  }
+
+ private:
+  const std::unique_ptr<shaka::media::Demuxer> inner_;
+  SampleArena* const arena_;
+  const StreamType type_;
+};
+
+}  // namespace
+
+PooledDemuxerFactory::PooledDemuxerFactory(
+    const shaka::media::DemuxerFactory* inner, SampleArena* arena)
+    : inner_(inner), arena_(arena), installed_(false) {}
+
+PooledDemuxerFactory::~PooledDemuxerFactory() {
+  if (installed_)
+    shaka::media::DemuxerFactory::SetFactory(inner_);
+}
+
+std::unique_ptr<PooledDemuxerFactory> PooledDemuxerFactory::Install(
+    SampleArena* arena) {
+  std::unique_ptr<PooledDemuxerFactory> ret(new PooledDemuxerFactory(
+      shaka::media::DemuxerFactory::GetFactory(), arena));
+  shaka::media::DemuxerFactory::SetFactory(ret.get());
+  ret->installed_ = true;
+  return ret;
+}
+
+bool PooledDemuxerFactory::IsTypeSupported(const std::string& mime_type) const {
+  return inner_->IsTypeSupported(mime_type);
+}
+
+bool PooledDemuxerFactory::IsCodecVideo(const std::string& codec) const {
+  return inner_->IsCodecVideo(codec);
+}
+
+std::unique_ptr<shaka::media::Demuxer> PooledDemuxerFactory::Create(
+    const std::string& mime_type,
+    shaka::media::Demuxer::Client* client) const {
+  std::unique_ptr<shaka::media::Demuxer> inner =
+      inner_->Create(mime_type, client);
+  if (!inner)
+    return nullptr;
+  return std::unique_ptr<shaka::media::Demuxer>(new PooledDemuxer(
+      std::move(inner), arena_, StreamTypeForMime(mime_type)));
+}
+
+}  // namespace sample
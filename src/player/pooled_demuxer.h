@@ -0,0 +1,50 @@
+#ifndef SAMPLE_PLAYER_POOLED_DEMUXER_H_
+#define SAMPLE_PLAYER_POOLED_DEMUXER_H_
+
+#include <shaka/media/demuxer.h>
+
+#include <memory>
+#include <string>
+
+#include "media/sample_arena.h"
+
+namespace sample {
+
+/**
+ * A DemuxerFactory whose demuxers move each demuxed sample into a
+ * SampleArena.  The demuxer's own per-sample allocation is freed as soon as
+ * Demux() returns, so samples held in the player's buffers live in the
+ * arena's slabs instead of being scattered across the heap.  Demuxers are
+ * created process-wide, so Install() wraps the current factory for every
+ * player.
+ */
+class PooledDemuxerFactory final : public shaka::media::DemuxerFactory {
+ public:
+  PooledDemuxerFactory(const shaka::media::DemuxerFactory* inner,
+                       SampleArena* arena);
+  ~PooledDemuxerFactory() override;
+
+  PooledDemuxerFactory(const PooledDemuxerFactory&) = delete;
+  PooledDemuxerFactory& operator=(const PooledDemuxerFactory&) = delete;
+
+  /**
+   * Wraps the current global factory.  The result must outlive every player
+   * and is uninstalled when destroyed; |arena| must outlive every sample.
+   */
+  static std::unique_ptr<PooledDemuxerFactory> Install(SampleArena* arena);
+
+  bool IsTypeSupported(const std::string& mime_type) const override;
+  bool IsCodecVideo(const std::string& codec) const override;
+  std::unique_ptr<shaka::media::Demuxer> Create(
+      const std::string& mime_type,
+      shaka::media::Demuxer::Client* client) const override;
+
+ private:
+  const shaka::media::DemuxerFactory* const inner_;
+  SampleArena* const arena_;
+  bool installed_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_POOLED_DEMUXER_H_
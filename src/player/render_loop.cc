@@ -0,0 +1,69 @@
+#include "player/render_loop.h"
+
+#include <algorithm>
+
+namespace sample {
+
+RenderLoop::RenderLoop(size_t thread_count, std::chrono::milliseconds interval)
+    : interval_(interval) {
+  for (size_t i = 0; i < std::max<size_t>(thread_count, 1); i++) {
+    workers_.emplace_back(new Worker);
+    Worker* worker = workers_.back().get();
+    worker->thread = std::thread(&RenderLoop::ThreadMain, this, worker);
+  }
+}
+
+RenderLoop::~RenderLoop() {
+  for (auto& worker : workers_) {
+    {
+      std::unique_lock<std::mutex> lock(worker->mutex);
+      worker->shutdown = true;
+    }
+    worker->cond.notify_all();
+    worker->thread.join();
+  }
+}
+
+void RenderLoop::AddClient(Client* client) {
+  Worker* best = nullptr;
+  size_t best_count = 0;
+  for (auto& worker : workers_) {
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    if (!best || worker->clients.size() < best_count) {
+      best = worker.get();
+      best_count = worker->clients.size();
+    }
+  }
+
+  std::unique_lock<std::mutex> lock(best->mutex);
+  best->clients.push_back(client);
+}
+
+void RenderLoop::RemoveClient(Client* client) {
+  for (auto& worker : workers_) {
+    // Ticks run with the worker's lock held, so acquiring it here waits for
+    // any in-progress OnTick() of this client to finish.
+    std::unique_lock<std::mutex> lock(worker->mutex);
+    auto it = std::find(worker->clients.begin(), worker->clients.end(), client);
+    if (it != worker->clients.end()) {
+      worker->clients.erase(it);
+      return;
+    }
+  }
+}
+
+void RenderLoop::ThreadMain(Worker* worker) {
+  std::unique_lock<std::mutex> lock(worker->mutex);
+  auto next_tick = std::chrono::steady_clock::now();
+  while (!worker->shutdown) {
+    for (Client* client : worker->clients)
+      client->OnTick();
+
+    // Ticks keep a fixed cadence; if a pass overran, start the next at once.
+    next_tick = std::max(next_tick + interval_,
+                         std::chrono::steady_clock::now());
+    worker->cond.wait_until(lock, next_tick);
+  }
+}
+
+}  // namespace sample
@@ -0,0 +1,68 @@
+#ifndef SAMPLE_PLAYER_RENDER_LOOP_H_
+#define SAMPLE_PLAYER_RENDER_LOOP_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sample {
+
+/** The tick interval renderers use to follow the playhead. */
+constexpr std::chrono::milliseconds kDefaultRenderInterval{4};
+
+/**
+ * A fixed pool of render threads shared by every renderer in the process.
+ * Each registered client is ticked periodically by one worker, so N players
+ * need only as many render threads as the pool has rather than N.
+ */
+class RenderLoop {
+ public:
+  class Client {
+   public:
+    virtual ~Client() {}
+
+    /** Called on a worker thread once per interval. */
+    virtual void OnTick() = 0;
+  };
+
+  RenderLoop(size_t thread_count, std::chrono::milliseconds interval);
+  ~RenderLoop();
+
+  RenderLoop(const RenderLoop&) = delete;
+  RenderLoop& operator=(const RenderLoop&) = delete;
+
+  size_t thread_count() const {
+    return workers_.size();
+  }
+
+  /** Starts ticking |client| on the least loaded worker. */
+  void AddClient(Client* client);
+
+  /**
+   * Stops ticking |client|.  Once this returns, OnTick() is not running and
+   * will not be called again.
+   */
+  void RemoveClient(Client* client);
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<Client*> clients;
+    bool shutdown = false;
+    std::thread thread;
+  };
+
+  void ThreadMain(Worker* worker);
+
+  const std::chrono::milliseconds interval_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_RENDER_LOOP_H_
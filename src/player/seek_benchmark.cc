@@ -0,0 +1,124 @@
+#include "player/seek_benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "base/json_writer.h"
+
+namespace sample {
+
+namespace {
+
+/** Seeks stay this far from the end so there is always a frame to show. */
+constexpr double kEndMarginSeconds = 1;
+
+}  // namespace
+
+bool ParseSeekPattern(const std::string& name, SeekPattern* pattern) {
+  if (name == "random") {
+    *pattern = SeekPattern::kRandom;
+    return true;
+  }
+  if (name == "scrub") {
+    *pattern = SeekPattern::kScrub;
+    return true;
+  }
+  return false;
+}
+
+const char* SeekPatternName(SeekPattern pattern) {
+  return pattern == SeekPattern::kRandom ? "random" : "scrub";
+}
+
+bool ParseSeekMode(const std::string& name, SeekMode* mode) {
+  if (name == "exact") {
+    *mode = SeekMode::kExact;
+    return true;
+  }
+  if (name == "keyframe") {
+    *mode = SeekMode::kKeyframe;
+    return true;
+  }
+  return false;
+}
+
+const char* SeekModeName(SeekMode mode) {
+  return mode == SeekMode::kExact ? "exact" : "keyframe";
+}
+
+void WriteSeekReport(const SeekReport& report, JsonWriter* writer) {
+  writer->BeginObject();
+  writer->Key("ok");
+  writer->Bool(report.ok);
+  if (!report.ok) {
+    writer->Key("error");
+    writer->String(report.error);
+  }
+  writer->Key("pattern");
+  writer->String(SeekPatternName(report.pattern));
+  writer->Key("mode");
+  writer->String(SeekModeName(report.mode));
+  writer->Key("seeks");
+  writer->Uint(report.seeks);
+  writer->Key("completed");
+  writer->Uint(report.completed);
+  writer->Key("superseded");
+  writer->Uint(report.superseded);
+  writer->Key("timeouts");
+  writer->Uint(report.timeouts);
+  writer->Key("latency_ms");
+  WriteSummary(report.latency_ms, writer);
+  writer->Key("frames_decoded");
+  WriteSummary(report.frames_decoded, writer);
+  writer->Key("landing_error_ms");
+  WriteSummary(report.landing_error_ms, writer);
+  if (report.mode == SeekMode::kKeyframe) {
+    writer->Key("index_build_ms");
+    writer->Number(report.index_build_ms);
+    writer->Key("index_keyframes");
+    writer->Uint(report.index_keyframes);
+  }
+  writer->EndObject();
+}
+
+std::vector<double> PlanSeekTargets(const SeekOptions& options,
+                                    double duration) {
+  const double end = std::max(0.0, duration - kEndMarginSeconds);
+  std::vector<double> ret;
+  if (options.pattern == SeekPattern::kRandom) {
+    std::mt19937 random(options.seed);
+    std::uniform_real_distribution<double> position(0, end);
+    for (size_t i = 0; i < options.count; i++)
+      ret.push_back(position(random));
+  } else {
+    for (size_t i = 0; i < options.count; i++) {
+      const double position = (i + 1) * options.scrub_step_seconds;
+      ret.push_back(end > 0 ? std::fmod(position, end) : 0);
+    }
+  }
+  return ret;
+}
+
+bool FindVideoRepresentation(const Manifest& manifest, int height,
+                             const std::string& codecs, size_t* index) {
+  bool found = false;
+  for (size_t i = 0; i < manifest.representations.size(); i++) {
+    const Representation& representation = manifest.representations[i];
+    if (representation.type != StreamType::kVideo)
+      continue;
+    const bool matches =
+        static_cast<int>(representation.height) == height &&
+        (representation.codecs.empty() ||
+         codecs.find(representation.codecs) != std::string::npos);
+    if (matches || !found) {
+      *index = i;
+      found = true;
+    }
+    if (matches)
+      return true;
+  }
+  return found;
+}
+
+}  // namespace sample
@@ -0,0 +1,102 @@
+#ifndef SAMPLE_PLAYER_SEEK_BENCHMARK_H_
+#define SAMPLE_PLAYER_SEEK_BENCHMARK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/summary.h"
+#include "media/manifest.h"
+
+namespace sample {
+
+class JsonWriter;
+
+/** Where the seeks of a benchmark go. */
+enum class SeekPattern {
+  /** Uniformly random positions, each given time to complete. */
+  kRandom,
+  /** Small forward steps at a fixed interval, like dragging a scrub bar. */
+  kScrub,
+};
+
+/** How the decoder reaches a seek position.  Both modes land on it. */
+enum class SeekMode {
+  /** Decode every frame from the keyframe before the position. */
+  kExact,
+  /**
+   * Use a keyframe index to skip the frames between that keyframe and the
+   * position that nothing the target depends on (H.264 only).
+   */
+  kKeyframe,
+};
+
+bool ParseSeekPattern(const std::string& name, SeekPattern* pattern);
+const char* SeekPatternName(SeekPattern pattern);
+bool ParseSeekMode(const std::string& name, SeekMode* mode);
+const char* SeekModeName(SeekMode mode);
+
+struct SeekOptions {
+  SeekPattern pattern = SeekPattern::kRandom;
+  SeekMode mode = SeekMode::kExact;
+  size_t count = 50;
+  double scrub_step_seconds = 0.5;
+  /** Time between scrub seeks; a seek not done by then is superseded. */
+  double scrub_interval_ms = 100;
+  /** Seeds random positions, so modes can be compared position by position. */
+  uint32_t seed = 1;
+  /** How long a random seek may take before it counts as timed out. */
+  double timeout_seconds = 10;
+};
+
+/** The measurements of one seek benchmark session. */
+struct SeekReport {
+  bool ok = false;
+  std::string error;
+  SeekPattern pattern = SeekPattern::kRandom;
+  SeekMode mode = SeekMode::kExact;
+
+  size_t seeks = 0;
+  /** Seeks whose target frame was decoded in time. */
+  size_t completed = 0;
+  /** Scrub seeks replaced by the next one before their frame appeared. */
+  size_t superseded = 0;
+  /** Random seeks that did not complete within the timeout. */
+  size_t timeouts = 0;
+  /** From SetCurrentTime() until the target frame was decoded. */
+  Summary latency_ms;
+  /**
+   * Video frames decoded per completed seek.  This includes frames decoded
+   * ahead of the target before it appeared, not only those it depended on.
+   */
+  Summary frames_decoded;
+  /** How far the frame a completed seek landed on is from its position. */
+  Summary landing_error_ms;
+
+  /** Time to build the keyframe index before the first keyframe seek. */
+  double index_build_ms = 0;
+  size_t index_keyframes = 0;
+};
+
+void WriteSeekReport(const SeekReport& report, JsonWriter* writer);
+
+/**
+ * Returns the positions |options| seeks to in content |duration| seconds long.
+ * Random positions depend only on the seed; scrubbing steps forward from the
+ * start and wraps around before the end.
+ */
+std::vector<double> PlanSeekTargets(const SeekOptions& options,
+                                    double duration);
+
+/**
+ * Finds the video representation playing given the active variant track's
+ * |height| and combined |codecs|.  Falls back to the first video
+ * representation.  Returns false if there is none.
+ */
+bool FindVideoRepresentation(const Manifest& manifest, int height,
+                             const std::string& codecs, size_t* index);
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_SEEK_BENCHMARK_H_
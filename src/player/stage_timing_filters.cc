@@ -0,0 +1,98 @@
+#include "player/stage_timing_filters.h"
+
+#include "base/stage_timings.h"
+
+namespace sample {
+
+namespace {
+
+/**
+ * Longer than the player retries a request for, with its default of two
+ * attempts of up to 30 s and their back-off.
+ */
+constexpr std::chrono::minutes kMaxPendingAge{2};
+
+std::future<shaka::optional<shaka::Error>> Continue() {
+  std::promise<shaka::optional<shaka::Error>> promise;
+  promise.set_value(shaka::nullopt);
+  return promise.get_future();
+}
+
+bool IsTimed(shaka::RequestType type) {
+  return type == shaka::RequestType::Manifest ||
+         type == shaka::RequestType::Segment;
+}
+
+}  // namespace
+
+StageTimingFilters::StageTimingFilters() : awaiting_first_segment_(false) {}
+
+StageTimingFilters::~StageTimingFilters() {}
+
+std::future<shaka::optional<shaka::Error>> StageTimingFilters::OnRequestFilter(
+    shaka::RequestType type, shaka::Request* request) {
+  if (!StageTimingsEnabled() || !IsTimed(type) || request->uris.empty())
+    return Continue();
+
+  const Clock::time_point now = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (type == shaka::RequestType::Segment && awaiting_first_segment_) {
+    awaiting_first_segment_ = false;
+    RecordStage(Stage::kManifestParse, now - manifest_received_);
+  }
+  ExpireLocked(now);
+  pending_.emplace(request->uris[0], now);
+  return Continue();
+}
+
+std::future<shaka::optional<shaka::Error>> StageTimingFilters::OnResponseFilter(
+    shaka::RequestType type, shaka::Response* response) {
+  if (!StageTimingsEnabled() || !IsTimed(type))
+    return Continue();
+
+  const Clock::time_point now = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  // After a redirect |uri| is the final location, so match the original.
+  auto it = FindOldest(response->originalUri);
+  if (it == pending_.end())
+    it = FindOldest(response->uri);
+  if (it == pending_.end())
+    return Continue();
+
+  const Clock::time_point requested = it->second;
+  pending_.erase(it);
+  if (type == shaka::RequestType::Manifest) {
+    RecordStage(Stage::kManifestFetch, now - requested);
+    // Only the initial parse is timed; live updates happen during playback.
+    if (manifest_received_ == Clock::time_point()) {
+      awaiting_first_segment_ = true;
+      manifest_received_ = now;
+    }
+  } else {
+    RecordStage(Stage::kSegmentFetch, now - requested);
+  }
+  return Continue();
+}
+
+void StageTimingFilters::Reset() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  pending_.clear();
+}
+
+std::multimap<std::string, Clock::time_point>::iterator
+StageTimingFilters::FindOldest(const std::string& uri) {
+  // Equal keys keep their insertion order, so the first is the oldest.
+  auto it = pending_.lower_bound(uri);
+  return it != pending_.end() && it->first == uri ? it : pending_.end();
+}
+
+void StageTimingFilters::ExpireLocked(Clock::time_point now) {
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (now - it->second > kMaxPendingAge)
+      it = pending_.erase(it);
+    else
+      ++it;
+  }
+}
+
+}  // namespace sample
@@ -0,0 +1,59 @@
+#ifndef SAMPLE_PLAYER_STAGE_TIMING_FILTERS_H_
+#define SAMPLE_PLAYER_STAGE_TIMING_FILTERS_H_
+
+#include <shaka/net.h>
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "base/clock.h"
+
+namespace sample {
+
+/**
+ * Network filters that time the fetch stages of one player.
+ *
+ * Manifest and segment fetches are timed from the request filter to the
+ * response filter.  The player parses the manifest in JavaScript where it
+ * cannot be hooked, so the manifest parse stage is taken as the time from the
+ * manifest response to the first segment request, which also covers stream
+ * selection.
+ *
+ * The filters are not told when a request fails, so a request that gets no
+ * response within two minutes is forgotten, and Reset() forgets every
+ * request in flight when a session ends.
+ */
+class StageTimingFilters : public shaka::NetworkFilters {
+ public:
+  StageTimingFilters();
+  ~StageTimingFilters() override;
+
+  StageTimingFilters(const StageTimingFilters&) = delete;
+  StageTimingFilters& operator=(const StageTimingFilters&) = delete;
+
+  std::future<shaka::optional<shaka::Error>> OnRequestFilter(
+      shaka::RequestType type, shaka::Request* request) override;
+  std::future<shaka::optional<shaka::Error>> OnResponseFilter(
+      shaka::RequestType type, shaka::Response* response) override;
+
+  /** Forgets requests still in flight, e.g. those aborted by an unload. */
+  void Reset();
+
+ private:
+  std::multimap<std::string, Clock::time_point>::iterator FindOldest(
+      const std::string& uri);
+  /** Forgets requests that have waited too long for a response. */
+  void ExpireLocked(Clock::time_point now);
+
+  std::mutex mutex_;
+  /** Requests awaiting a response; a URI repeats for byte-range requests. */
+  std::multimap<std::string, Clock::time_point> pending_;
+  bool awaiting_first_segment_;
+  Clock::time_point manifest_received_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_STAGE_TIMING_FILTERS_H_
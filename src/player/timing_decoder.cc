@@ -0,0 +1,73 @@
+#include "player/timing_decoder.h"
+
+#include <utility>
+
+#include "base/stage_timings.h"
+#include "media/h264_frames.h"
+
+namespace sample {
+
+TimingDecoder::TimingDecoder(std::unique_ptr<shaka::media::Decoder> inner)
+    : inner_(std::move(inner)),
+      decode_calls_(0),
+      skipped_frames_(0),
+      skip_start_(0),
+      skip_end_(0) {}
+
+TimingDecoder::~TimingDecoder() {}
+
+shaka::media::MediaCapabilitiesInfo TimingDecoder::DecodingInfo(
+    const shaka::media::MediaDecodingConfiguration& config) const {
+  return inner_->DecodingInfo(config);
+}
+
+void TimingDecoder::SetSkipWindow(double start, double end) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  skip_start_ = start;
+  skip_end_ = end;
+}
+
+void TimingDecoder::ClearSkipWindow() {
+  SetSkipWindow(0, 0);
+}
+
+void TimingDecoder::ResetDecoder() {
+  inner_->ResetDecoder();
+}
+
+shaka::media::MediaStatus TimingDecoder::Decode(
+    std::shared_ptr<shaka::media::EncodedFrame> input,
+    const shaka::eme::Implementation* eme,
+    std::vector<std::shared_ptr<shaka::media::DecodedFrame>>* frames,
+    std::string* extra_info) {
+  // Returning no frames is what a decoder does while it buffers input.
+  if (input && ShouldSkip(*input)) {
+    skipped_frames_.fetch_add(1, std::memory_order_relaxed);
+    return shaka::media::MediaStatus::Success;
+  }
+  ScopedStageTimer timer(Stage::kDecode);
+  decode_calls_.fetch_add(1, std::memory_order_relaxed);
+  return inner_->Decode(std::move(input), eme, frames, extra_info);
+}
+
+bool TimingDecoder::ShouldSkip(const shaka::media::EncodedFrame& frame) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (frame.pts < skip_start_ || frame.pts >= skip_end_)
+      return false;
+  }
+  // Encrypted slices can't be inspected, and keyframes are never skipped.
+  if (frame.is_key_frame || frame.encryption_info || !frame.stream_info)
+    return false;
+  const shaka::media::StreamInfo& info = *frame.stream_info;
+  if (info.codec.compare(0, 4, "avc1") != 0 &&
+      info.codec.compare(0, 4, "avc3") != 0 &&
+      info.codec.compare(0, 4, "h264") != 0) {
+    return false;
+  }
+  return IsDisposableH264Frame(
+      frame.data, frame.data_size,
+      AvcLengthSize(info.extra_data.data(), info.extra_data.size()));
+}
+
+}  // namespace sample
@@ -0,0 +1,71 @@
+#ifndef SAMPLE_PLAYER_TIMING_DECODER_H_
+#define SAMPLE_PLAYER_TIMING_DECODER_H_
+
+#include <shaka/media/decoder.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sample {
+
+/**
+ * A Decoder that records each Decode() call in the decode stage and counts
+ * the calls.  During a seek it can also skip frames the target does not
+ * depend on; see SetSkipWindow().
+ */
+class TimingDecoder final : public shaka::media::Decoder {
+ public:
+  explicit TimingDecoder(std::unique_ptr<shaka::media::Decoder> inner);
+  ~TimingDecoder() override;
+
+  TimingDecoder(const TimingDecoder&) = delete;
+  TimingDecoder& operator=(const TimingDecoder&) = delete;
+
+  shaka::media::MediaCapabilitiesInfo DecodingInfo(
+      const shaka::media::MediaDecodingConfiguration& config) const override;
+  void ResetDecoder() override;
+  shaka::media::MediaStatus Decode(
+      std::shared_ptr<shaka::media::EncodedFrame> input,
+      const shaka::eme::Implementation* eme,
+      std::vector<std::shared_ptr<shaka::media::DecodedFrame>>* frames,
+      std::string* extra_info) override;
+
+  /**
+   * Until ClearSkipWindow(), drops H.264 frames with times in [start, end)
+   * that no other frame references instead of decoding them.  A seek to
+   * |end| from the keyframe at |start| then decodes only the frames the
+   * target depends on.  Frames of other codecs are always decoded.
+   */
+  void SetSkipWindow(double start, double end);
+  void ClearSkipWindow();
+
+  /** The number of encoded frames decoded so far; skipped ones don't count. */
+  uint64_t decode_calls() const {
+    return decode_calls_.load(std::memory_order_relaxed);
+  }
+  /** The number of frames SetSkipWindow() has dropped so far. */
+  uint64_t skipped_frames() const {
+    return skipped_frames_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool ShouldSkip(const shaka::media::EncodedFrame& frame);
+
+  const std::unique_ptr<shaka::media::Decoder> inner_;
+  std::atomic<uint64_t> decode_calls_;
+  std::atomic<uint64_t> skipped_frames_;
+
+  std::mutex mutex_;
+  // The window set by SetSkipWindow(); empty when |skip_end_| is not above
+  // |skip_start_|.
+  double skip_start_;
+  double skip_end_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_TIMING_DECODER_H_
@@ -0,0 +1,70 @@
+#include "player/timing_demuxer.h"
+
+#include <utility>
+#include <vector>
+
+#include "base/stage_timings.h"
+
+namespace sample {
+
+namespace {
+
+class TimingDemuxer final : public shaka::media::Demuxer {
+ public:
+  explicit TimingDemuxer(std::unique_ptr<shaka::media::Demuxer> inner)
+      : inner_(std::move(inner)) {}
+
+  bool Demux(double timestamp_offset, const uint8_t* data, size_t size,
+             std::vector<std::shared_ptr<shaka::media::EncodedFrame>>* frames)
+      override {
+    ScopedStageTimer timer(Stage::kDemux);
+    return inner_->Demux(timestamp_offset, data, size, frames);
+  }
+
+  void Reset() override {
+    inner_->Reset();
+  }
+
+ private:
+  const std::unique_ptr<shaka::media::Demuxer> inner_;
+};
+
+}  // namespace
+
+TimingDemuxerFactory::TimingDemuxerFactory(
+    const shaka::media::DemuxerFactory* inner)
+    : inner_(inner), installed_(false) {}
+
+TimingDemuxerFactory::~TimingDemuxerFactory() {
+  if (installed_)
+    shaka::media::DemuxerFactory::SetFactory(inner_);
+}
+
+std::unique_ptr<TimingDemuxerFactory> TimingDemuxerFactory::Install() {
+  std::unique_ptr<TimingDemuxerFactory> ret(
+      new TimingDemuxerFactory(shaka::media::DemuxerFactory::GetFactory()));
+  shaka::media::DemuxerFactory::SetFactory(ret.get());
+  ret->installed_ = true;
+  return ret;
+}
+
+bool TimingDemuxerFactory::IsTypeSupported(const std::string& mime_type) const {
+  return inner_->IsTypeSupported(mime_type);
+}
+
+bool TimingDemuxerFactory::IsCodecVideo(const std::string& codec) const {
+  return inner_->IsCodecVideo(codec);
+}
+
+std::unique_ptr<shaka::media::Demuxer> TimingDemuxerFactory::Create(
+    const std::string& mime_type,
+    shaka::media::Demuxer::Client* client) const {
+  std::unique_ptr<shaka::media::Demuxer> inner =
+      inner_->Create(mime_type, client);
+  if (!inner)
+    return nullptr;
+  return std::unique_ptr<shaka::media::Demuxer>(
+      new TimingDemuxer(std::move(inner)));
+}
+
+}  // namespace sample
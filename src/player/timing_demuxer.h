@@ -0,0 +1,43 @@
+#ifndef SAMPLE_PLAYER_TIMING_DEMUXER_H_
+#define SAMPLE_PLAYER_TIMING_DEMUXER_H_
+
+#include <shaka/media/demuxer.h>
+
+#include <memory>
+#include <string>
+
+namespace sample {
+
+/**
+ * A DemuxerFactory whose demuxers record each Demux() call in the demux
+ * stage.  Demuxers are created process-wide, so Install() wraps the current
+ * factory for every player.
+ */
+class TimingDemuxerFactory final : public shaka::media::DemuxerFactory {
+ public:
+  explicit TimingDemuxerFactory(const shaka::media::DemuxerFactory* inner);
+  ~TimingDemuxerFactory() override;
+
+  TimingDemuxerFactory(const TimingDemuxerFactory&) = delete;
+  TimingDemuxerFactory& operator=(const TimingDemuxerFactory&) = delete;
+
+  /**
+   * Wraps the current global factory.  The result must outlive every player
+   * and is uninstalled when destroyed.
+   */
+  static std::unique_ptr<TimingDemuxerFactory> Install();
+
+  bool IsTypeSupported(const std::string& mime_type) const override;
+  bool IsCodecVideo(const std::string& codec) const override;
+  std::unique_ptr<shaka::media::Demuxer> Create(
+      const std::string& mime_type,
+      shaka::media::Demuxer::Client* client) const override;
+
+ private:
+  const shaka::media::DemuxerFactory* const inner_;
+  bool installed_;
+};
+
+}  // namespace sample
+
+#endif  // SAMPLE_PLAYER_TIMING_DEMUXER_H_
@@ -0,0 +1,140 @@
+#include "media/abr_simulation.h"
+
+#include <string>
+#include <vector>
+
+#include "media/manifest.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+std::vector<Variant> Ladder(const std::vector<uint64_t>& bandwidths) {
+  std::vector<Variant> ret;
+  for (uint64_t bandwidth : bandwidths) {
+    Variant variant;
+    variant.bandwidth = bandwidth;
+    ret.push_back(variant);
+  }
+  return ret;
+}
+
+BandwidthTrace ConstantTrace(double bits_per_second) {
+  BandwidthTrace trace;
+  trace.name = "constant";
+  BandwidthTrace::Step step;
+  step.seconds = 10;
+  step.bits_per_second = bits_per_second;
+  trace.steps.push_back(step);
+  return trace;
+}
+
+TEST(ChooseVariantPicksTheHighestThatFits) {
+  // Unsorted, as a manifest may list them; results index this vector.
+  const std::vector<Variant> variants = Ladder({2000000, 500000, 1000000});
+  EXPECT_EQ(Variant::kNone, ChooseVariant({}, 1e6));
+  EXPECT_EQ(1u, ChooseVariant(variants, 100000));
+  EXPECT_EQ(1u, ChooseVariant(variants, 1000000));
+  // 1 Mbit/s needs 1e6 / 0.95 and allows up to 2e6 / 0.85.
+  EXPECT_EQ(1u, ChooseVariant(variants, 1050000));
+  EXPECT_EQ(2u, ChooseVariant(variants, 1060000));
+  EXPECT_EQ(2u, ChooseVariant(variants, 2100000));
+  // Where the ranges overlap the higher variant wins.
+  EXPECT_EQ(0u, ChooseVariant(variants, 2110000));
+  EXPECT_EQ(0u, ChooseVariant(variants, 1e9));
+  // Looser targets upgrade sooner.
+  EXPECT_EQ(0u, ChooseVariant(variants, 2050000, 1, 1));
+}
+
+TEST(ParseBandwidthTraceReadsSteps) {
+  BandwidthTrace trace;
+  std::string error;
+  ASSERT_TRUE(ParseBandwidthTrace(
+      "lte", "# seconds kbit/s\n2 1500\n\n0.5 0  # outage\r\n1 800\n",
+      &trace, &error));
+  EXPECT_EQ(std::string("lte"), trace.name);
+  ASSERT_TRUE(trace.steps.size() == 3);
+  EXPECT_EQ(2.0, trace.steps[0].seconds);
+  EXPECT_EQ(1500000.0, trace.steps[0].bits_per_second);
+  EXPECT_EQ(0.0, trace.steps[1].bits_per_second);
+  EXPECT_EQ(800000.0, trace.steps[2].bits_per_second);
+}
+
+TEST(ParseBandwidthTraceRejectsBadTraces) {
+  BandwidthTrace trace;
+  std::string error;
+  EXPECT_FALSE(ParseBandwidthTrace("bad", "1 100\n2\n", &trace, &error));
+  EXPECT_EQ(std::string("bad:2: expected '<seconds> <kbit/s>'"), error);
+  EXPECT_FALSE(ParseBandwidthTrace("bad", "1 100 x\n", &trace, &error));
+  EXPECT_FALSE(ParseBandwidthTrace("bad", "0 100\n", &trace, &error));
+  EXPECT_FALSE(ParseBandwidthTrace("bad", "1 -5\n", &trace, &error));
+  EXPECT_FALSE(ParseBandwidthTrace("empty", "1 0\n# none\n", &trace, &error));
+  EXPECT_EQ(std::string("empty: trace carries no bandwidth"), error);
+}
+
+TEST(SyntheticBandwidthTraceDependsOnlyOnTheSeed) {
+  const BandwidthTrace a = SyntheticBandwidthTrace(7, 60, 3e6);
+  const BandwidthTrace b = SyntheticBandwidthTrace(7, 60, 3e6);
+  const BandwidthTrace c = SyntheticBandwidthTrace(8, 60, 3e6);
+  ASSERT_TRUE(a.steps.size() == 60);
+  bool differs = false;
+  for (size_t i = 0; i < a.steps.size(); i++) {
+    EXPECT_EQ(a.steps[i].bits_per_second, b.steps[i].bits_per_second);
+    EXPECT_TRUE(a.steps[i].bits_per_second > 0);
+    differs |= a.steps[i].bits_per_second != c.steps[i].bits_per_second;
+  }
+  EXPECT_TRUE(differs);
+}
+
+TEST(SimulateSessionTimesTransfers) {
+  SimulatedContent content;
+  content.variants = Ladder({1000000});
+  content.segment_seconds = 4;
+  content.duration = 8;
+  AbrConfig config;
+  config.rtt_ms = 50;
+
+  const SimulationResult result =
+      SimulateSession(content, ConstantTrace(8000000), config);
+  // Each 4 Mbit segment takes the RTT plus half a second.
+  EXPECT_NEAR(0.55, result.startup_seconds, 1e-9);
+  EXPECT_EQ(0u, result.stalls);
+  EXPECT_EQ(0u, result.switches);
+  EXPECT_NEAR(1000000, result.average_bitrate, 1e-6);
+  EXPECT_NEAR(1.1 + 7.45, result.session_seconds, 1e-9);
+}
+
+TEST(SimulateSessionUpgradesOnAFastLink) {
+  SimulatedContent content;
+  content.variants = Ladder({500000, 1000000, 4000000});
+  content.duration = 120;
+  const SimulationResult result =
+      SimulateSession(content, ConstantTrace(50000000), AbrConfig());
+  EXPECT_EQ(0u, result.stalls);
+  EXPECT_TRUE(result.switches >= 1);
+  EXPECT_TRUE(result.average_bitrate > 3000000);
+}
+
+TEST(SimulateSessionStallsWhenTheLinkIsTooSlow) {
+  SimulatedContent content;
+  content.variants = Ladder({1000000});
+  content.duration = 40;
+  const SimulationResult result =
+      SimulateSession(content, ConstantTrace(500000), AbrConfig());
+  EXPECT_TRUE(result.stalls > 0);
+  EXPECT_TRUE(result.stall_seconds > 0);
+  // Ten segments of 8 s each, plus the round trips.
+  EXPECT_TRUE(result.session_seconds > 80);
+}
+
+TEST(SimulateSessionIgnoresEmptyInput) {
+  const SimulationResult result =
+      SimulateSession(SimulatedContent(), ConstantTrace(1e6), AbrConfig());
+  EXPECT_EQ(std::string("constant"), result.trace);
+  EXPECT_EQ(0.0, result.session_seconds);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,140 @@
+#include "net/caching_proxy.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "canned_server.h"
+#include "net/http_client.h"
+#include "net/http_server.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+bool Equal(const std::vector<std::string>& expected,
+           const std::vector<std::string>& actual) {
+  return expected == actual;
+}
+
+TEST(NextSegmentPathsKeepsZeroPadding) {
+  EXPECT_TRUE(Equal({"v/chunk-1-00010.m4s", "v/chunk-1-00011.m4s"},
+                    NextSegmentPaths("v/chunk-1-00009.m4s", 2)));
+  // The ".m4s" extension is not a number, and a wider number grows.
+  EXPECT_TRUE(Equal({"/a/seg9.m4s", "/a/seg10.m4s"},
+                    NextSegmentPaths("/a/seg8.m4s", 2)));
+  EXPECT_TRUE(Equal({"/a/99"}, NextSegmentPaths("/a/98", 1)));
+  EXPECT_TRUE(Equal({"/hls/3.ts"}, NextSegmentPaths("/hls/2.ts", 1)));
+}
+
+TEST(NextSegmentPathsSkipsUnnumberedNames) {
+  EXPECT_TRUE(NextSegmentPaths("/v/init-1.mp4", 2).empty());
+  EXPECT_TRUE(NextSegmentPaths("/v/video_init.m4s", 2).empty());
+  EXPECT_TRUE(NextSegmentPaths("/v/segment.m4s", 2).empty());
+  EXPECT_TRUE(NextSegmentPaths("/v2/video.mp4", 2).empty());
+  EXPECT_TRUE(NextSegmentPaths("/live/stream2.m3u8", 2).empty());
+  EXPECT_TRUE(NextSegmentPaths("/v/seg-1.m4s", 0).empty());
+  EXPECT_EQ(std::string("/v/seg-*.m4s"), SegmentPathPattern("/v/seg-41.m4s"));
+  EXPECT_EQ(std::string(""), SegmentPathPattern("/v/init.mp4"));
+}
+
+TEST(DecodeChunkedBodyJoinsChunks) {
+  std::string body;
+  EXPECT_TRUE(DecodeChunkedBody("5\r\nhello\r\n1;ext=1\r\n \r\n"
+                                "A\r\n0123456789\r\n0\r\nX-Trailer: 1\r\n\r\n",
+                                &body));
+  EXPECT_EQ(std::string("hello 0123456789"), body);
+  EXPECT_FALSE(DecodeChunkedBody("5\r\nhel", &body));
+  EXPECT_FALSE(DecodeChunkedBody("5\r\nhelloXX0\r\n\r\n", &body));
+  EXPECT_FALSE(DecodeChunkedBody("zz\r\n", &body));
+}
+
+TEST(HttpGetDecodesChunkedResponses) {
+  test::CannedServer origin(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: video/mp4\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "4\r\nmoof\r\n4\r\nmdat\r\n0\r\n\r\n");
+  HttpResult result;
+  std::string error;
+  ASSERT_TRUE(HttpGet(origin.BaseUrl() + "/seg-1.m4s", "", &result, &error));
+  EXPECT_EQ(200, result.status);
+  EXPECT_EQ(std::string("moofmdat"), *result.body);
+  EXPECT_EQ(0u, result.headers.count("transfer-encoding"));
+
+  test::CannedServer truncated(
+      "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n8\r\nmoof");
+  EXPECT_FALSE(HttpGet(truncated.BaseUrl() + "/", "", &result, &error));
+}
+
+/** Serves segments named by time, so numbered guesses always miss. */
+class TimeNamedOrigin : public HttpHandler {
+ public:
+  void Handle(const HttpRequest& request, HttpResponse* response) override {
+    requests_++;
+    const std::string name = request.path.substr(request.path.rfind('/') + 1);
+    const long time = std::atol(name.c_str() + 4);
+    if (time % 4000 == 0)
+      response->SetBody("segment");
+    else
+      response->status = 404;
+  }
+
+  int requests() const {
+    return requests_.load();
+  }
+
+ private:
+  std::atomic<int> requests_{0};
+};
+
+/** Waits until |origin| has seen |count| requests and then stays idle. */
+bool WaitForRequests(const TimeNamedOrigin& origin, int count) {
+  for (int i = 0; i < 200 && origin.requests() < count; i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  return origin.requests() == count;
+}
+
+HttpResponse Get(CachingProxy* proxy, const std::string& path) {
+  HttpRequest request;
+  request.method = "GET";
+  request.path = path;
+  HttpResponse response;
+  proxy->Handle(request, &response);
+  return response;
+}
+
+TEST(CachingProxyStopsGuessingNamesThatNeverMatch) {
+  TimeNamedOrigin origin;
+  HttpServer server(&origin);
+  std::string error;
+  ASSERT_TRUE(server.Start(0, &error));
+  CachingProxyOptions options;
+  options.upstream = server.BaseUrl();
+  options.prefetch_count = 2;
+  CachingProxy proxy(options);
+
+  // Each request and its two wrong guesses, until three guesses have missed.
+  EXPECT_EQ(200, Get(&proxy, "/v/seg-0.m4s").status);
+  EXPECT_TRUE(WaitForRequests(origin, 3));
+  EXPECT_EQ(200, Get(&proxy, "/v/seg-4000.m4s").status);
+  EXPECT_TRUE(WaitForRequests(origin, 6));
+  EXPECT_EQ(200, Get(&proxy, "/v/seg-8000.m4s").status);
+  EXPECT_TRUE(WaitForRequests(origin, 7));
+
+  // Missing segments are not guessed from at all.
+  EXPECT_EQ(404, Get(&proxy, "/a/seg-1.m4s").status);
+  EXPECT_TRUE(WaitForRequests(origin, 8));
+  EXPECT_EQ(0u, proxy.cache_stats().prefetched);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,84 @@
+#ifndef SAMPLE_TESTS_CANNED_SERVER_H_
+#define SAMPLE_TESTS_CANNED_SERVER_H_
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace sample {
+namespace test {
+
+/**
+ * A loopback server that answers every connection with the same raw bytes,
+ * for responses HttpServer does not produce, such as chunked bodies.
+ */
+class CannedServer {
+ public:
+  explicit CannedServer(std::string response)
+      : response_(std::move(response)), requests_(0) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    listen(fd_, 8);
+    getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+    thread_ = std::thread(&CannedServer::Serve, this);
+  }
+
+  ~CannedServer() {
+    shutdown(fd_, SHUT_RDWR);
+    close(fd_);
+    thread_.join();
+  }
+
+  CannedServer(const CannedServer&) = delete;
+  CannedServer& operator=(const CannedServer&) = delete;
+
+  std::string BaseUrl() const {
+    return "http://127.0.0.1:" + std::to_string(port_);
+  }
+  int requests() const {
+    return requests_.load();
+  }
+
+ private:
+  void Serve() {
+    while (true) {
+      const int client = accept(fd_, nullptr, nullptr);
+      if (client < 0)
+        return;
+      std::string request;
+      char buffer[4096];
+      ssize_t count;
+      while (request.find("\r\n\r\n") == std::string::npos &&
+             (count = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        request.append(buffer, count);
+      }
+      requests_++;
+      send(client, response_.data(), response_.size(), 0);
+      close(client);
+    }
+  }
+
+  const std::string response_;
+  std::atomic<int> requests_;
+  int fd_;
+  uint16_t port_;
+  std::thread thread_;
+};
+
+}  // namespace test
+}  // namespace sample
+
+#endif  // SAMPLE_TESTS_CANNED_SERVER_H_
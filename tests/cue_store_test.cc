@@ -0,0 +1,157 @@
+#include "media/cue_store.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "media/webvtt_parser.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+Cue MakeCue(double start, double end, const std::string& payload) {
+  Cue cue;
+  cue.start = start;
+  cue.end = end;
+  cue.payload = payload;
+  return cue;
+}
+
+std::vector<std::string> PayloadsAt(const CueStore& store, double time) {
+  std::vector<const Cue*> active;
+  store.ActiveAt(time, &active);
+  std::vector<std::string> ret;
+  for (const Cue* cue : active)
+    ret.push_back(cue->payload);
+  return ret;
+}
+
+bool Equal(const std::vector<std::string>& expected,
+           const std::vector<std::string>& actual) {
+  return expected == actual;
+}
+
+TEST(CueStoreSkipsCuesRepeatedAcrossSegments) {
+  CueStore store;
+  EXPECT_EQ(2u, store.AddSegment({MakeCue(0, 2, "a"), MakeCue(3, 5, "b")}));
+  // "b" spans the boundary at 4 s and is repeated in the next segment.
+  EXPECT_EQ(1u, store.AddSegment({MakeCue(3, 5, "b"), MakeCue(6, 7, "c")}));
+  // Same times, different text: a different cue.
+  EXPECT_EQ(1u, store.AddSegment({MakeCue(3, 5, "b2")}));
+  // Empty cues are dropped, as are duplicates within a segment.
+  EXPECT_EQ(1u, store.AddSegment({MakeCue(8, 8, "empty"), MakeCue(9, 10, "d"),
+                                  MakeCue(9, 10, "d")}));
+  EXPECT_EQ(5u, store.size());
+  EXPECT_TRUE(Equal({"b", "b2"}, PayloadsAt(store, 4)));
+}
+
+TEST(CueStoreMergesSegmentsAddedOutOfOrder) {
+  CueStore store;
+  store.AddSegment({MakeCue(8, 12, "late")});
+  store.AddSegment({MakeCue(0, 100, "long"), MakeCue(4, 9, "early")});
+
+  EXPECT_TRUE(Equal({"long"}, PayloadsAt(store, 1)));
+  EXPECT_TRUE(Equal({"long", "early", "late"}, PayloadsAt(store, 8.5)));
+  EXPECT_TRUE(Equal({"long", "late"}, PayloadsAt(store, 9)));
+  EXPECT_TRUE(Equal({"long"}, PayloadsAt(store, 12)));
+  EXPECT_TRUE(PayloadsAt(store, 100).empty());
+}
+
+TEST(CueStoreRemovesCuesEndedBefore) {
+  CueStore store;
+  store.AddSegment({MakeCue(0, 2, "a"), MakeCue(1, 30, "long"),
+                    MakeCue(3, 5, "b"), MakeCue(6, 7, "c")});
+  EXPECT_EQ(2u, store.RemoveBefore(5));
+  EXPECT_EQ(2u, store.size());
+  EXPECT_TRUE(Equal({"long"}, PayloadsAt(store, 4)));
+  EXPECT_TRUE(Equal({"long", "c"}, PayloadsAt(store, 6.5)));
+  // A removed cue can be added again.
+  EXPECT_EQ(1u, store.AddSegment({MakeCue(3, 5, "b")}));
+  EXPECT_EQ(0u, store.RemoveBefore(0));
+}
+
+TEST(CueStoreMatchesAScan) {
+  std::mt19937 random(3);
+  std::uniform_real_distribution<double> length(0.1, 8);
+  std::vector<Cue> all;
+  CueStore store;
+  for (int segment = 0; segment < 40; segment++) {
+    // Every fifth segment arrives late, out of order.
+    const double segment_start = segment % 5 == 4 ? segment * 2.0 - 30
+                                                    : segment * 2.0;
+    std::vector<Cue> cues;
+    for (int i = 0; i < 4; i++) {
+      const double start = segment_start + i * 0.5;
+      cues.push_back(MakeCue(start, start + length(random),
+                             std::to_string(segment) + "/" +
+                                 std::to_string(i)));
+    }
+    all.insert(all.end(), cues.begin(), cues.end());
+    store.AddSegment(cues);
+  }
+  EXPECT_EQ(all.size(), store.size());
+
+  for (double time = -31; time < 90; time += 0.37) {
+    size_t expected = 0;
+    for (const Cue& cue : all) {
+      if (cue.start <= time && time < cue.end)
+        expected++;
+    }
+    std::vector<const Cue*> active;
+    store.ActiveAt(time, &active);
+    EXPECT_EQ(expected, active.size());
+    for (size_t i = 0; i < active.size(); i++) {
+      EXPECT_TRUE(active[i]->start <= time && time < active[i]->end);
+      if (i > 0)
+        EXPECT_TRUE(active[i - 1]->start <= active[i]->start);
+    }
+  }
+}
+
+TEST(ParseWebVttReadsCues) {
+  const std::string body =
+      "\xEF\xBB\xBFWEBVTT - captions\r\n"
+      "X-TIMESTAMP-MAP=MPEGTS:900000,LOCAL:00:00:00.000\r\n"
+      "\r\n"
+      "NOTE a comment\r\n"
+      "\r\n"
+      "intro\r\n"
+      "00:01.000 --> 00:04.500 align:start\r\n"
+      "Hello <b>there</b>\r\n"
+      "second line\r\n"
+      "\r\n"
+      "01:00:00.250 --> 01:00:01.000\r\n"
+      "Later\r\n";
+  std::vector<Cue> cues;
+  std::string error;
+  ASSERT_TRUE(ParseWebVtt(body, 10, &cues, &error));
+  ASSERT_TRUE(cues.size() == 2);
+  EXPECT_EQ(std::string("intro"), cues[0].id);
+  EXPECT_NEAR(11, cues[0].start, 1e-9);
+  EXPECT_NEAR(14.5, cues[0].end, 1e-9);
+  EXPECT_EQ(std::string("Hello <b>there</b>\nsecond line"), cues[0].payload);
+  EXPECT_TRUE(cues[1].id.empty());
+  EXPECT_NEAR(3610.25, cues[1].start, 1e-9);
+  EXPECT_EQ(std::string("Later"), cues[1].payload);
+}
+
+TEST(ParseWebVttRejectsMalformedInput) {
+  std::vector<Cue> cues;
+  std::string error;
+  EXPECT_FALSE(ParseWebVtt("", 0, &cues, &error));
+  EXPECT_FALSE(ParseWebVtt("WEBVTTX\n", 0, &cues, &error));
+  EXPECT_FALSE(
+      ParseWebVtt("WEBVTT\n\n00:01.00 --> 00:02.000\nx\n", 0, &cues, &error));
+  EXPECT_EQ(std::string("WebVTT: bad cue timing: 00:01.00 --> 00:02.000"),
+            error);
+  EXPECT_FALSE(
+      ParseWebVtt("WEBVTT\n\n00:01.000 - 00:02.000\nx\n", 0, &cues, &error));
+  EXPECT_TRUE(cues.empty());
+  EXPECT_TRUE(ParseWebVtt("WEBVTT\n", 0, &cues, &error));
+}
+
+}  // namespace
+
+}  // namespace sample
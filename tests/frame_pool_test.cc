@@ -0,0 +1,138 @@
+#include "media/frame_pool.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+/** A decoded 4:2:0 frame: a 64x4 luma plane and two 32x2 chroma planes. */
+struct DecodedFrame {
+  DecodedFrame() : bytes(64 * 4 + 2 * 32 * 2) {
+    for (size_t i = 0; i < bytes.size(); i++)
+      bytes[i] = static_cast<uint8_t>(i);
+    planes.count = 3;
+    planes.data[0] = bytes.data();
+    planes.linesize[0] = 64;
+    planes.rows[0] = 4;
+    for (size_t i = 1; i < 3; i++) {
+      planes.data[i] = bytes.data() + 64 * 4 + (i - 1) * 32 * 2;
+      planes.linesize[i] = 32;
+      planes.rows[i] = 2;
+    }
+  }
+
+  std::vector<uint8_t> bytes;
+  FramePlanes planes;
+};
+
+TEST(FramePoolZeroCopyKeepsTheSourceAlive) {
+  FramePool pool(FrameHandoff::kZeroCopy, 2);
+  std::shared_ptr<DecodedFrame> decoded = std::make_shared<DecodedFrame>();
+  const FramePlanes planes = decoded->planes;
+  std::weak_ptr<DecodedFrame> weak = decoded;
+
+  FrameRef ref = pool.Wrap(planes, 1.5, std::move(decoded));
+  ASSERT_TRUE(static_cast<bool>(ref));
+  EXPECT_NEAR(1.5, ref->pts(), 1e-9);
+  EXPECT_TRUE(ref->planes().data[0] == planes.data[0]);
+  EXPECT_TRUE(ref->planes().data[2] == planes.data[2]);
+
+  FrameRef copy = ref;
+  ref.Reset();
+  EXPECT_FALSE(weak.expired());
+  copy.Reset();
+  EXPECT_TRUE(weak.expired());
+
+  const FramePoolStats stats = pool.stats();
+  EXPECT_EQ(1u, stats.frames);
+  EXPECT_EQ(0u, stats.bytes_copied);
+}
+
+TEST(FramePoolCopiesEveryPlaneAndReusesStorage) {
+  FramePool pool(FrameHandoff::kCopy, 1);
+  std::shared_ptr<DecodedFrame> decoded = std::make_shared<DecodedFrame>();
+  const FramePlanes planes = decoded->planes;
+  std::weak_ptr<DecodedFrame> weak = decoded;
+
+  FrameRef ref = pool.Wrap(planes, 0, std::move(decoded));
+  ASSERT_TRUE(static_cast<bool>(ref));
+  // The copy does not hold on to the decoder's frame.
+  EXPECT_TRUE(weak.expired());
+  const uint8_t* storage = ref->planes().data[0];
+  EXPECT_TRUE(storage != planes.data[0]);
+  EXPECT_EQ(64u * 4, static_cast<size_t>(ref->planes().data[1] - storage));
+  EXPECT_EQ(64u * 4 + 32 * 2,
+            static_cast<size_t>(ref->planes().data[2] - storage));
+  EXPECT_EQ(384u, pool.stats().bytes_copied);
+
+  // The copy outlives the decoder's frame.
+  DecodedFrame expected;
+  EXPECT_EQ(0, std::memcmp(expected.bytes.data(), storage,
+                           expected.bytes.size()));
+  ref.Reset();
+
+  DecodedFrame next;
+  ref = pool.Wrap(next.planes, 1, nullptr);
+  ASSERT_TRUE(static_cast<bool>(ref));
+  EXPECT_TRUE(ref->planes().data[0] == storage);
+  EXPECT_EQ(768u, pool.stats().bytes_copied);
+}
+
+TEST(FramePoolCountsWrapsWhileExhausted) {
+  FramePool pool(FrameHandoff::kZeroCopy, 2);
+  DecodedFrame decoded;
+  FrameRef first = pool.Wrap(decoded.planes, 0, nullptr);
+  FrameRef second = pool.Wrap(decoded.planes, 1, nullptr);
+  ASSERT_TRUE(first && second);
+  EXPECT_FALSE(pool.Wrap(decoded.planes, 2, nullptr));
+  EXPECT_FALSE(pool.Wrap(decoded.planes, 3, nullptr));
+
+  first.Reset();
+  FrameRef third = pool.Wrap(decoded.planes, 4, nullptr);
+  EXPECT_TRUE(static_cast<bool>(third));
+
+  const FramePoolStats stats = pool.stats();
+  EXPECT_EQ(5u, stats.frames);
+  EXPECT_EQ(2u, stats.exhausted);
+}
+
+TEST(FramePoolReturnsBuffersOnTheLastRelease) {
+  FramePool pool(FrameHandoff::kCopy, 1);
+  DecodedFrame decoded;
+  FrameRef original = pool.Wrap(decoded.planes, 0, nullptr);
+  ASSERT_TRUE(static_cast<bool>(original));
+
+  FrameRef copied(original);
+  FrameRef moved(std::move(copied));
+  EXPECT_FALSE(copied);
+  FrameRef assigned;
+  assigned = moved;
+
+  original.Reset();
+  moved.Reset();
+  EXPECT_FALSE(pool.Wrap(decoded.planes, 1, nullptr));
+  assigned = FrameRef();
+  EXPECT_TRUE(static_cast<bool>(pool.Wrap(decoded.planes, 2, nullptr)));
+  EXPECT_EQ(1u, pool.stats().exhausted);
+}
+
+TEST(FramePoolParsesHandoffNames) {
+  FrameHandoff handoff = FrameHandoff::kCopy;
+  EXPECT_TRUE(ParseFrameHandoff("zero-copy", &handoff));
+  EXPECT_TRUE(handoff == FrameHandoff::kZeroCopy);
+  EXPECT_EQ(std::string("zero-copy"), FrameHandoffName(handoff));
+  EXPECT_TRUE(ParseFrameHandoff("copy", &handoff));
+  EXPECT_TRUE(handoff == FrameHandoff::kCopy);
+  EXPECT_FALSE(ParseFrameHandoff("zerocopy", &handoff));
+}
+
+}  // namespace
+
+}  // namespace sample
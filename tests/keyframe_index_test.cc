@@ -0,0 +1,189 @@
+#include "media/keyframe_index.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "media/h264_frames.h"
+#include "media/manifest.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+void PutUint32(uint32_t value, std::string* out) {
+  for (int shift = 24; shift >= 0; shift -= 8)
+    out->push_back(static_cast<char>((value >> shift) & 0xff));
+}
+
+struct TestReference {
+  uint32_t size;
+  uint32_t duration;
+  bool starts_with_sap;
+  uint32_t sap_delta;
+};
+
+/** Returns a version 0 sidx box with a timescale of 1000. */
+std::string MakeSidx(uint32_t earliest_time, uint32_t first_offset,
+                     const std::vector<TestReference>& references) {
+  std::string body;
+  PutUint32(0, &body);  // version and flags
+  PutUint32(1, &body);  // reference_ID
+  PutUint32(1000, &body);
+  PutUint32(earliest_time, &body);
+  PutUint32(first_offset, &body);
+  PutUint32(static_cast<uint32_t>(references.size()), &body);
+  for (auto& reference : references) {
+    PutUint32(reference.size, &body);
+    PutUint32(reference.duration, &body);
+    // SAP type 1.
+    PutUint32((reference.starts_with_sap ? 0x90000000u : 0) |
+                  reference.sap_delta,
+              &body);
+  }
+  std::string box;
+  PutUint32(static_cast<uint32_t>(body.size() + 8), &box);
+  box += "sidx" + body;
+  return box;
+}
+
+bool Parse(const std::string& data, uint64_t data_offset,
+           std::vector<SidxReference>* references, std::string* error) {
+  return ParseSidx(reinterpret_cast<const uint8_t*>(data.data()), data.size(),
+                   data_offset, references, error);
+}
+
+TEST(ParseSidxReadsReferences) {
+  // A free box before the sidx is skipped.
+  std::string data;
+  PutUint32(12, &data);
+  data += "free0000";
+  const std::string sidx = MakeSidx(
+      2000, 10, {{100, 4000, true, 0}, {200, 4000, true, 500}});
+  data += sidx;
+
+  std::vector<SidxReference> references;
+  std::string error;
+  ASSERT_TRUE(Parse(data, 1000, &references, &error));
+  ASSERT_TRUE(references.size() == 2);
+  EXPECT_NEAR(2, references[0].start, 1e-9);
+  EXPECT_NEAR(6, references[0].end, 1e-9);
+  // Offsets count from the end of the box, plus first_offset.
+  EXPECT_EQ(1000u + 12 + sidx.size() + 10, references[0].offset);
+  EXPECT_EQ(100u, references[0].size);
+  EXPECT_TRUE(references[0].starts_with_sap);
+  EXPECT_NEAR(6, references[1].start, 1e-9);
+  EXPECT_EQ(references[0].offset + 100, references[1].offset);
+  EXPECT_NEAR(0.5, references[1].sap_delta, 1e-9);
+}
+
+TEST(ParseSidxRejectsTruncatedBoxes) {
+  const std::string sidx = MakeSidx(0, 0, {{100, 4000, true, 0}});
+  std::vector<SidxReference> references;
+  std::string error;
+  EXPECT_FALSE(Parse(sidx.substr(0, sidx.size() - 4), 0, &references,
+                     &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(Parse("", 0, &references, &error));
+}
+
+TEST(KeyframeIndexLooksUpKeyframes) {
+  std::vector<SidxReference> references(4);
+  for (size_t i = 0; i < references.size(); i++) {
+    references[i].start = i * 4.0;
+    references[i].end = i * 4.0 + 4;
+    references[i].starts_with_sap = i != 2;
+  }
+  references[3].sap_delta = 1;
+  const KeyframeIndex index = KeyframeIndex::FromSidx(references);
+
+  // 0, 4 and 13; the third reference has no stream access point.
+  EXPECT_EQ(3u, index.size());
+  EXPECT_EQ(0.0, index.AtOrBefore(3.9));
+  EXPECT_EQ(4.0, index.AtOrBefore(12.9));
+  EXPECT_EQ(13.0, index.AtOrBefore(13));
+  EXPECT_EQ(0.0, index.AtOrBefore(-1));
+  EXPECT_EQ(4.0, index.Nearest(8.5));
+  EXPECT_EQ(13.0, index.Nearest(8.6));
+  // Ties go to the earlier keyframe.
+  EXPECT_EQ(0.0, index.Nearest(2));
+  EXPECT_EQ(13.0, index.Nearest(100));
+}
+
+TEST(KeyframeIndexFromSegmentsSortsAndDeduplicates) {
+  std::vector<SegmentReference> segments(3);
+  segments[0].start = 8;
+  segments[1].start = 0;
+  segments[2].start = 8;
+  const KeyframeIndex index = KeyframeIndex::FromSegments(segments);
+  EXPECT_EQ(2u, index.size());
+  EXPECT_EQ(0.0, index.AtOrBefore(7));
+  EXPECT_EQ(8.0, index.AtOrBefore(9));
+}
+
+TEST(KeyframeIndexSetAppliesThePresentationTimeOffset) {
+  Manifest manifest;
+  Representation representation;
+  representation.id = "video";
+  representation.index.url = "http://origin/video.mp4";
+  representation.index.has_range = true;
+  representation.index.range_start = 500;
+  representation.index.range_end = 599;
+  representation.index_time_offset = 10;
+  manifest.representations.push_back(representation);
+
+  const std::string sidx =
+      MakeSidx(10000, 0, {{100, 4000, true, 0}, {100, 4000, true, 0}});
+  std::string requested_range;
+  KeyframeIndexSet indexes(
+      manifest, [&](const std::string&, const std::string& range,
+                    std::string* body, std::string*) {
+        requested_range = range;
+        *body = sidx;
+        return true;
+      });
+
+  std::string error;
+  const KeyframeIndex* index = indexes.Get(0, &error);
+  ASSERT_TRUE(index != nullptr);
+  EXPECT_EQ(std::string("bytes=500-599"), requested_range);
+  EXPECT_EQ(2u, index->size());
+  EXPECT_EQ(0.0, index->AtOrBefore(1));
+  EXPECT_EQ(4.0, index->AtOrBefore(5));
+
+  const Representation& built = indexes.manifest().representations[0];
+  ASSERT_TRUE(built.segments.size() == 2);
+  EXPECT_NEAR(0, built.segments[0].start, 1e-9);
+  EXPECT_NEAR(8, built.segments[1].end, 1e-9);
+  EXPECT_EQ(500u + sidx.size(), built.segments[0].range_start);
+
+  EXPECT_TRUE(indexes.Get(1, &error) == nullptr);
+}
+
+TEST(H264FramesWithoutReferencedSlicesAreDisposable) {
+  // Length-prefixed: an SEI and a non-reference slice, then a P slice.
+  const uint8_t disposable[] = {0, 0, 0, 2, 0x06, 0x05,
+                                0, 0, 0, 3, 0x01, 0x9a, 0x02};
+  const uint8_t referenced[] = {0, 0, 0, 3, 0x41, 0x9a, 0x02};
+  const uint8_t no_slices[] = {0, 0, 0, 2, 0x06, 0x05};
+  const uint8_t truncated[] = {0, 0, 0, 9, 0x01, 0x9a};
+  EXPECT_TRUE(IsDisposableH264Frame(disposable, sizeof(disposable), 4));
+  EXPECT_FALSE(IsDisposableH264Frame(referenced, sizeof(referenced), 4));
+  EXPECT_FALSE(IsDisposableH264Frame(no_slices, sizeof(no_slices), 4));
+  EXPECT_FALSE(IsDisposableH264Frame(truncated, sizeof(truncated), 4));
+
+  // Annex B, with both start code lengths.
+  const uint8_t annex_b[] = {0, 0, 0, 1, 0x09, 0xf0, 0, 0, 1, 0x01, 0x9a};
+  const uint8_t annex_b_idr[] = {0, 0, 1, 0x65, 0x88};
+  EXPECT_TRUE(IsDisposableH264Frame(annex_b, sizeof(annex_b), 0));
+  EXPECT_FALSE(IsDisposableH264Frame(annex_b_idr, sizeof(annex_b_idr), 0));
+
+  const uint8_t avcc[] = {1, 0x64, 0x00, 0x1f, 0xfd};
+  EXPECT_EQ(2u, AvcLengthSize(avcc, sizeof(avcc)));
+  EXPECT_EQ(0u, AvcLengthSize(annex_b, sizeof(annex_b)));
+}
+
+}  // namespace
+
+}  // namespace sample
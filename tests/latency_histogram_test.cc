@@ -0,0 +1,88 @@
+#include "base/latency_histogram.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+TEST(LatencyHistogramBucketsHoldTheirValues) {
+  std::vector<uint64_t> values;
+  for (uint64_t value = 0; value < 5000; value++)
+    values.push_back(value);
+  for (uint64_t value = 1; value != 0; value <<= 1) {
+    values.push_back(value - 1);
+    values.push_back(value);
+    values.push_back(value + value / 3);
+  }
+  values.push_back(std::numeric_limits<uint64_t>::max());
+
+  for (uint64_t value : values) {
+    const size_t index = LatencyHistogram::BucketIndex(value);
+    EXPECT_TRUE(LatencyHistogram::BucketLowerBound(index) <= value);
+    const uint64_t next = LatencyHistogram::BucketLowerBound(index + 1);
+    // The last bucket's upper bound does not fit in 64 bits.
+    if (next > LatencyHistogram::BucketLowerBound(index))
+      EXPECT_TRUE(value < next);
+  }
+}
+
+TEST(LatencyHistogramBucketsAreExactThenNarrow) {
+  for (uint64_t value = 0; value < 16; value++)
+    EXPECT_EQ(value, LatencyHistogram::BucketIndex(value));
+
+  for (size_t index = 16; index < 16 + 59 * 8; index++) {
+    const uint64_t lower = LatencyHistogram::BucketLowerBound(index);
+    const uint64_t upper = LatencyHistogram::BucketLowerBound(index + 1);
+    EXPECT_TRUE(upper > lower);
+    EXPECT_TRUE((upper - lower) * 8 <= lower);
+    EXPECT_EQ(index, LatencyHistogram::BucketIndex(lower));
+    EXPECT_EQ(index, LatencyHistogram::BucketIndex(upper - 1));
+  }
+}
+
+TEST(LatencyHistogramSnapshotSummarizes) {
+  LatencyHistogram histogram;
+  for (uint64_t ms = 1; ms <= 100; ms++)
+    histogram.Record(ms * 1000000);
+
+  const HistogramSnapshot snapshot = histogram.Snapshot();
+  EXPECT_EQ(100u, snapshot.count);
+  EXPECT_EQ(1000000u, snapshot.min_ns);
+  EXPECT_EQ(100000000u, snapshot.max_ns);
+  uint64_t total = 0;
+  for (auto& bucket : snapshot.buckets) {
+    EXPECT_TRUE(bucket.count > 0);
+    EXPECT_TRUE(bucket.lower_ns < bucket.upper_ns);
+    total += bucket.count;
+  }
+  EXPECT_EQ(100u, total);
+
+  const Summary summary = snapshot.ToSummaryMs();
+  EXPECT_NEAR(50.5, summary.mean, 1e-9);
+  EXPECT_NEAR(1, summary.min, 1e-9);
+  EXPECT_NEAR(100, summary.max, 1e-9);
+  // Percentiles are bucket midpoints, so within a bucket's 12.5%.
+  EXPECT_NEAR(50, summary.p50, 50 * 0.125);
+  EXPECT_NEAR(90, summary.p90, 90 * 0.125);
+  EXPECT_NEAR(99, summary.p99, 99 * 0.125);
+}
+
+TEST(LatencyHistogramResetClears) {
+  LatencyHistogram histogram;
+  histogram.Record(42);
+  histogram.Reset();
+  const HistogramSnapshot snapshot = histogram.Snapshot();
+  EXPECT_EQ(0u, snapshot.count);
+  EXPECT_EQ(0u, snapshot.min_ns);
+  EXPECT_TRUE(snapshot.buckets.empty());
+  EXPECT_EQ(0.0, snapshot.PercentileNs(0.5));
+}
+
+}  // namespace
+
+}  // namespace sample
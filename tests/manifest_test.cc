@@ -0,0 +1,257 @@
+#include "media/manifest.h"
+
+#include <memory>
+#include <string>
+
+#include "media/mini_xml.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+const char kMpdUrl[] = "https://cdn.example/content/manifest.mpd";
+
+/** Wraps an AdaptationSet's contents in a single-Period MPD. */
+std::string Mpd(const std::string& period_attributes,
+                const std::string& adaptation_set) {
+  return "<?xml version=\"1.0\"?>\n"
+         "<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" type=\"static\">\n"
+         "  <Period " + period_attributes + ">\n"
+         "    <AdaptationSet mimeType=\"video/mp4\">\n" + adaptation_set +
+         "    </AdaptationSet>\n"
+         "  </Period>\n"
+         "</MPD>\n";
+}
+
+TEST(DashExpandsNumberTemplatesWithWidth) {
+  const std::string mpd = Mpd(
+      "duration=\"PT7S\"",
+      "      <SegmentTemplate timescale=\"1000\" duration=\"2000\""
+      " startNumber=\"7\" initialization=\"$RepresentationID$/init.mp4\""
+      " media=\"$RepresentationID$/seg_$Number%05d$.m4s\"/>\n"
+      "      <Representation id=\"v1\" bandwidth=\"1000000\"/>\n");
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest(kMpdUrl, mpd, &manifest, &error));
+  ASSERT_TRUE(manifest.representations.size() == 1);
+  const Representation& rep = manifest.representations[0];
+  EXPECT_EQ(std::string("https://cdn.example/content/v1/init.mp4"),
+            rep.init.url);
+  ASSERT_TRUE(rep.segments.size() == 4);
+  EXPECT_EQ(std::string("https://cdn.example/content/v1/seg_00007.m4s"),
+            rep.segments[0].url);
+  EXPECT_EQ(std::string("https://cdn.example/content/v1/seg_00010.m4s"),
+            rep.segments[3].url);
+  EXPECT_NEAR(6, rep.segments[3].start, 1e-9);
+  // The last segment is cut at the end of the Period.
+  EXPECT_NEAR(7, rep.segments[3].end, 1e-9);
+}
+
+TEST(DashExpandsTimeTemplatesInMediaTime) {
+  const std::string mpd = Mpd(
+      "duration=\"PT4S\"",
+      "      <SegmentTemplate timescale=\"90000\" duration=\"180000\""
+      " presentationTimeOffset=\"900000\" media=\"t$Time$.m4s\"/>\n"
+      "      <Representation id=\"v1\" bandwidth=\"1000000\"/>\n");
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest(kMpdUrl, mpd, &manifest, &error));
+  const Representation& rep = manifest.representations[0];
+  ASSERT_TRUE(rep.segments.size() == 2);
+  // Presentation times start at zero; URLs carry the offset media times.
+  EXPECT_NEAR(0, rep.segments[0].start, 1e-9);
+  EXPECT_NEAR(2, rep.segments[1].start, 1e-9);
+  EXPECT_EQ(std::string("https://cdn.example/content/t900000.m4s"),
+            rep.segments[0].url);
+  EXPECT_EQ(std::string("https://cdn.example/content/t1080000.m4s"),
+            rep.segments[1].url);
+}
+
+TEST(DashRepeatsTimelineEntriesToThePeriodEnd) {
+  const std::string mpd = Mpd(
+      "duration=\"PT10S\"",
+      "      <SegmentTemplate timescale=\"1000\" media=\"$Time$.m4s\">\n"
+      "        <SegmentTimeline>\n"
+      "          <S t=\"0\" d=\"1000\"/>\n"
+      "          <S d=\"2000\" r=\"-1\"/>\n"
+      "        </SegmentTimeline>\n"
+      "      </SegmentTemplate>\n"
+      "      <Representation id=\"v1\" bandwidth=\"1000000\"/>\n");
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest(kMpdUrl, mpd, &manifest, &error));
+  const Representation& rep = manifest.representations[0];
+  // One 1 s segment, then 2 s segments until 10 s.
+  ASSERT_TRUE(rep.segments.size() == 6);
+  EXPECT_EQ(std::string("https://cdn.example/content/1000.m4s"),
+            rep.segments[1].url);
+  EXPECT_NEAR(9, rep.segments[5].start, 1e-9);
+  EXPECT_EQ(std::string("https://cdn.example/content/9000.m4s"),
+            rep.segments[5].url);
+}
+
+TEST(DashReadsSegmentBaseRanges) {
+  const std::string mpd = Mpd(
+      "duration=\"PT60S\"",
+      "      <Representation id=\"v1\" bandwidth=\"1000000\">\n"
+      "        <BaseURL>video/v1.mp4</BaseURL>\n"
+      "        <SegmentBase indexRange=\"812-1999\" timescale=\"1000\""
+      " presentationTimeOffset=\"500\">\n"
+      "          <Initialization range=\"0-811\"/>\n"
+      "        </SegmentBase>\n"
+      "      </Representation>\n");
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest(kMpdUrl, mpd, &manifest, &error));
+  const Representation& rep = manifest.representations[0];
+  const std::string url = "https://cdn.example/content/video/v1.mp4";
+  EXPECT_EQ(url, rep.init.url);
+  EXPECT_EQ(std::string("bytes=0-811"), rep.init.RangeHeader());
+  EXPECT_EQ(url, rep.index.url);
+  EXPECT_EQ(std::string("bytes=812-1999"), rep.index.RangeHeader());
+  EXPECT_NEAR(0.5, rep.index_time_offset, 1e-9);
+  // Segments come from the sidx box once it is read.
+  EXPECT_TRUE(rep.segments.empty());
+}
+
+TEST(HlsPairsStreamsWithTheirAudioGroup) {
+  const std::string master =
+      "#EXTM3U\n"
+      "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aud\",LANGUAGE=\"en\","
+      "URI=\"audio/en.m3u8\"\n"
+      "#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID=\"aud\",LANGUAGE=\"fr\","
+      "URI=\"audio/fr.m3u8\"\n"
+      "#EXT-X-MEDIA:TYPE=SUBTITLES,GROUP-ID=\"subs\",LANGUAGE=\"en\","
+      "URI=\"subs/en.m3u8\"\n"
+      "#EXT-X-STREAM-INF:BANDWIDTH=3000000,RESOLUTION=1280x720,"
+      "CODECS=\"avc1.64001f,mp4a.40.2\",AUDIO=\"aud\",SUBTITLES=\"subs\"\n"
+      "video/720.m3u8\n"
+      "#EXT-X-STREAM-INF:BANDWIDTH=1000000,RESOLUTION=640x360,"
+      "CODECS=\"avc1.42c01e,mp4a.40.2\",AUDIO=\"aud\",SUBTITLES=\"subs\"\n"
+      "video/360.m3u8\n";
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest("https://cdn.example/hls/master.m3u8", master,
+                            &manifest, &error));
+  EXPECT_TRUE(manifest.format == Manifest::Format::kHls);
+  // Two audio renditions, the subtitles and two video streams.
+  ASSERT_TRUE(manifest.representations.size() == 5);
+  const Representation& french = manifest.representations[1];
+  EXPECT_TRUE(french.type == StreamType::kAudio);
+  EXPECT_EQ(std::string("fr"), french.language);
+  EXPECT_EQ(std::string("mp4a.40.2"), french.codecs);
+  EXPECT_EQ(std::string("https://cdn.example/hls/audio/fr.m3u8"),
+            french.playlist_url);
+  EXPECT_TRUE(manifest.representations[2].type == StreamType::kText);
+
+  // Each stream pairs with each rendition, lowest bandwidth first.
+  ASSERT_TRUE(manifest.variants.size() == 4);
+  const Variant& lowest = manifest.variants[0];
+  const Representation& video = manifest.representations[lowest.video];
+  EXPECT_EQ(1000000u, lowest.bandwidth);
+  EXPECT_EQ(std::string("avc1.42c01e"), video.codecs);
+  EXPECT_EQ(640u, video.width);
+  EXPECT_EQ(std::string("https://cdn.example/hls/video/360.m3u8"),
+            video.playlist_url);
+  EXPECT_TRUE(manifest.variants[1].video == lowest.video);
+  EXPECT_TRUE(manifest.variants[1].audio != lowest.audio);
+  EXPECT_EQ(3000000u, manifest.variants[3].bandwidth);
+}
+
+TEST(HlsContinuesByteRangesWithoutAnOffset) {
+  const std::string playlist =
+      "#EXTM3U\n"
+      "#EXT-X-TARGETDURATION:4\n"
+      "#EXT-X-MAP:URI=\"main.mp4\",BYTERANGE=\"720@0\"\n"
+      "#EXTINF:4.0,\n"
+      "#EXT-X-BYTERANGE:1000@720\n"
+      "main.mp4\n"
+      "#EXTINF:4.0,\n"
+      "#EXT-X-BYTERANGE:2000\n"
+      "main.mp4\n"
+      "#EXTINF:2.5,\n"
+      "#EXT-X-BYTERANGE:500\n"
+      "main.mp4\n"
+      "#EXT-X-ENDLIST\n";
+  Manifest manifest;
+  std::string error;
+  ASSERT_TRUE(ParseManifest("https://cdn.example/hls/main.m3u8", playlist,
+                            &manifest, &error));
+  ASSERT_TRUE(manifest.representations.size() == 1);
+  const Representation& rep = manifest.representations[0];
+  EXPECT_EQ(std::string("bytes=0-719"), rep.init.RangeHeader());
+  ASSERT_TRUE(rep.segments.size() == 3);
+  EXPECT_EQ(std::string("bytes=720-1719"), rep.segments[0].RangeHeader());
+  // Without an offset a range starts where the previous one ended.
+  EXPECT_EQ(std::string("bytes=1720-3719"), rep.segments[1].RangeHeader());
+  EXPECT_EQ(std::string("bytes=3720-4219"), rep.segments[2].RangeHeader());
+  EXPECT_NEAR(8, rep.segments[2].start, 1e-9);
+  EXPECT_FALSE(manifest.live);
+  EXPECT_NEAR(10.5, manifest.duration, 1e-9);
+}
+
+TEST(ResolveUrlRemovesDotSegmentsAndKeepsQueries) {
+  const std::string base = "https://cdn.example/a/b/manifest.mpd?token=1";
+  EXPECT_EQ(std::string("https://cdn.example/a/c/seg.m4s"),
+            ResolveUrl(base, "../c/seg.m4s"));
+  EXPECT_EQ(std::string("https://cdn.example/a/b/c/seg.m4s"),
+            ResolveUrl(base, "./c/./seg.m4s"));
+  // ".." never climbs above the root.
+  EXPECT_EQ(std::string("https://cdn.example/seg.m4s"),
+            ResolveUrl(base, "../../../seg.m4s"));
+  // The reference's query replaces the base's.
+  EXPECT_EQ(std::string("https://cdn.example/a/b/seg.m4s?range=1#t=2"),
+            ResolveUrl(base, "seg.m4s?range=1#t=2"));
+  EXPECT_EQ(std::string("https://cdn.example/a/b/manifest.mpd?token=2"),
+            ResolveUrl(base, "?token=2"));
+  EXPECT_EQ(std::string("https://cdn.example/x/seg.m4s"),
+            ResolveUrl(base, "/x/../x/seg.m4s"));
+  EXPECT_EQ(std::string("https://other.example/seg.m4s"),
+            ResolveUrl(base, "//other.example/seg.m4s"));
+  EXPECT_EQ(std::string("http://other.example/seg.m4s"),
+            ResolveUrl(base, "http://other.example/seg.m4s"));
+  EXPECT_EQ(base, ResolveUrl(base, ""));
+}
+
+TEST(XmlRejectsMalformedDocuments) {
+  const char* const kMalformed[] = {
+      "",
+      "<MPD><Period></MPD>",
+      "<MPD><Period>",
+      "<MPD/><MPD/>",
+      "<MPD type=dynamic/>",
+      "<MPD type=\"static/>",
+      "</MPD>",
+      "<MPD><![CDATA[text</MPD>",
+  };
+  for (const char* document : kMalformed) {
+    std::string error;
+    EXPECT_TRUE(ParseXml(document, &error) == nullptr);
+    EXPECT_EQ(0u, error.find("XML: "));
+  }
+
+  // A malformed MPD fails the manifest with the parser's error.
+  Manifest manifest;
+  std::string error;
+  EXPECT_FALSE(ParseManifest(kMpdUrl, "<MPD><Period></MPD>", &manifest,
+                             &error));
+  EXPECT_EQ(std::string("XML: Mismatched closing tag </MPD>"), error);
+}
+
+TEST(XmlDecodesEntitiesAndSkipsMarkup) {
+  std::string error;
+  std::unique_ptr<XmlElement> root = ParseXml(
+      "<?xml version=\"1.0\"?><!-- comment -->"
+      "<a title='x &amp; &#x41;'><b>1 &lt; 2</b><![CDATA[<raw>]]></a>",
+      &error);
+  ASSERT_TRUE(root != nullptr);
+  EXPECT_EQ(std::string("x & A"), root->Attribute("title"));
+  ASSERT_TRUE(root->Child("b") != nullptr);
+  EXPECT_EQ(std::string("1 < 2"), root->Child("b")->text);
+  EXPECT_EQ(std::string("<raw>"), root->text);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,85 @@
+#include "net/network_conditions.h"
+
+#include <string>
+
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+/** Answers every request with a short body. */
+class OkHandler : public HttpHandler {
+ public:
+  void Handle(const HttpRequest&, HttpResponse* response) override {
+    response->SetBody("ok");
+  }
+};
+
+NetworkConditions FlakyConditions(uint64_t seed) {
+  NetworkConditions conditions;
+  conditions.latency_ms = 20;
+  conditions.jitter_ms = 100;
+  conditions.failure_rate = 0.5;
+  conditions.failure_filter = ".m4s";
+  conditions.seed = seed;
+  return conditions;
+}
+
+TEST(NetworkConditionsAreReproducibleFromTheSeed) {
+  OkHandler inner;
+  ConditionedHandler first(FlakyConditions(7), &inner);
+  ConditionedHandler again(FlakyConditions(7), &inner);
+  ConditionedHandler other(FlakyConditions(8), &inner);
+
+  bool differs = false;
+  int failures = 0;
+  for (const char* path : {"/v/seg-1.m4s", "/v/seg-2.m4s", "/a/seg-1.m4s"}) {
+    for (uint64_t occurrence = 0; occurrence < 20; occurrence++) {
+      const double delay = first.DelayMs(path, occurrence);
+      EXPECT_EQ(delay, again.DelayMs(path, occurrence));
+      EXPECT_EQ(first.Fails(path, occurrence), again.Fails(path, occurrence));
+      EXPECT_TRUE(delay >= 20 && delay < 120);
+      differs |= delay != other.DelayMs(path, occurrence) ||
+                 first.Fails(path, occurrence) != other.Fails(path, occurrence);
+      failures += first.Fails(path, occurrence);
+    }
+  }
+  EXPECT_TRUE(differs);
+  EXPECT_TRUE(failures > 10 && failures < 50);
+  // Paths the filter excludes never fail.
+  for (uint64_t occurrence = 0; occurrence < 20; occurrence++)
+    EXPECT_FALSE(first.Fails("/manifest.mpd", occurrence));
+}
+
+TEST(ConditionedHandlerFailsTheDrawnOccurrences) {
+  OkHandler inner;
+  NetworkConditions conditions = FlakyConditions(3);
+  conditions.latency_ms = 0;
+  conditions.jitter_ms = 0;
+  ConditionedHandler handler(conditions, &inner);
+
+  // Interleaving other paths does not change a path's decisions.
+  HttpRequest request;
+  HttpRequest other;
+  other.path = "/v/other.m4s";
+  request.path = "/v/seg-1.m4s";
+  uint64_t failures = 0;
+  for (uint64_t occurrence = 0; occurrence < 10; occurrence++) {
+    HttpResponse ignored;
+    handler.Handle(other, &ignored);
+    failures += ignored.status != 200;
+    HttpResponse response;
+    handler.Handle(request, &response);
+    const bool failed = handler.Fails(request.path, occurrence);
+    failures += failed;
+    EXPECT_EQ(failed ? conditions.failure_status : 200, response.status);
+  }
+  const NetworkStats stats = handler.stats();
+  EXPECT_EQ(20u, stats.requests);
+  EXPECT_EQ(failures, stats.failures);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,254 @@
+#include "media/sample_arena.h"
+
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "media/buffer_policy.h"
+#include "media/manifest.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+constexpr uint64_t kSlabBytes = 16 * 1024;
+
+size_t TypeIndex(StreamType type) {
+  return static_cast<size_t>(type);
+}
+
+TEST(SampleArenaReusesFreedBlocks) {
+  SampleArena arena(1024 * 1024);
+  uint8_t* first;
+  {
+    SampleBuffer buffer = arena.Allocate(1000, StreamType::kVideo);
+    ASSERT_TRUE(buffer.data() != nullptr);
+    EXPECT_EQ(1000u, buffer.size());
+    std::memset(buffer.data(), 0xab, buffer.size());
+    first = buffer.data();
+  }
+  SampleBuffer again = arena.Allocate(1000, StreamType::kVideo);
+  EXPECT_TRUE(again.data() == first);
+
+  const SampleArenaStats stats = arena.stats();
+  EXPECT_EQ(2u, stats.allocations);
+  EXPECT_EQ(1u, stats.heap_allocations);
+  EXPECT_EQ(kSlabBytes, stats.bytes_reserved);
+  EXPECT_EQ(0u, stats.over_budget);
+}
+
+TEST(SampleArenaCountsBytesInUseByType) {
+  SampleArena arena(1024 * 1024);
+  {
+    SampleBuffer video = arena.Allocate(3000, StreamType::kVideo);
+    SampleBuffer audio = arena.Allocate(500, StreamType::kAudio);
+    const SampleArenaStats stats = arena.stats();
+    EXPECT_EQ(3500u, stats.bytes_in_use);
+    EXPECT_EQ(3000u, stats.bytes_in_use_by_type[TypeIndex(StreamType::kVideo)]);
+    EXPECT_EQ(500u, stats.bytes_in_use_by_type[TypeIndex(StreamType::kAudio)]);
+  }
+  EXPECT_TRUE(arena.Allocate(0, StreamType::kText).data() == nullptr);
+
+  const SampleArenaStats stats = arena.stats();
+  EXPECT_EQ(0u, stats.bytes_in_use);
+  EXPECT_EQ(3500u, stats.peak_bytes_in_use);
+  EXPECT_EQ(3000u,
+            stats.peak_bytes_in_use_by_type[TypeIndex(StreamType::kVideo)]);
+  EXPECT_EQ(2u, stats.allocations);
+}
+
+TEST(SampleArenaMovesBuffers) {
+  SampleArena arena(1024 * 1024);
+  SampleBuffer buffer = arena.Allocate(100, StreamType::kAudio);
+  uint8_t* data = buffer.data();
+  SampleBuffer moved(std::move(buffer));
+  EXPECT_TRUE(moved.data() == data);
+  EXPECT_TRUE(buffer.data() == nullptr);
+  SampleBuffer assigned;
+  assigned = std::move(moved);
+  EXPECT_TRUE(assigned.data() == data);
+  EXPECT_EQ(100u, arena.stats().bytes_in_use);
+}
+
+TEST(SampleArenaGivesLargeSamplesTheirOwnAllocation) {
+  SampleArena arena(1024 * 1024);
+  {
+    SampleBuffer large = arena.Allocate(300 * 1024, StreamType::kVideo);
+    ASSERT_TRUE(large.data() != nullptr);
+    EXPECT_EQ(300u * 1024, arena.stats().bytes_reserved);
+  }
+  const SampleArenaStats stats = arena.stats();
+  EXPECT_EQ(1u, stats.large_allocations);
+  EXPECT_EQ(0u, stats.bytes_reserved);
+  EXPECT_EQ(300u * 1024, stats.peak_bytes_reserved);
+}
+
+TEST(SampleArenaServesSamplesOverBudgetFromTheHeap) {
+  SampleArena arena(kSlabBytes);
+  SampleBuffer first = arena.Allocate(300, StreamType::kVideo);
+  // A second class needs a second slab, which the budget has no room for.
+  SampleBuffer second = arena.Allocate(5000, StreamType::kVideo);
+  ASSERT_TRUE(second.data() != nullptr);
+  std::memset(second.data(), 0, second.size());
+
+  const SampleArenaStats stats = arena.stats();
+  EXPECT_EQ(1u, stats.over_budget);
+  EXPECT_EQ(kSlabBytes, stats.bytes_reserved);
+  EXPECT_EQ(5300u, stats.bytes_in_use);
+}
+
+TEST(SampleArenaReleasesEmptySlabsForOtherClasses) {
+  SampleArena arena(kSlabBytes);
+  // The empty slab is kept for reuse until another class needs the budget.
+  arena.Allocate(300, StreamType::kVideo);
+  EXPECT_EQ(kSlabBytes, arena.stats().bytes_reserved);
+  SampleBuffer other = arena.Allocate(5000, StreamType::kVideo);
+
+  const SampleArenaStats stats = arena.stats();
+  EXPECT_EQ(0u, stats.over_budget);
+  EXPECT_EQ(kSlabBytes, stats.bytes_reserved);
+  EXPECT_EQ(kSlabBytes, stats.peak_bytes_reserved);
+}
+
+Manifest ManifestWithBandwidths(uint64_t variant, uint64_t text,
+                                double segment_seconds) {
+  Manifest manifest;
+  Representation video;
+  video.type = StreamType::kVideo;
+  SegmentReference segment;
+  segment.end = segment_seconds;
+  video.segments.push_back(segment);
+  manifest.representations.push_back(video);
+  Representation subtitles;
+  subtitles.type = StreamType::kText;
+  subtitles.bandwidth = text;
+  manifest.representations.push_back(subtitles);
+
+  Variant low;
+  low.video = 0;
+  low.bandwidth = variant / 4;
+  Variant high;
+  high.video = 0;
+  high.bandwidth = variant;
+  manifest.variants = {low, high};
+  return manifest;
+}
+
+TEST(SampleArenaPlansForRoundingAndPartlyUsedSlabs) {
+  EXPECT_EQ(0u, SampleArena::PlannedCapacity(0));
+  EXPECT_EQ(0u, SampleArena::PlannedCapacity(kSlabBytes));
+  const uint64_t budget = 16 * 1024 * 1024;
+  const uint64_t capacity = SampleArena::PlannedCapacity(budget);
+  EXPECT_TRUE(capacity > budget / 2);
+  EXPECT_TRUE(capacity <= budget * 4 / 5);
+}
+
+TEST(BufferPolicyFitsTheBudgetAtTheHighestVariant) {
+  // 8 Mbit/s with 4 s segments: the arena's planned capacity at 80%, less
+  // one segment.
+  const Manifest manifest = ManifestWithBandwidths(7900000, 100000, 4);
+  BufferPolicy policy;
+  std::string error;
+  ASSERT_TRUE(ChooseBufferPolicy(manifest, 20000000, &policy, &error));
+  const double seconds =
+      SampleArena::PlannedCapacity(20000000) * 8 * 0.8 / 8000000 - 4;
+  EXPECT_NEAR(8000000, policy.peak_bandwidth, 1e-6);
+  EXPECT_NEAR(seconds * 0.2, policy.buffer_behind, 1e-9);
+  EXPECT_NEAR(seconds * 0.8, policy.buffering_goal, 1e-9);
+  EXPECT_NEAR(2, policy.rebuffering_goal, 1e-9);
+  const double buffered_bytes =
+      (policy.buffering_goal + policy.buffer_behind + 4) *
+      policy.peak_bandwidth / 8;
+  EXPECT_TRUE(buffered_bytes <= policy.byte_budget);
+}
+
+TEST(BufferPolicyKeepsDefaultsWithALargeBudget) {
+  const Manifest manifest = ManifestWithBandwidths(1000000, 0, 4);
+  BufferPolicy policy;
+  std::string error;
+  ASSERT_TRUE(ChooseBufferPolicy(manifest, 1000000000, &policy, &error));
+  EXPECT_NEAR(30, policy.buffer_behind, 1e-9);
+  EXPECT_NEAR(2, policy.rebuffering_goal, 1e-9);
+}
+
+/**
+ * Buffers |seconds| of 30 fps video and AAC audio averaging |bandwidth| in
+ * an arena of |budget| bytes at the lengths ChooseBufferPolicy picks, and
+ * returns the arena's counters.
+ */
+SampleArenaStats PlayBufferedWindow(uint64_t bandwidth, uint64_t budget,
+                                    double seconds) {
+  constexpr double kSegmentSeconds = 2;
+  constexpr double kFrameRate = 30;
+  constexpr int kFramesPerKeyframe = 60;
+  constexpr uint64_t kAudioBandwidth = 128000;
+  constexpr double kAudioSampleSeconds = 1024 / 48000.0;
+
+  BufferPolicy policy;
+  std::string error;
+  if (!ChooseBufferPolicy(
+          ManifestWithBandwidths(bandwidth, 0, kSegmentSeconds), budget,
+          &policy, &error)) {
+    return SampleArenaStats();
+  }
+  const double window =
+      policy.buffering_goal + policy.buffer_behind + kSegmentSeconds;
+
+  // Keyframes are eight times the other frames, which vary from a quarter
+  // to one and three quarters of their mean.
+  const double frame_bytes = (bandwidth - kAudioBandwidth) / 8 / kFrameRate *
+                             kFramesPerKeyframe / (kFramesPerKeyframe + 7);
+  const size_t audio_bytes =
+      static_cast<size_t>(kAudioBandwidth / 8 * kAudioSampleSeconds);
+  std::mt19937 random(1);
+  SampleArena arena(budget);
+  std::deque<std::pair<double, SampleBuffer>> buffered;
+  double audio_time = 0;
+  for (int frame = 0; frame < seconds * kFrameRate; frame++) {
+    const double time = frame / kFrameRate;
+    double size = frame_bytes * (0.25 + (random() % 1501) / 1000.0);
+    if (frame % kFramesPerKeyframe == 0)
+      size = frame_bytes * 8;
+    buffered.emplace_back(
+        time, arena.Allocate(static_cast<size_t>(size), StreamType::kVideo));
+    for (; audio_time <= time; audio_time += kAudioSampleSeconds) {
+      buffered.emplace_back(audio_time,
+                            arena.Allocate(audio_bytes, StreamType::kAudio));
+    }
+    while (buffered.front().first < time - window)
+      buffered.pop_front();
+  }
+  return arena.stats();
+}
+
+TEST(BufferPolicyKeepsTheArenaWithinBudget) {
+  for (uint64_t mib : {4, 8, 16}) {
+    const uint64_t budget = mib * 1024 * 1024;
+    const SampleArenaStats stats = PlayBufferedWindow(5000000, budget, 120);
+    EXPECT_TRUE(stats.allocations > 0);
+    EXPECT_EQ(0u, stats.over_budget);
+    EXPECT_TRUE(stats.peak_bytes_reserved <= budget);
+    // Most samples are served from slabs.
+    EXPECT_TRUE(stats.heap_allocations * 10 < stats.allocations);
+  }
+}
+
+TEST(BufferPolicyRejectsBudgetsTooSmallToPlay) {
+  const Manifest manifest = ManifestWithBandwidths(8000000, 0, 4);
+  BufferPolicy policy;
+  std::string error;
+  EXPECT_FALSE(ChooseBufferPolicy(manifest, 4000000, &policy, &error));
+  EXPECT_FALSE(error.empty());
+
+  error.clear();
+  EXPECT_FALSE(ChooseBufferPolicy(Manifest(), 4000000, &policy, &error));
+  EXPECT_FALSE(error.empty());
+}
+
+}  // namespace
+
+}  // namespace sample
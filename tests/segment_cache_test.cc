@@ -0,0 +1,95 @@
+#include "net/segment_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+std::shared_ptr<const CachedResponse> ResponseOfSize(size_t size) {
+  std::shared_ptr<CachedResponse> response(new CachedResponse);
+  response->body = std::make_shared<const std::string>(size, 'x');
+  return response;
+}
+
+TEST(SegmentCacheEvictsLeastRecentlyUsedBytes) {
+  SegmentCache cache(100);
+  cache.Insert("a", ResponseOfSize(40), CacheInsertKind::kRequested);
+  cache.Insert("b", ResponseOfSize(40), CacheInsertKind::kRequested);
+  // Using "a" leaves "b" as the least recently used entry.
+  EXPECT_TRUE(cache.Lookup("a") != nullptr);
+  cache.Insert("c", ResponseOfSize(40), CacheInsertKind::kRequested);
+
+  EXPECT_TRUE(cache.Contains("a"));
+  EXPECT_FALSE(cache.Contains("b"));
+  EXPECT_TRUE(cache.Contains("c"));
+  const SegmentCacheStats stats = cache.stats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(80u, stats.bytes_cached);
+}
+
+TEST(SegmentCacheEvictsUntilALargeEntryFits) {
+  SegmentCache cache(100);
+  cache.Insert("a", ResponseOfSize(30), CacheInsertKind::kRequested);
+  cache.Insert("b", ResponseOfSize(30), CacheInsertKind::kRequested);
+  cache.Insert("c", ResponseOfSize(30), CacheInsertKind::kRequested);
+  cache.Insert("d", ResponseOfSize(90), CacheInsertKind::kRequested);
+
+  EXPECT_FALSE(cache.Contains("a"));
+  EXPECT_FALSE(cache.Contains("b"));
+  EXPECT_FALSE(cache.Contains("c"));
+  EXPECT_TRUE(cache.Contains("d"));
+  EXPECT_EQ(3u, cache.stats().evictions);
+  EXPECT_EQ(90u, cache.stats().bytes_cached);
+}
+
+TEST(SegmentCacheSkipsEntriesOverBudget) {
+  SegmentCache cache(100);
+  cache.Insert("a", ResponseOfSize(50), CacheInsertKind::kRequested);
+  cache.Insert("big", ResponseOfSize(101), CacheInsertKind::kRequested);
+
+  EXPECT_TRUE(cache.Contains("a"));
+  EXPECT_FALSE(cache.Contains("big"));
+  EXPECT_EQ(0u, cache.stats().evictions);
+}
+
+TEST(SegmentCacheReplacesAnEntry) {
+  SegmentCache cache(100);
+  cache.Insert("a", ResponseOfSize(60), CacheInsertKind::kRequested);
+  cache.Insert("a", ResponseOfSize(70), CacheInsertKind::kRequested);
+
+  EXPECT_EQ(70u, cache.stats().bytes_cached);
+  EXPECT_EQ(0u, cache.stats().evictions);
+}
+
+TEST(SegmentCacheCountsHitsAndAheadOfTimeInserts) {
+  SegmentCache cache(1000);
+  cache.Insert("prefetch", ResponseOfSize(10), CacheInsertKind::kPrefetched);
+  cache.Insert("preload", ResponseOfSize(10), CacheInsertKind::kPreloaded);
+  EXPECT_TRUE(cache.Lookup("missing") == nullptr);
+  EXPECT_TRUE(cache.Lookup("prefetch") != nullptr);
+  EXPECT_TRUE(cache.Lookup("prefetch") != nullptr);
+  // Peek() neither counts nor marks the preload used.
+  EXPECT_TRUE(cache.Peek("preload") != nullptr);
+
+  SegmentCacheStats stats = cache.stats();
+  EXPECT_EQ(2u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(20u, stats.bytes_saved);
+  EXPECT_EQ(1u, stats.prefetched);
+  EXPECT_EQ(1u, stats.prefetch_hits);
+  EXPECT_EQ(1u, stats.preloaded);
+  EXPECT_EQ(0u, stats.preload_hits);
+
+  EXPECT_TRUE(cache.Lookup("preload") != nullptr);
+  stats = cache.stats();
+  EXPECT_EQ(1u, stats.preload_hits);
+  EXPECT_EQ(1u, stats.prefetch_hits);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,225 @@
+#include "net/session_trace.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/clock.h"
+#include "canned_server.h"
+#include "net/trace_recorder.h"
+#include "net/trace_replayer.h"
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+/** Written to the working directory and removed again. */
+constexpr char kTracePath[] = "session_trace_test.trace";
+
+TraceResponse MakeResponse(const std::string& target,
+                           std::shared_ptr<const std::string> body) {
+  TraceResponse response;
+  response.target = target;
+  response.body = std::move(body);
+  return response;
+}
+
+size_t FileSize(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>())
+      .size();
+}
+
+SessionTrace MakeTrace() {
+  SessionTrace trace;
+  trace.manifest_target = "/manifest.mpd";
+  trace.playback_rate = 1.5;
+  trace.bandwidth_estimate = 2.5e6;
+  trace.duration_us = 30000000;
+
+  auto segment = std::make_shared<const std::string>(10000, 's');
+  TraceResponse manifest =
+      MakeResponse("/manifest.mpd", std::make_shared<const std::string>("m"));
+  manifest.latency_us = 1234;
+  manifest.content_type = "application/dash+xml";
+  trace.responses.push_back(manifest);
+  TraceResponse first = MakeResponse("/seg-1.m4s", segment);
+  first.request_us = 5000;
+  first.range = "bytes=0-9999";
+  first.status = 206;
+  first.headers["content-range"] = "bytes 0-9999/20000";
+  trace.responses.push_back(first);
+  // An equal body in a different string is still stored once.
+  trace.responses.push_back(MakeResponse(
+      "/seg-1.m4s?again", std::make_shared<const std::string>(*segment)));
+  trace.responses.push_back(MakeResponse("/missing", nullptr));
+
+  TraceEvent seek;
+  seek.time_us = 7000000;
+  seek.type = TraceEvent::Type::kSeek;
+  seek.value = 42.25;
+  trace.events.push_back(seek);
+  TraceEvent variant;
+  variant.time_us = 8000000;
+  variant.type = TraceEvent::Type::kVariant;
+  variant.value = 3;
+  trace.events.push_back(variant);
+  return trace;
+}
+
+TEST(SessionTraceRoundTrips) {
+  const SessionTrace trace = MakeTrace();
+  std::string error;
+  ASSERT_TRUE(WriteTrace(trace, kTracePath, &error));
+  // Both copies of the segment body would take 20000 bytes on their own.
+  EXPECT_TRUE(FileSize(kTracePath) < 11000);
+
+  SessionTrace read;
+  ASSERT_TRUE(ReadTrace(kTracePath, &read, &error));
+  std::remove(kTracePath);
+  EXPECT_EQ(trace.manifest_target, read.manifest_target);
+  EXPECT_EQ(trace.playback_rate, read.playback_rate);
+  EXPECT_EQ(trace.bandwidth_estimate, read.bandwidth_estimate);
+  EXPECT_EQ(trace.duration_us, read.duration_us);
+
+  ASSERT_TRUE(read.responses.size() == trace.responses.size());
+  for (size_t i = 0; i < trace.responses.size(); i++) {
+    const TraceResponse& expected = trace.responses[i];
+    const TraceResponse& actual = read.responses[i];
+    EXPECT_EQ(expected.request_us, actual.request_us);
+    EXPECT_EQ(expected.latency_us, actual.latency_us);
+    EXPECT_EQ(expected.target, actual.target);
+    EXPECT_EQ(expected.range, actual.range);
+    EXPECT_EQ(expected.status, actual.status);
+    EXPECT_EQ(expected.content_type, actual.content_type);
+    EXPECT_TRUE(expected.headers == actual.headers);
+    EXPECT_EQ(!expected.body, !actual.body);
+    if (expected.body && actual.body)
+      EXPECT_TRUE(*expected.body == *actual.body);
+  }
+  // Deduplicated bodies are shared again when read.
+  EXPECT_TRUE(read.responses[1].body == read.responses[2].body);
+
+  ASSERT_TRUE(read.events.size() == 2);
+  EXPECT_EQ(7000000u, read.events[0].time_us);
+  EXPECT_TRUE(read.events[0].type == TraceEvent::Type::kSeek);
+  EXPECT_EQ(42.25, read.events[0].value);
+  EXPECT_TRUE(read.events[1].type == TraceEvent::Type::kVariant);
+}
+
+TEST(SessionTraceRejectsTruncatedFiles) {
+  std::string error;
+  ASSERT_TRUE(WriteTrace(MakeTrace(), kTracePath, &error));
+  std::string data;
+  {
+    std::ifstream file(kTracePath, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(kTracePath, std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size() - 3));
+  }
+  SessionTrace read;
+  EXPECT_FALSE(ReadTrace(kTracePath, &read, &error));
+  std::remove(kTracePath);
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(ReadTrace(kTracePath, &read, &error));
+}
+
+HttpResponse Replay(TraceReplayer* replayer, const std::string& path,
+                    const std::string& range = "") {
+  HttpRequest request;
+  request.method = "GET";
+  request.path = path;
+  if (!range.empty())
+    request.headers["range"] = range;
+  HttpResponse response;
+  replayer->Handle(request, &response);
+  return response;
+}
+
+TEST(TraceReplayerAnswersInRecordedOrder) {
+  SessionTrace trace;
+  trace.responses.push_back(
+      MakeResponse("/live.mpd", std::make_shared<const std::string>("v1")));
+  trace.responses.push_back(
+      MakeResponse("/live.mpd", std::make_shared<const std::string>("v2")));
+  TraceReplayer replayer(&trace, 1);
+
+  EXPECT_EQ(std::string("v1"), *Replay(&replayer, "/live.mpd").body);
+  EXPECT_EQ(std::string("v2"), *Replay(&replayer, "/live.mpd").body);
+  EXPECT_EQ(std::string("v2"), *Replay(&replayer, "/live.mpd").body);
+  EXPECT_EQ(404, Replay(&replayer, "/live.mpd", "bytes=0-1").status);
+
+  TraceReplayStats stats = replayer.stats();
+  EXPECT_EQ(4u, stats.requests);
+  EXPECT_EQ(1u, stats.repeats);
+  EXPECT_EQ(1u, stats.misses);
+
+  // A new session starts from the first recorded response again.
+  replayer.Start();
+  EXPECT_EQ(std::string("v1"), *Replay(&replayer, "/live.mpd").body);
+}
+
+TEST(TraceReplayerWaitsForTheRecordedRequestTime) {
+  SessionTrace trace;
+  TraceResponse response =
+      MakeResponse("/seg.m4s", std::make_shared<const std::string>("s"));
+  response.request_us = 200000;
+  response.latency_us = 40000;
+  trace.responses.push_back(response);
+  TraceReplayer replayer(&trace, 4);
+
+  replayer.Start();
+  const Clock::time_point start = Clock::now();
+  Replay(&replayer, "/seg.m4s");
+  // (200 ms + 40 ms) / 4.
+  EXPECT_TRUE(MillisecondsSince(start) >= 59);
+}
+
+TEST(TraceRecorderRoundTripsChunkedResponses) {
+  test::CannedServer origin(
+      "HTTP/1.1 206 Partial Content\r\n"
+      "Content-Type: video/mp4\r\n"
+      "Content-Range: bytes 0-7/100\r\n"
+      "Transfer-Encoding: chunked\r\n"
+      "\r\n"
+      "3\r\nmoo\r\n5\r\nfmdat\r\n0\r\n\r\n");
+  TraceRecorder recorder(origin.BaseUrl());
+  recorder.Start();
+  HttpRequest request;
+  request.method = "GET";
+  request.path = "/v/seg-1.m4s";
+  request.headers["range"] = "bytes=0-7";
+  HttpResponse recorded;
+  recorder.Handle(request, &recorded);
+  ASSERT_TRUE(recorded.body != nullptr);
+  EXPECT_EQ(std::string("moofmdat"), *recorded.body);
+
+  std::string error;
+  ASSERT_TRUE(WriteTrace(recorder.Finish(), kTracePath, &error));
+  SessionTrace trace;
+  ASSERT_TRUE(ReadTrace(kTracePath, &trace, &error));
+  std::remove(kTracePath);
+
+  TraceReplayer replayer(&trace, 1000);
+  replayer.Start();
+  const HttpResponse replayed =
+      Replay(&replayer, "/v/seg-1.m4s", "bytes=0-7");
+  EXPECT_EQ(206, replayed.status);
+  EXPECT_EQ(std::string("video/mp4"), replayed.content_type);
+  EXPECT_EQ(std::string("bytes 0-7/100"),
+            replayed.headers.at("Content-Range"));
+  ASSERT_TRUE(replayed.body != nullptr);
+  EXPECT_EQ(std::string("moofmdat"), *replayed.body);
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,85 @@
+#include "net/static_file_handler.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "test.h"
+
+namespace sample {
+
+namespace {
+
+/** A directory holding "/seg.m4s" with ten bytes, removed on destruction. */
+class TempRoot {
+ public:
+  TempRoot() {
+    char pattern[] = "/tmp/sample_static_XXXXXX";
+    if (mkdtemp(pattern))
+      dir_ = pattern;
+    std::ofstream(dir_ + "/seg.m4s", std::ios::binary) << "0123456789";
+  }
+  ~TempRoot() {
+    std::remove((dir_ + "/seg.m4s").c_str());
+    rmdir(dir_.c_str());
+  }
+
+  const std::string& dir() const {
+    return dir_;
+  }
+
+ private:
+  std::string dir_;
+};
+
+HttpResponse Get(const std::string& root, const std::string& range) {
+  StaticFileHandler handler(root);
+  HttpRequest request;
+  request.method = "GET";
+  request.path = "/seg.m4s";
+  if (!range.empty())
+    request.headers["range"] = range;
+  HttpResponse response;
+  handler.Handle(request, &response);
+  return response;
+}
+
+TEST(StaticFileHandlerServesByteRanges) {
+  TempRoot root;
+  HttpResponse response = Get(root.dir(), "bytes=2-4");
+  EXPECT_EQ(206, response.status);
+  EXPECT_EQ(std::string("bytes 2-4/10"), response.headers["Content-Range"]);
+  ASSERT_TRUE(response.body != nullptr);
+  EXPECT_EQ(std::string("234"), *response.body);
+
+  response = Get(root.dir(), "bytes=-3");
+  EXPECT_EQ(206, response.status);
+  EXPECT_EQ(std::string("789"), *response.body);
+
+  response = Get(root.dir(), "bytes=8-");
+  EXPECT_EQ(206, response.status);
+  EXPECT_EQ(std::string("89"), *response.body);
+
+  response = Get(root.dir(), "");
+  EXPECT_EQ(200, response.status);
+  EXPECT_EQ(std::string("0123456789"), *response.body);
+}
+
+TEST(StaticFileHandlerRejectsUnsatisfiableRanges) {
+  TempRoot root;
+  for (const char* range :
+       {"bytes=abc-", "bytes=-0", "bytes=5-2", "bytes=10-", "bytes=1-x",
+        "bytes=0-1,3-4", "items=0-1"}) {
+    const HttpResponse response = Get(root.dir(), range);
+    EXPECT_EQ(416, response.status);
+    EXPECT_EQ(std::string("bytes */10"), response.headers.at("Content-Range"));
+    EXPECT_TRUE(response.body == nullptr || response.body->empty());
+  }
+}
+
+}  // namespace
+
+}  // namespace sample
@@ -0,0 +1,79 @@
+#ifndef SAMPLE_TESTS_TEST_H_
+#define SAMPLE_TESTS_TEST_H_
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+namespace sample {
+namespace test {
+
+/** Adds |function| to the tests RunAll() runs; see TEST(). */
+bool Register(const char* name, void (*function)());
+
+/** Records a failed check in the running test. */
+void Fail(const char* file, int line, const std::string& message);
+
+/** Runs every registered test and returns the number that failed. */
+int RunAll();
+
+template <typename A, typename B>
+std::string Describe(const char* expected, const char* actual, const A& a,
+                     const B& b) {
+  std::ostringstream out;
+  out << expected << " == " << actual << " (" << a << " vs " << b << ")";
+  return out.str();
+}
+
+}  // namespace test
+}  // namespace sample
+
+/** Defines and registers a test function. */
+#define TEST(name)                          \
+  static void name();                       \
+  static const bool name##_registered =     \
+      sample::test::Register(#name, name);  \
+  static void name()
+
+#define EXPECT_TRUE(condition)                                   \
+  do {                                                           \
+    if (!(condition))                                            \
+      sample::test::Fail(__FILE__, __LINE__, #condition);        \
+  } while (false)
+
+#define EXPECT_FALSE(condition) EXPECT_TRUE(!(condition))
+
+#define EXPECT_EQ(expected, actual)                                     \
+  do {                                                                  \
+    const auto& expected_value = (expected);                            \
+    const auto& actual_value = (actual);                                \
+    if (!(expected_value == actual_value)) {                            \
+      sample::test::Fail(__FILE__, __LINE__,                            \
+                         sample::test::Describe(#expected, #actual,     \
+                                                expected_value,         \
+                                                actual_value));         \
+    }                                                                   \
+  } while (false)
+
+#define EXPECT_NEAR(expected, actual, tolerance)                        \
+  do {                                                                  \
+    const double expected_value = (expected);                           \
+    const double actual_value = (actual);                               \
+    if (!(std::abs(expected_value - actual_value) <= (tolerance))) {    \
+      sample::test::Fail(__FILE__, __LINE__,                            \
+                         sample::test::Describe(#expected, #actual,     \
+                                                expected_value,         \
+                                                actual_value));         \
+    }                                                                   \
+  } while (false)
+
+/** Stops the test if |condition| is false, e.g. before indexing a result. */
+#define ASSERT_TRUE(condition)                                   \
+  do {                                                           \
+    if (!(condition)) {                                          \
+      sample::test::Fail(__FILE__, __LINE__, #condition);        \
+      return;                                                    \
+    }                                                            \
+  } while (false)
+
+#endif  // SAMPLE_TESTS_TEST_H_
@@ -0,0 +1,55 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test.h"
+
+namespace sample {
+namespace test {
+
+namespace {
+
+struct TestCase {
+  const char* name;
+  void (*function)();
+};
+
+std::vector<TestCase>& Tests() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+bool current_failed = false;
+
+}  // namespace
+
+bool Register(const char* name, void (*function)()) {
+  Tests().push_back({name, function});
+  return true;
+}
+
+void Fail(const char* file, int line, const std::string& message) {
+  std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line,
+               message.c_str());
+  current_failed = true;
+}
+
+int RunAll() {
+  int failures = 0;
+  for (const TestCase& test : Tests()) {
+    current_failed = false;
+    test.function();
+    std::printf("[%s] %s\n", current_failed ? "FAIL" : " OK ", test.name);
+    if (current_failed)
+      failures++;
+  }
+  std::printf("%zu tests, %d failed\n", Tests().size(), failures);
+  return failures;
+}
+
+}  // namespace test
+}  // namespace sample
+
+int main() {
+  return sample::test::RunAll() == 0 ? 0 : 1;
+}